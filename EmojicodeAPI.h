@@ -17,6 +17,7 @@
 #define EmojicodeAPI_h
 
 #include "EmojicodeShared.h"
+#include "EmojicodeSomething.h"
 #include <pthread.h>
 
 typedef struct Class Class;
@@ -27,14 +28,20 @@ typedef struct Thread Thread;
 typedef struct StackFrame StackFrame;
 typedef struct StackState StackState;
 
-extern Class *CL_STRING;
-extern Class *CL_LIST;
-extern Class *CL_ERROR;
-extern Class *CL_DATA;
-extern Class *CL_DICTIONARY;
-extern Class *CL_CAPTURED_FUNCTION_CALL;
-extern Class *CL_CLOSURE;
-extern Class *CL_RANGE;
+/**
+ * The class table of the program executed by the calling thread. The built-in classes are located at fixed indices
+ * and should be accessed with the macros below.
+ */
+extern _Thread_local Class **classTable;
+
+#define CL_STRING (classTable[0])
+#define CL_LIST (classTable[1])
+#define CL_ERROR (classTable[2])
+#define CL_DATA (classTable[3])
+#define CL_DICTIONARY (classTable[4])
+#define CL_CAPTURED_FUNCTION_CALL (classTable[5])
+#define CL_CLOSURE (classTable[6])
+#define CL_RANGE (classTable[7])
 extern Class *CL_ARRAY;
 
 typedef struct Object {
@@ -52,47 +59,6 @@ typedef struct Object {
     void *value;
 } Object;
 
-#define T_OBJECT 0
-#define T_INTEGER 1
-#define T_BOOLEAN 2
-#define T_SYMBOL 3
-#define T_DOUBLE 4
-#define T_CLASS 5
-
-typedef uint_fast8_t Type;
-typedef unsigned char Byte;
-
-/** Either an object reference or a primitive value. */
-typedef struct {
-    /** The type of the primitive or whether it contains an object reference. */
-    Type type;
-    union {
-        EmojicodeInteger raw;
-        double doubl;
-        Object *object;
-        Class *eclass;
-    };
-} Something;
-
-#if __SIZEOF_DOUBLE__ != 8
-#warning Double does not match the size of an 64-bit integer
-#endif
-
-#define somethingObject(o) ((Something){T_OBJECT, .object = (o)})
-#define somethingInteger(o) ((Something){T_INTEGER, (o)})
-#define somethingSymbol(o) ((Something){T_SYMBOL, (o)})
-#define somethingBoolean(o) ((Something){T_BOOLEAN, (o)})
-#define somethingDouble(o) ((Something){T_DOUBLE, .doubl = (o)})
-#define somethingClass(o) ((Something){T_CLASS, .eclass = (o)})
-#define EMOJICODE_TRUE ((Something){T_BOOLEAN, 1})
-#define EMOJICODE_FALSE ((Something){T_BOOLEAN, 0})
-#define NOTHINGNESS ((Something){T_OBJECT, .object = NULL})
-
-#define unwrapInteger(o) ((o).raw)
-#define unwrapBool(o) ((o).raw > 0)
-#define unwrapSymbol(o) ((EmojicodeChar)(o).raw)
-#define unwrapDouble(o) ((o).doubl)
-
 /** Whether this thing is Nothingness. */
 extern bool isNothingness(Something sth);
 
@@ -104,8 +70,22 @@ extern bool isRealObject(Something sth);
 typedef struct String {
     /** The number of code points in @c characters. Strings are not null terminated! */
     EmojicodeInteger length;
-    /** The characters of this string. Strings are not null terminated! */
+    /**
+     * The characters of this string, each stored in @c width bytes. Strings are not null terminated! Use
+     * @c stringCharacter to access a character. Several strings can share the same characters object.
+     */
     Object *characters;
+    /** The byte offset of the first character of this string in @c characters. See @c stringBytes. */
+    EmojicodeInteger offset;
+    /** The hash of the characters or 0 if it was not computed yet. Use @c stringHash to access it. */
+    uint64_t hash;
+    /**
+     * The number of bytes per code point: 1 (Latin-1), 2 (UCS-2) or 4 (UTF-32). Always the smallest width that can
+     * store all characters, so that equal strings have equal bytes. See @c stringWidthForCharacter.
+     */
+    uint8_t width;
+    /** Whether this is the interned string of its characters, see @c stringIntern. */
+    bool interned;
 } String;
 
 typedef struct {
@@ -186,6 +166,18 @@ extern bool instanceof(Object *object, Class *cl);
  * @warning This function will modify @c P to point to an exact copy of @c O after the function call.
  */
 extern void mark(Object **of);
+/**
+ * Marks the array pointed to by @c of of which only the @c length bytes starting at the byte offset @c offset points
+ * to are used. If the array is large and its slices are mostly unused, the garbage collector copies only the used
+ * bytes once all objects were marked and updates @c of and @c offset, which must therefore not move.
+ */
+extern void markArraySlice(Object **of, EmojicodeInteger *offset, size_t length);
+/**
+ * Marks @c of as a weak reference: The object @c of points to is not kept alive by it. Once all objects were marked,
+ * @c of is updated to point to the copy of the object or set to @c NULL if the object is garbage. @c of must therefore
+ * not move.
+ */
+extern void markWeakReference(Object **of);
 /**
  * If the calling thread needs to be paused for the GC to run, this function will first
  * unlock @c mutex if it is not a @c NULL pointer, then block until the GC cycle is completed
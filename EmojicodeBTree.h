@@ -0,0 +1,38 @@
+//
+//  EmojicodeBTree.h
+//  Emojicode
+//
+
+#ifndef EmojicodeBTree_h
+#define EmojicodeBTree_h
+
+#include "EmojicodeAPI.h"
+
+/**
+ * Structure for the ordered maps 🌲, which has string keys, and 🌴, which has integer keys. The items are stored in a
+ * B-tree whose nodes are arrays holding up to @c BTREE_MAX_KEYS keys and values next to each other, so that a lookup
+ * only touches a few nodes. Every node also stores the number of items in its subtree, which allows to find the rank
+ * of a key and the key at a rank in @c O(log n).
+ */
+typedef struct {
+    /** The root node or @c NULL if the tree is empty. */
+    Object *root;
+    /**
+     * Nodes that are not part of the tree and can be used when a node is split. Inserting an item first allocates
+     * enough spare nodes, so that the tree is never modified while the garbage collector might run.
+     * The spare nodes are linked through their first child.
+     */
+    Object *spareNodes;
+    /** The number of nodes in @c spareNodes. */
+    size_t spareCount;
+    /** @c T_INTEGER for integer keys and @c T_OBJECT for string keys, which are ordered as defined by ↔️. */
+    Type keyType;
+} BTree;
+
+/** Marker for B-trees. */
+void btreeMark(Object *self);
+
+FunctionFunctionPointer btreeMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer btreeInitializerForName(EmojicodeChar cl);
+
+#endif /* EmojicodeBTree_h */
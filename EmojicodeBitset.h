@@ -0,0 +1,34 @@
+//
+//  EmojicodeBitset.h
+//  Emojicode
+//
+
+#ifndef EmojicodeBitset_h
+#define EmojicodeBitset_h
+
+#include "EmojicodeAPI.h"
+
+typedef uint64_t BitsetWord;
+
+#define BITSET_WORD_BITS 64
+
+/**
+ * Structure for 🚦, a growable array of bits. The bits are packed into words, so that operations on whole bitsets
+ * handle 64 bits at once. Bits in the last word that are beyond @c count are always zero.
+ */
+typedef struct {
+    /** The number of bits. */
+    size_t count;
+    /** The number of words @c words can store. */
+    size_t capacity;
+    /** The array storing the words. Can be @c NULL if @c capacity is 0. */
+    Object *words;
+} Bitset;
+
+/** Marker for bitsets. Only copies the words. */
+void bitsetMark(Object *self);
+
+FunctionFunctionPointer bitsetMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer bitsetInitializerForName(EmojicodeChar name);
+
+#endif /* EmojicodeBitset_h */
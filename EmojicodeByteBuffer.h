@@ -0,0 +1,38 @@
+//
+//  EmojicodeByteBuffer.h
+//  Emojicode
+//
+
+#ifndef EmojicodeByteBuffer_h
+#define EmojicodeByteBuffer_h
+
+#include "EmojicodeAPI.h"
+
+/**
+ * Structure for 📼, a growable byte buffer. Values are always appended after the last byte, while reading starts at
+ * @c position and advances it.
+ *
+ * Converting the buffer to 📇 shares @c bytes instead of copying them. Appending never changes the first @c length
+ * bytes, so the 📇 stays valid. Only emptying the buffer would overwrite them, which is why it drops @c bytes if
+ * @c shared is set.
+ */
+typedef struct {
+    /** The number of bytes. */
+    size_t length;
+    /** The number of bytes @c bytes can store. */
+    size_t capacity;
+    /** The index of the next byte to read. Never greater than @c length. */
+    size_t position;
+    /** The array storing the bytes. Can be @c NULL if @c capacity is 0. */
+    Object *bytes;
+    /** Whether a 📇 was created from @c bytes. */
+    bool shared;
+} ByteBuffer;
+
+/** Marker for byte buffers. Only copies the bytes. */
+void byteBufferMark(Object *self);
+
+FunctionFunctionPointer byteBufferMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer byteBufferInitializerForName(EmojicodeChar name);
+
+#endif /* EmojicodeByteBuffer_h */
@@ -39,6 +39,11 @@ extern Class *CL_LIST;
 extern Class *CL_ERROR;
 extern Class *CL_DATA;
 extern Class *CL_DICTIONARY;
+extern Class *CL_INTEGER_DICTIONARY;
+extern Class *CL_SYMBOL_DICTIONARY;
+extern Class *CL_STRING_SET;
+extern Class *CL_INTEGER_SET;
+extern Class *CL_SYMBOL_SET;
 extern Class *CL_RANGE;
 extern Protocol *PR_ENUMERATOR;
 extern Protocol *PR_ENUMERATEABLE;
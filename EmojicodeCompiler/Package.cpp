@@ -10,6 +10,7 @@
 #include <list>
 #include <string>
 #include <map>
+#include <stdexcept>
 #include "Package.hpp"
 #include "PackageParser.hpp"
 #include "CompilerErrorException.hpp"
@@ -43,6 +43,44 @@ bool StaticFunctionAnalyzer::typeIsEnumerable(Type type, Type *elementType) {
     return false;
 }
 
+bool StaticFunctionAnalyzer::typeIsDictionary(Type type, Type *keyType) {
+    if (type.type() != TypeContent::Class || type.optional()) {
+        return false;
+    }
+    if (type.eclass() == CL_DICTIONARY) {
+        *keyType = Type(CL_STRING);
+        return true;
+    }
+    if (type.eclass() == CL_INTEGER_DICTIONARY) {
+        *keyType = typeInteger;
+        return true;
+    }
+    if (type.eclass() == CL_SYMBOL_DICTIONARY) {
+        *keyType = typeSymbol;
+        return true;
+    }
+    return false;
+}
+
+bool StaticFunctionAnalyzer::typeIsSet(Type type, Type *elementType) {
+    if (type.type() != TypeContent::Class || type.optional()) {
+        return false;
+    }
+    if (type.eclass() == CL_STRING_SET) {
+        *elementType = Type(CL_STRING);
+        return true;
+    }
+    if (type.eclass() == CL_INTEGER_SET) {
+        *elementType = typeInteger;
+        return true;
+    }
+    if (type.eclass() == CL_SYMBOL_SET) {
+        *elementType = typeSymbol;
+        return true;
+    }
+    return false;
+}
+
 Type StaticFunctionAnalyzer::parseFunctionCall(Type type, Function *p, const Token &token) {
     std::vector<Type> genericArguments;
     std::vector<CommonTypeFinder> genericArgsFinders;
@@ -124,13 +162,13 @@ Type StaticFunctionAnalyzer::parseFunctionCall(Type type, Function *p, const Tok
     return p->returnType.resolveOn(typeContext);
 }
 
-void StaticFunctionAnalyzer::writeCoinForScopesUp(bool inObjectScope, EmojicodeCoin stack,
-                                                  EmojicodeCoin object, SourcePosition p) {
+void StaticFunctionAnalyzer::writeCoinForScopesUp(bool inObjectScope, EmojicodeInstruction stack,
+                                                  EmojicodeInstruction object, SourcePosition p) {
     if (!inObjectScope) {
-        writer.writeCoin(stack, p);
+        writer.writeInstruction(stack, p);
     }
     else {
-        writer.writeCoin(object, p);
+        writer.writeInstruction(object, p);
         usedSelf = true;
     }
 }
@@ -188,7 +226,7 @@ void StaticFunctionAnalyzer::flowControlReturnEnd(FlowControlReturn &fcr) {
 void StaticFunctionAnalyzer::parseIfExpression(const Token &token) {
     if (stream_.nextTokenIs(E_SOFT_ICE_CREAM)) {
         stream_.consumeToken(IDENTIFIER);
-        writer.writeCoin(0x3E, token);
+        writer.writeInstruction(0x3E, token);
         
         auto &varName = stream_.consumeToken(VARIABLE);
         if (scoper.currentScope().hasLocalVariable(varName.value)) {
@@ -215,15 +253,15 @@ void StaticFunctionAnalyzer::parseIfExpression(const Token &token) {
 Type StaticFunctionAnalyzer::parse(const Token &token, Type expectation) {
     switch (token.type()) {
         case STRING: {
-            writer.writeCoin(0x10, token);
+            writer.writeInstruction(0x10, token);
             writer.writeCoin(StringPool::theStringPool().poolString(token.value), token);
             return Type(CL_STRING);
         }
         case BOOLEAN_TRUE:
-            writer.writeCoin(0x11, token);
+            writer.writeInstruction(0x11, token);
             return typeBoolean;
         case BOOLEAN_FALSE:
-            writer.writeCoin(0x12, token);
+            writer.writeInstruction(0x12, token);
             return typeBoolean;
         case INTEGER: {
             /* We know token->value only contains ints less than 255 */
@@ -233,28 +271,26 @@ Type StaticFunctionAnalyzer::parse(const Token &token, Type expectation) {
             delete [] string;
             
             if (expectation.type() == TypeContent::ValueType && expectation.valueType() == VT_DOUBLE) {
-                writer.writeCoin(0x15, token);
+                writer.writeInstruction(0x15, token);
                 writer.writeDoubleCoin(l, token);
                 return typeFloat;
             }
             
             if (llabs(l) > INT32_MAX) {
-                writer.writeCoin(0x14, token);
-                
-                writer.writeCoin(l >> 32, token);
-                writer.writeCoin((EmojicodeCoin)l, token);
+                writer.writeInstruction(0x14, token);
+                writer.writeLongIntegerCoin(l, token);
                 
                 return typeInteger;
             }
             else {
-                writer.writeCoin(0x13, token);
-                writer.writeCoin((EmojicodeCoin)l, token);
+                writer.writeInstruction(0x13, token);
+                writer.writeIntegerCoin(l, token);
                 
                 return typeInteger;
             }
         }
         case DOUBLE: {
-            writer.writeCoin(0x15, token);
+            writer.writeInstruction(0x15, token);
             
             const char *string = token.value.utf8CString();
             
@@ -264,7 +300,7 @@ Type StaticFunctionAnalyzer::parse(const Token &token, Type expectation) {
             return typeFloat;
         }
         case SYMBOL:
-            writer.writeCoin(0x16, token);
+            writer.writeInstruction(0x16, token);
             writer.writeCoin(token.value[0], token);
             return typeSymbol;
         case VARIABLE: {
@@ -312,9 +348,9 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             scoper.currentScope().setLocalVariable(varName.value,
                                                    Variable(t, id, t.optional() ? 1 : 0, false, varName));
             if (t.optional()) {
-                writer.writeCoin(0x1B, token);
+                writer.writeInstruction(0x1B, token);
                 writer.writeCoin(id, token);
-                writer.writeCoin(0x17, token);
+                writer.writeInstruction(0x17, token);
             }
             return typeNothingness;
         }
@@ -337,7 +373,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             }
             catch (VariableNotFoundErrorException &vne) {
                 // Not declared, declaring as local variable
-                writer.writeCoin(0x1B, token);
+                writer.writeInstruction(0x1B, token);
                 
                 int id = scoper.reserveVariableSlot();
                 writer.writeCoin(id, token);
@@ -358,7 +394,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
                 throw CompilerErrorException(token, "Cannot redeclare variable.");
             }
             
-            writer.writeCoin(0x1B, token);
+            writer.writeInstruction(0x1B, token);
             
             int id = scoper.reserveVariableSlot();
             writer.writeCoin(id, token);
@@ -393,7 +429,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return typeNothingness;
         }
         case E_COOKIE: {
-            writer.writeCoin(0x52, token);
+            writer.writeInstruction(0x52, token);
             auto placeholder = writer.writeCoinPlaceholder(token);
             
             int stringCount = 0;
@@ -412,7 +448,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return Type(CL_STRING);
         }
         case E_ICE_CREAM: {
-            writer.writeCoin(0x51, token);
+            writer.writeInstruction(0x51, token);
             
             auto placeholder = writer.writeCoinsCountPlaceholderCoin(token);
             
@@ -438,7 +474,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return type;
         }
         case E_HONEY_POT: {
-            writer.writeCoin(0x50, token);
+            writer.writeInstruction(0x50, token);
            
             auto placeholder = writer.writeCoinsCountPlaceholderCoin(token);
             Type type = Type(CL_DICTIONARY);
@@ -465,20 +501,20 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return type;
         }
         case E_BLACK_RIGHT_POINTING_DOUBLE_TRIANGLE: {
-            writer.writeCoin(0x53, token);
+            writer.writeInstruction(0x53, token);
             parse(stream_.consumeToken(), token, typeInteger);
             parse(stream_.consumeToken(), token, typeInteger);
             return Type(CL_RANGE);
         }
         case E_BLACK_RIGHT_POINTING_DOUBLE_TRIANGLE_WITH_VERTICAL_BAR: {
-            writer.writeCoin(0x54, token);
+            writer.writeInstruction(0x54, token);
             parse(stream_.consumeToken(), token, typeInteger);
             parse(stream_.consumeToken(), token, typeInteger);
             parse(stream_.consumeToken(), token, typeInteger);
             return Type(CL_RANGE);
         }
         case E_TANGERINE: {
-            writer.writeCoin(0x62, token);
+            writer.writeInstruction(0x62, token);
             
             auto placeholder = writer.writeCoinsCountPlaceholderCoin(token);
             auto fcr = FlowControlReturn();
@@ -490,7 +526,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             
             while (stream_.nextTokenIs(E_LEMON)) {
                 stream_.consumeToken();
-                writer.writeCoin(0x63, token);
+                writer.writeInstruction(0x63, token);
                 
                 parseIfExpression(token);
                 flowControlBlock();
@@ -513,7 +549,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return typeNothingness;
         }
         case E_CLOCKWISE_RIGHTWARDS_AND_LEFTWARDS_OPEN_CIRCLE_ARROWS: {
-            writer.writeCoin(0x61, token);
+            writer.writeInstruction(0x61, token);
             
             parse(stream_.consumeToken(), token, typeBoolean);
             flowControlBlock();
@@ -522,7 +558,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return typeNothingness;
         }
         case E_CLOCKWISE_RIGHTWARDS_AND_LEFTWARDS_OPEN_CIRCLE_ARROWS_WITH_CIRCLED_ONE_OVERLAY: {
-            auto placeholder = writer.writeCoinPlaceholder(token);
+            auto placeholder = writer.writeInstructionPlaceholder(token);
             
             auto &variableToken = stream_.consumeToken(VARIABLE);
             
@@ -531,11 +567,31 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             int vID = scoper.reserveVariableSlot();
             writer.writeCoin(vID, token);
             
+            // A second variable, which is not the iteratee itself, receives the values of a dictionary
+            const Token *valueVariableToken = nullptr;
+            int valueVID = 0;
+            if (stream_.nextTokenIs(VARIABLE) && !stream_.tokenAfterNextIs(E_GRAPES)) {
+                valueVariableToken = &stream_.consumeToken(VARIABLE);
+                valueVID = scoper.reserveVariableSlot();
+                writer.writeCoin(valueVID, token);
+            }
+            
             Type iteratee = parse(stream_.consumeToken(), token, typeSomeobject);
             
             Type itemType = typeNothingness;
             
-            if (iteratee.type() == TypeContent::Class && iteratee.eclass() == CL_LIST) {
+            if (valueVariableToken) {
+                if (!typeIsDictionary(iteratee, &itemType)) {
+                    auto iterateeString = iteratee.toString(typeContext, true);
+                    throw CompilerErrorException(token, "%s is not a dictionary and cannot be enumerated by key and value.",
+                                                 iterateeString.c_str());
+                }
+                placeholder.write(0x6A);
+                writer.writeCoin(scoper.reserveVariableSlot(), token);  //Internally needed
+                scoper.currentScope().setLocalVariable(variableToken.value, Variable(itemType, vID, true, true, variableToken));
+                scoper.currentScope().setLocalVariable(valueVariableToken->value, Variable(iteratee.genericArguments[0], valueVID, true, true, *valueVariableToken));
+            }
+            else if (iteratee.type() == TypeContent::Class && iteratee.eclass() == CL_LIST) {
                 // If the iteratee is a list, the Real-Time Engine has some special sugar
                 placeholder.write(0x65);
                 writer.writeCoin(scoper.reserveVariableSlot(), token);  //Internally needed
@@ -546,6 +602,22 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
                 placeholder.write(0x66);
                 scoper.currentScope().setLocalVariable(variableToken.value, Variable(typeInteger, vID, true, true, variableToken));
             }
+            else if (iteratee.type() == TypeContent::Class && iteratee.eclass() == CL_STRING) {
+                // Strings, data, dictionaries and sets are enumerated by the Real-Time Engine without an enumerator object
+                placeholder.write(0x67);
+                writer.writeCoin(scoper.reserveVariableSlot(), token);  //Internally needed
+                scoper.currentScope().setLocalVariable(variableToken.value, Variable(typeSymbol, vID, true, true, variableToken));
+            }
+            else if (iteratee.type() == TypeContent::Class && iteratee.eclass() == CL_DATA) {
+                placeholder.write(0x68);
+                writer.writeCoin(scoper.reserveVariableSlot(), token);  //Internally needed
+                scoper.currentScope().setLocalVariable(variableToken.value, Variable(typeInteger, vID, true, true, variableToken));
+            }
+            else if (typeIsDictionary(iteratee, &itemType) || typeIsSet(iteratee, &itemType)) {
+                placeholder.write(0x69);
+                writer.writeCoin(scoper.reserveVariableSlot(), token);  //Internally needed
+                scoper.currentScope().setLocalVariable(variableToken.value, Variable(itemType, vID, true, true, variableToken));
+            }
             else if (typeIsEnumerable(iteratee, &itemType)) {
                 placeholder.write(0x64);
                 writer.writeCoin(scoper.reserveVariableSlot(), token);  //Internally needed
@@ -572,7 +644,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
         }
         case E_DOG: {
             usedSelf = true;
-            writer.writeCoin(0x3C, token);
+            writer.writeInstruction(0x3C, token);
             if (mode == StaticFunctionAnalyzerMode::ObjectInitializer) {
                 if (!calledSuper && static_cast<Initializer &>(callable).owningType.eclass()->superclass) {
                     throw CompilerErrorException(token, "Attempt to use 🐕 before superinitializer call.");
@@ -589,16 +661,16 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return typeContext.calleeType();
         }
         case E_HIGH_VOLTAGE_SIGN: {
-            writer.writeCoin(0x17, token);
+            writer.writeInstruction(0x17, token);
             return typeNothingness;
         }
         case E_CLOUD: {
-            writer.writeCoin(0x2E, token);
+            writer.writeInstruction(0x2E, token);
             parse(stream_.consumeToken());
             return typeBoolean;
         }
         case E_FACE_WITH_STUCK_OUT_TONGUE_AND_WINKING_EYE: {
-            writer.writeCoin(0x2D, token);
+            writer.writeInstruction(0x2D, token);
             
             parse(stream_.consumeToken(), token, typeSomeobject);
             parse(stream_.consumeToken(), token, typeSomeobject);
@@ -622,11 +694,11 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             scoper.objectScope()->initializerUnintializedVariablesCheck(token,
                                             "Instance variable \"%s\" must be initialized before superinitializer.");
             
-            writer.writeCoin(0x3D, token);
+            writer.writeInstruction(0x3D, token);
             
             Class *eclass = typeContext.calleeType().eclass();
             
-            writer.writeCoin(0xF, token);
+            writer.writeInstruction(0xF, token);
             writer.writeCoin(eclass->superclass->index, token);
             
             auto &initializerToken = stream_.consumeToken(IDENTIFIER);
@@ -648,7 +720,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             }
             effect = true;
             
-            writer.writeCoin(0x60, token);
+            writer.writeInstruction(0x60, token);
             
             if (mode == StaticFunctionAnalyzerMode::ObjectInitializer) {
                 if (static_cast<Initializer &>(callable).canReturnNothingness) {
@@ -665,7 +737,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return typeNothingness;
         }
         case E_WHITE_LARGE_SQUARE: {
-            writer.writeCoin(0xE, token);
+            writer.writeInstruction(0xE, token);
             Type originalType = parse(stream_.consumeToken());
             if (!originalType.allowsMetaType()) {
                 auto string = originalType.toString(typeContext, true);
@@ -675,7 +747,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return originalType;
         }
         case E_WHITE_SQUARE_BUTTON: {
-            writer.writeCoin(0xF, token);
+            writer.writeInstruction(0xF, token);
             Type originalType = parseTypeDeclarative(typeContext, TypeDynamism::None);
             if (!originalType.allowsMetaType()) {
                 auto string = originalType.toString(typeContext, true);
@@ -686,7 +758,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return originalType;
         }
         case E_BLACK_SQUARE_BUTTON: {
-            auto placeholder = writer.writeCoinPlaceholder(token);
+            auto placeholder = writer.writeInstructionPlaceholder(token);
             
             Type originalType = parse(stream_.consumeToken());
             auto pair = parseTypeAsValue(typeContext, token);
@@ -738,7 +810,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return type;
         }
         case E_BEER_MUG: {
-            writer.writeCoin(0x3A, token);
+            writer.writeInstruction(0x3A, token);
             
             Type t = parse(stream_.consumeToken());
             
@@ -749,7 +821,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return t.copyWithoutOptional();
         }
         case E_CLINKING_BEER_MUGS: {
-            writer.writeCoin(0x3B, token);
+            writer.writeInstruction(0x3B, token);
             
             auto &methodToken = stream_.consumeToken();
             
@@ -774,7 +846,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
         case E_HOT_PEPPER: {
             Function *function;
             
-            auto placeholder = writer.writeCoinPlaceholder(token);
+            auto placeholder = writer.writeInstructionPlaceholder(token);
             if (stream_.nextTokenIs(E_DOUGHNUT)) {
                 stream_.consumeToken();
                 auto &methodName = stream_.consumeToken();
@@ -787,7 +859,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
                 else if (type.type() == TypeContent::ValueType) {
                     notStaticError(pair.second, token, "Value Types");
                     placeholder.write(0x74);
-                    writer.writeCoin(0x17, token);
+                    writer.writeInstruction(0x17, token);
                 }
                 else {
                     throw CompilerErrorException(token, "You can’t capture method calls on this kind of type.");
@@ -816,7 +888,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return function->type();
         }
         case E_GRAPES: {
-            writer.writeCoin(0x71, token);
+            writer.writeInstruction(0x71, token);
             
             auto function = Closure(token.position());
             parseArgumentList(&function, typeContext);
@@ -841,7 +913,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return function.type();
         }
         case E_LOLLIPOP: {
-            writer.writeCoin(0x70, token);
+            writer.writeInstruction(0x70, token);
             
             Type type = parse(stream_.consumeToken());
             
@@ -870,15 +942,15 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             
             Method *method = superclass->getMethod(nameToken, Type(superclass), typeContext);
             
-            writer.writeCoin(0x5, token);
-            writer.writeCoin(0xF, token);
+            writer.writeInstruction(0x5, token);
+            writer.writeInstruction(0xF, token);
             writer.writeCoin(superclass->index, token);
             writer.writeCoin(method->vti(), token);
             
             return parseFunctionCall(typeContext.calleeType(), method, token);
         }
         case E_LARGE_BLUE_DIAMOND: {
-            auto placeholder = writer.writeCoinPlaceholder(token);
+            auto placeholder = writer.writeInstructionPlaceholder(token);
             auto pair = parseTypeAsValue(typeContext, token, expectation);
             auto type = pair.first.resolveOnSuperArgumentsAndConstraints(typeContext);
             
@@ -890,7 +962,6 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             
             if (type.type() == TypeContent::Enum) {
                 notStaticError(pair.second, token, "Enums");
-                placeholder.write(0x13);
                 
                 auto v = type.eenum()->getValueFor(initializerName.value[0]);
                 if (!v.first) {
@@ -899,12 +970,13 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
                     throw CompilerErrorException(initializerName, "%s does not have a member named %s.",
                                                  enumName, valueName);
                 }
-                else if (v.second > UINT32_MAX) {
-                    writer.writeCoin(v.second >> 32, token);
-                    writer.writeCoin((EmojicodeCoin)v.second, token);
+                else if (llabs(v.second) > INT32_MAX) {
+                    placeholder.write(0x14);
+                    writer.writeLongIntegerCoin(v.second, token);
                 }
                 else {
-                    writer.writeCoin((EmojicodeCoin)v.second, token);
+                    placeholder.write(0x13);
+                    writer.writeIntegerCoin(v.second, token);
                 }
                 
                 return type;
@@ -949,7 +1021,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
         case E_DOUGHNUT: {
             auto &methodToken = stream_.consumeToken(IDENTIFIER);
             
-            auto placeholder = writer.writeCoinPlaceholder(token);
+            auto placeholder = writer.writeInstructionPlaceholder(token);
             auto pair = parseTypeAsValue(typeContext, token);
             auto type = pair.first.resolveOnSuperArgumentsAndConstraints(typeContext);
             
@@ -975,7 +1047,7 @@ Type StaticFunctionAnalyzer::parseIdentifier(const Token &token, Type expectatio
             return parseFunctionCall(type, method, token);
         }
         default: {
-            auto placeholder = writer.writeCoinPlaceholder(token);
+            auto placeholder = writer.writeInstructionPlaceholder(token);
             
             auto &tobject = stream_.consumeToken();
             Type type = parse(tobject).resolveOnSuperArgumentsAndConstraints(typeContext);
@@ -1185,14 +1257,14 @@ std::pair<Type, TypeAvailability> StaticFunctionAnalyzer::parseTypeAsValue(TypeC
         case TypeContent::Reference:
             throw CompilerErrorException(p, "Generic Arguments are not yet available for reflection.");
         case TypeContent::Class:
-            writer.writeCoin(0xF, p);
+            writer.writeInstruction(0xF, p);
             writer.writeCoin(ot.eclass()->index, p);
             return std::pair<Type, TypeAvailability>(ot, TypeAvailability::StaticAndAvailabale);
         case TypeContent::Self:
             if (mode != StaticFunctionAnalyzerMode::ClassMethod) {
                 throw CompilerErrorException(p, "Illegal use of 🐕.");
             }
-            writer.writeCoin(0x3C, p);
+            writer.writeInstruction(0x3C, p);
             return std::pair<Type, TypeAvailability>(ot, TypeAvailability::DynamicAndAvailabale);
         case TypeContent::LocalReference:
             throw CompilerErrorException(p, "Function Generic Arguments are not available for reflection.");
@@ -113,11 +113,16 @@ private:
      * @param stack The command to access the variable if it is on the stack.
      * @param object The command to access the variable it it is an instance variable.
      */
-    void writeCoinForScopesUp(bool inObjectScope, EmojicodeCoin stack, EmojicodeCoin object, SourcePosition p);
+    void writeCoinForScopesUp(bool inObjectScope, EmojicodeInstruction stack, EmojicodeInstruction object,
+                              SourcePosition p);
     
     void noReturnError(SourcePosition p);
     void noEffectWarning(const Token &warningToken);
     bool typeIsEnumerable(Type type, Type *elementType);
+    /** Whether @c type is a dictionary, 🍯, 🗃 or 🗂, in which case its key type is stored in @c keyType. */
+    bool typeIsDictionary(Type type, Type *keyType);
+    /** Whether @c type is a set, 🍱, 🗄 or 🗳, in which case its element type is stored in @c elementType. */
+    bool typeIsSet(Type type, Type *elementType);
     void flowControlBlock(bool block = true);
 
     void flowControlReturnEnd(FlowControlReturn &fcr);
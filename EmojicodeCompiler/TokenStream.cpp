@@ -35,6 +35,12 @@ bool TokenStream::nextTokenIs(EmojicodeChar c) const {
     return nextToken && nextToken->type() == IDENTIFIER && nextToken->value[0] == c;
 }
 
+bool TokenStream::tokenAfterNextIs(EmojicodeChar c) const {
+    const Token *nextToken = currentToken_->nextToken_;
+    const Token *token = nextToken ? nextToken->nextToken_ : nullptr;
+    return token && token->type() == IDENTIFIER && token->value[0] == c;
+}
+
 bool TokenStream::nextTokenIsEverythingBut(EmojicodeChar c) const {
     const Token *nextToken = currentToken_->nextToken_;
     return nextToken && !(nextToken->type() == IDENTIFIER && nextToken->value[0] == c);
@@ -26,6 +26,8 @@ public:
     bool nextTokenIs(TokenType type) const;
     /** Tests whether the next token is an identifier and the value’s first element matches the given character. */
     bool nextTokenIs(EmojicodeChar c) const;
+    /** Tests whether the token after the next token is an identifier and the value’s first element matches @c c. */
+    bool tokenAfterNextIs(EmojicodeChar c) const;
     /** 
      * Tests whether the end of the stream was not reached and the value’s first element matches
      * the given character. 
@@ -25,6 +25,11 @@ Class *CL_LIST;
 Class *CL_ERROR;
 Class *CL_DATA;
 Class *CL_DICTIONARY;
+Class *CL_INTEGER_DICTIONARY;
+Class *CL_SYMBOL_DICTIONARY;
+Class *CL_STRING_SET;
+Class *CL_INTEGER_SET;
+Class *CL_SYMBOL_SET;
 Protocol *PR_ENUMERATEABLE;
 Protocol *PR_ENUMERATOR;
 Class *CL_RANGE;
@@ -6,63 +6,112 @@
 //  Copyright (c) 2015 Theo Weidmann. All rights reserved.
 //
 
-#include <cmath>
+#include <cstring>
 #include "Writer.hpp"
 #include "CompilerErrorException.hpp"
 
-void Writer::writeUInt16(uint16_t value) {
+void Writer::write(uint16_t value) {
     fputc(value, out);
     fputc(value >> 8, out);
 }
 
-void Writer::writeEmojicodeChar(EmojicodeChar c) {
+void Writer::write(uint32_t c) {
     fputc(c, out);
     fputc(c >> 8, out);
     fputc(c >> 16, out);
     fputc(c >> 24, out);
 }
 
+void Writer::countBytes(uint32_t count, SourcePosition p) {
+    if (writtenBytes > 4294967295 - count) {
+        throw CompilerErrorException(p, "You exceeded the limit of 4294967295 allowed bytes in a function.");
+    }
+    writtenBytes += count;
+}
+
+void Writer::writeUInt16(uint16_t value) {
+    write(value);
+    writtenBytes += 2;
+}
+
+void Writer::writeEmojicodeChar(EmojicodeChar c) {
+    write(c);
+    writtenBytes += 4;
+}
+
+void Writer::writeInstruction(EmojicodeInstruction value, SourcePosition p) {
+    fputc(value, out);
+    countBytes(1, p);
+}
+
 void Writer::writeCoin(EmojicodeCoin value, SourcePosition p) {
+    uint32_t count = 1;
+    while (value >= 0x80) {
+        fputc((value & 0x7F) | 0x80, out);
+        value >>= 7;
+        count++;
+    }
     fputc(value, out);
-    fputc(value >> 8, out);
-    fputc(value >> 16, out);
-    fputc(value >> 24, out);
-    
-    if (++writtenCoins == 4294967295) {
-        throw CompilerErrorException(p, "You exceeded the limit of 4294967295 allowed instructions in a function.");
+    countBytes(count, p);
+}
+
+void Writer::writeIntegerCoin(EmojicodeInteger value, SourcePosition p) {
+    uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+    uint32_t count = 1;
+    while (zigzag >= 0x80) {
+        fputc((zigzag & 0x7F) | 0x80, out);
+        zigzag >>= 7;
+        count++;
     }
+    fputc((int)zigzag, out);
+    countBytes(count, p);
+}
+
+void Writer::writeLongIntegerCoin(EmojicodeInteger value, SourcePosition p) {
+    uint64_t bits = value;
+    for (int i = 0; i < 8; i++) {
+        fputc((int)(bits >> (i * 8)) & 0xFF, out);
+    }
+    countBytes(8, p);
 }
 
 void Writer::writeByte(unsigned char c) {
     fputc(c, out);
+    writtenBytes++;
 }
 
 void Writer::writeBytes(const char *bytes, size_t count) {
     fwrite(bytes, sizeof(char), count, out);
+    writtenBytes += count;
 }
 
 void Writer::writeDoubleCoin(double val, SourcePosition p) {
-    int exp = 0;
-    double norm = std::frexp(val, &exp);
-    int_least64_t scale = norm*PORTABLE_INTLEAST64_MAX;
-    
-    writeCoin(scale >> 32, p);
-    writeCoin((EmojicodeCoin)scale, p);
-    writeCoin(exp, p);
+    uint64_t bits;
+    std::memcpy(&bits, &val, sizeof(bits));
+    writeLongIntegerCoin((EmojicodeInteger)bits, p);
 }
 
 WriterPlaceholder<EmojicodeCoin> Writer::writeCoinPlaceholder(SourcePosition p) {
     off_t position = ftello(out);
-    writeCoin(0, p);
+    write((EmojicodeCoin)0);
+    countBytes(4, p);
     return WriterPlaceholder<EmojicodeCoin>(*this, position);
 }
 
+WriterPlaceholder<EmojicodeInstruction> Writer::writeInstructionPlaceholder(SourcePosition p) {
+    off_t position = ftello(out);
+    write((EmojicodeInstruction)0);
+    countBytes(1, p);
+    return WriterPlaceholder<EmojicodeInstruction>(*this, position);
+}
+
 WriterCoinsCountPlaceholder Writer::writeCoinsCountPlaceholderCoin(SourcePosition p) {
     off_t position = ftello(out);
-    writeCoin(0, p);
-    return WriterCoinsCountPlaceholder(*this, position, writtenCoins);
+    write((EmojicodeCoin)0);
+    countBytes(4, p);
+    return WriterCoinsCountPlaceholder(*this, position, writtenBytes);
 }
 
 void WriterCoinsCountPlaceholder::write() {
-    WriterPlaceholder<EmojicodeCoin>::write(writer.writtenCoins - oWrittenCoins);
+    WriterPlaceholder<EmojicodeCoin>::write(writer.writtenBytes - oWrittenBytes);
 }
@@ -30,20 +30,29 @@ public:
     /** Must be used to write any uint16_t to the file */
     void writeUInt16(uint16_t value);
     
-    /** Writes a coin with the given value */
+    /** Writes an instruction. Instructions always occupy exactly one byte. */
+    void writeInstruction(EmojicodeInstruction value, SourcePosition p);
+    
+    /** Writes a coin with the given value as unsigned LEB128. */
     void writeCoin(EmojicodeCoin value, SourcePosition p);
     
+    /** Writes an integer literal as zigzag encoded LEB128. */
+    void writeIntegerCoin(EmojicodeInteger value, SourcePosition p);
+    
+    /** Writes an integer literal as fixed-width 64-bit value. Preferable for literals of large magnitude. */
+    void writeLongIntegerCoin(EmojicodeInteger value, SourcePosition p);
+    
     /** Writes a single unicode character */
     void writeEmojicodeChar(EmojicodeChar c);
     
-    /** Must be used to write any double to the file. */
+    /** Must be used to write any double to the file. Doubles are written as IEEE 754 binary64 in little endian. */
     void writeDoubleCoin(double val, SourcePosition p);
 
     void writeByte(unsigned char);
     
     void writeBytes(const char *bytes, size_t count);
     
-    void resetWrittenCoins() { writtenCoins = 0; };
+    void resetWrittenCoins() { writtenBytes = 0; };
     
     /**
      * Writes a placeholder coin. To replace the placeholder use `writeCoinAtPlaceholder`
@@ -52,18 +61,25 @@ public:
     WriterPlaceholder<T> writePlaceholder() {
         off_t position = ftello(out);
         write((T)0);
+        writtenBytes += sizeof(T);
         return WriterPlaceholder<T>(*this, position);
     }
     
+    /** Writes a placeholder for a fixed-width coin, which will be the number of bytes written until @c write is called. */
     WriterCoinsCountPlaceholder writeCoinsCountPlaceholderCoin(SourcePosition p);
+    /** Writes a placeholder for a fixed-width coin. */
     WriterPlaceholder<EmojicodeCoin> writeCoinPlaceholder(SourcePosition p);
+    /** Writes a placeholder for an instruction. */
+    WriterPlaceholder<EmojicodeInstruction> writeInstructionPlaceholder(SourcePosition p);
 private:
-    void write(uint16_t v) { writeUInt16(v); };
-    void write(uint32_t v) { writeEmojicodeChar(v); };
-    void write(unsigned char v) { writeByte(v); };
+    void write(uint16_t v);
+    void write(uint32_t v);
+    void write(unsigned char v) { fputc(v, out); };
+    
+    void countBytes(uint32_t count, SourcePosition p);
     
     FILE *out;
-    uint32_t writtenCoins = 0;
+    uint32_t writtenBytes = 0;
 };
 
 template <typename T>
@@ -88,9 +104,9 @@ class WriterCoinsCountPlaceholder: private WriterPlaceholder<EmojicodeCoin> {
 public:
     void write();
 private:
-    WriterCoinsCountPlaceholder(Writer &w, off_t position, uint32_t writtenCoins)
-        : WriterPlaceholder(w, position), oWrittenCoins(writtenCoins) {};
-    uint32_t oWrittenCoins;
+    WriterCoinsCountPlaceholder(Writer &w, off_t position, uint32_t writtenBytes)
+        : WriterPlaceholder(w, position), oWrittenBytes(writtenBytes) {};
+    uint32_t oWrittenBytes;
 };
 
 #endif /* Writer_hpp */
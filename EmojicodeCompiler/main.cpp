@@ -155,6 +155,11 @@ void loadStandard(Package *_, SourcePosition errorPosition) {
     CL_ERROR = getStandardClass(0x1F6A8, _, errorPosition);
     CL_DATA = getStandardClass(0x1F4C7, _, errorPosition);
     CL_DICTIONARY = getStandardClass(0x1F36F, _, errorPosition);
+    CL_INTEGER_DICTIONARY = getStandardClass(0x1f5c3, _, errorPosition);
+    CL_SYMBOL_DICTIONARY = getStandardClass(0x1f5c2, _, errorPosition);
+    CL_STRING_SET = getStandardClass(0x1f371, _, errorPosition);
+    CL_INTEGER_SET = getStandardClass(0x1f5c4, _, errorPosition);
+    CL_SYMBOL_SET = getStandardClass(0x1f5f3, _, errorPosition);
     CL_RANGE = getStandardClass(0x23E9, _, errorPosition);
     
     PR_ENUMERATOR = getStandardProtocol(0x1F361, _, errorPosition);
@@ -0,0 +1,33 @@
+//
+//  EmojicodeDeque.h
+//  Emojicode
+//
+
+#ifndef EmojicodeDeque_h
+#define EmojicodeDeque_h
+
+#include "EmojicodeAPI.h"
+
+/**
+ * Structure for 🎠, a double-ended queue. The elements are stored in a ring buffer: The element at index @c i is
+ * stored in the slot @c (head + i) & (capacity - 1), so elements can be added and removed at both ends without
+ * moving any other element.
+ */
+typedef struct {
+    /** The number of elements in the deque. */
+    size_t count;
+    /** The number of slots of @c items. Always 0 or a power of two. */
+    size_t capacity;
+    /** The slot of the first element. */
+    size_t head;
+    /** The ring buffer storing the elements. Can be @c NULL if @c capacity is 0. */
+    Object *items;
+} Deque;
+
+/** Marker for deques. Only marks the slots that store elements. */
+void dequeMark(Object *self);
+
+FunctionFunctionPointer dequeMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer dequeInitializerForName(EmojicodeChar name);
+
+#endif /* EmojicodeDeque_h */
@@ -11,66 +11,68 @@
 
 #include "EmojicodeString.h"
 
-/** Default initial capacity. MUST be a power of two, default: 8 */
-#define DICTIONARY_DEFAULT_INITIAL_CAPACITY (1 << 3)
+/** The number of slots examined at once while probing. Also the minimal capacity. */
+#define DICTIONARY_GROUP_WIDTH 16
 
-/** Factor for determining whether the dictionary should be resized. */
-#define DICTIONARY_DEFAULT_LOAD_FACTOR (0.75f)
-
-#define DICTIONARY_MAXIMUM_CAPACTIY (1 << 30)
-
-#define DICTIONARY_MAXIMUM_CAPACTIY_THRESHOLD (1 << 16)
+/** The control byte of a slot that has never been used. */
+#define DICTIONARY_CONTROL_EMPTY ((int8_t)-128)
+/** The control byte of a slot whose item has been removed. */
+#define DICTIONARY_CONTROL_DELETED ((int8_t)-2)
 
 typedef uint64_t EmojicodeDictionaryHash;
 
-/** The datastructure with the key-value pair */
-typedef struct {
-    /** The user specified key. */
-    Object *key;
-    
-    /** The user specified value. */
-    Something value;
-    
-    /** The cached hash for the key. Calculated on item addition. */
-    EmojicodeDictionaryHash hash;
-    
-    /** EmojicodeDictionary stores a bucket's elements in a linked list. */
-    Object *next;
-    
-} EmojicodeDictionaryNode;
-
-/** Structure for the Emojicode standard Dictionary. The implementation is similar to Java's Hashmap. */
+/**
+ * Structure for the Emojicode standard Dictionary, 🍯, and its variants with integer keys, 🗃, and symbol keys, 🗂.
+ * The sets 🍱, 🗄 and 🗳 use the same structure but do not store values.
+ * The dictionary is an open addressing hash table in the style of
+ * Swiss tables: Every slot has a control byte, which is either empty, deleted, or stores the lower 7 bits of the hash
+ * of the item in the slot. Lookups compare the control bytes of a whole group of slots at once and only examine the
+ * keys of slots whose control byte matches.
+ *
+ * All slots are stored in a single array object, @c table, which consists of
+ * - the control bytes, followed by a copy of the first @c DICTIONARY_GROUP_WIDTH control bytes so that a group can be
+ *   loaded at every position,
+ * - the hashes of the keys,
+ * - the keys and
+ * - the values, unless the dictionary is a set.
+ */
 typedef struct {
-    /** An array with pointers to linked lists. Initializes when the first item is inserted. */
-    Object *buckets;
+    /** The table as described above. @c NULL until the first item is inserted. */
+    Object *table;
     
-    /** Length of buckets array. */
-    size_t bucketsCounter;
+    /** The number of slots. Always 0 or a power of two not less than @c DICTIONARY_GROUP_WIDTH. */
+    size_t capacity;
     
-    /** The number of items stored in this dictionary. Used for determining whether to resize. */
+    /** The number of items stored in this dictionary. */
     size_t size;
     
-    /** When size * loadFactor >= bucketsCounter the dictionary doubles the amount of buckets */
-    float loadFactor;
+    /** The number of empty slots that can be used before the table must be resized. */
+    size_t growthLeft;
     
-    /** Stores the next threshold for resizing. Is 0 until first resize when item is inserted. */
-    size_t nextThreshold;
+    /**
+     * The type of the keys. @c T_OBJECT means string keys, which are compared by their characters. Integer and symbol
+     * keys are compared by value and hashed without allocating anything.
+     */
+    Type keyType;
+    
+    /** Whether a value is stored for every key. False for sets. */
+    bool storesValues;
 } EmojicodeDictionary;
 
 /**
- * Insert an item and use keyString as key 
+ * Insert an item and use key as key. The key must match the key type of the dictionary.
  * @warning GC-invoking
  */
-void dictionarySet(Object *dicto, Object *key, Something value, Thread *thread);
+void dictionarySet(Object *dicto, Something key, Something value, Thread *thread);
 
-/** Remove an item by keyString as key */
-void dictionaryRemove(EmojicodeDictionary *dict, Object *key, Thread *thread);
+/** Remove an item by key */
+void dictionaryRemove(EmojicodeDictionary *dict, Something key, Thread *thread);
 
-/** Get an item by keyString as key */
-Something dictionaryLookup(EmojicodeDictionary *dict, Object *key, Thread *thread);
+/** Get an item by key */
+Something dictionaryLookup(EmojicodeDictionary *dict, Something key, Thread *thread);
 
 /** Check whether a key is in the dictionary */
-bool dictionaryContains(EmojicodeDictionary *dict, Object *key);
+bool dictionaryContains(EmojicodeDictionary *dict, Something key);
 
 /** 
  * Get all keys as a list
@@ -78,13 +80,30 @@ bool dictionaryContains(EmojicodeDictionary *dict, Object *key);
  */
 Something dictionaryKeys(Object *dicto, Thread *thread);
 
+/**
+ * Finds the next item in the dictionary starting at slot @c *slot, stores its key and value in @c key and @c value and
+ * sets @c *slot to the slot after it. Returns false if there are no more items. Start with @c *slot set to 0.
+ * The dictionary must not be modified while it is enumerated this way.
+ */
+bool dictionaryNextItem(EmojicodeDictionary *dict, size_t *slot, Something *key, Something *value);
+
 void dictionaryMark(Object *dict);
 
 void bridgeDictionaryInit(Thread *thread);
+void bridgeIntegerDictionaryInit(Thread *thread);
+void bridgeSymbolDictionaryInit(Thread *thread);
 
-/** @warning GC-invoking */
+/** Initializes the dictionary in the this-slot on the stack with string keys. */
 void dictionaryInit(Thread *thread);
 
 FunctionFunctionPointer dictionaryMethodForName(EmojicodeChar name);
 
+void bridgeStringSetInit(Thread *thread);
+void bridgeIntegerSetInit(Thread *thread);
+void bridgeSymbolSetInit(Thread *thread);
+
+/** Returns the initializer of the set class @c cl, 🍱, 🗄 or 🗳, with the given name. */
+InitializerFunctionFunctionPointer setInitializerForName(EmojicodeChar cl, EmojicodeChar name);
+FunctionFunctionPointer setMethodForName(EmojicodeChar name);
+
 #endif /* EmojicodeDictionary_h */
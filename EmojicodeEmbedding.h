@@ -0,0 +1,75 @@
+//
+//  EmojicodeEmbedding.h
+//  Emojicode
+//
+
+/*
+ * This file declares the API to run Emojicode programs inside another application. Link against the engine library
+ * (`make libemojicode.a`) and export the symbols of your executable (`-rdynamic`) so that packages can be loaded.
+ *
+ * A program is loaded once and can then be used to create any number of instances. Every instance has its own heap
+ * and threads, so instances do not affect each other and can be executed concurrently on different threads.
+ *
+ * Runtime errors abort the current call instead of terminating the process. Errors on threads started by the program
+ * itself, however, still terminate the process.
+ */
+
+#ifndef EmojicodeEmbedding_h
+#define EmojicodeEmbedding_h
+
+#include "EmojicodeSomething.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct Program Program;
+typedef struct Instance Instance;
+typedef struct Function Function;
+
+/**
+ * Loads the bytecode file at @c path. Programs stay loaded until the process exits.
+ * @returns The program or @c NULL if it could not be loaded, @c emojicodeLastError describes the problem.
+ */
+Program* emojicodeLoadProgram(const char *path);
+
+/** Returns the class with the given name or @c NULL if the program does not contain such a class. */
+Class* emojicodeFindClass(Program *program, EmojicodeChar name);
+
+/**
+ * Returns the function @c name of the type named @c typeName or @c NULL if there is no such function.
+ * Pass 0 as @c typeName to look up the function with the chequered flag, 🏁.
+ */
+Function* emojicodeFindFunction(Program *program, EmojicodeChar typeName, EmojicodeChar name);
+
+/**
+ * Creates a new instance of the program. The program sees @c arguments as its command line arguments, which must
+ * stay valid for the lifetime of the instance.
+ */
+Instance* emojicodeNewInstance(Program *program, char **arguments, int argumentCount);
+
+/**
+ * Calls @c function on @c callee in the given instance. Pass the class, obtained with @c emojicodeFindClass, as
+ * @c callee to call a class method and @c NOTHINGNESS to call 🏁. @c arguments must hold as many values as the
+ * function takes.
+ *
+ * Objects in @c result are only valid until the instance is called again.
+ * @returns Whether the call succeeded. If a runtime error occurred the instance can only be destroyed.
+ */
+bool emojicodeCall(Instance *instance, Function *function, Something callee, Something *arguments,
+                   Something *result);
+
+/**
+ * Runs the deinitializers of all objects of the instance and frees it. No thread, including threads started by the
+ * program, must be executing the instance.
+ */
+void emojicodeDestroyInstance(Instance *instance);
+
+/** Returns the message of the last error that occurred on the calling thread. */
+const char* emojicodeLastError(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* EmojicodeEmbedding_h */
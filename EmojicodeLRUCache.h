@@ -0,0 +1,59 @@
+//
+//  EmojicodeLRUCache.h
+//  Emojicode
+//
+
+#ifndef EmojicodeLRUCache_h
+#define EmojicodeLRUCache_h
+
+#include "EmojicodeAPI.h"
+
+/** Marks the end of the recency list and empty slots of the index. */
+#define LRU_CACHE_NONE UINT32_MAX
+
+/** An item of an LRU cache. The items are linked in the order of their last use. */
+typedef struct {
+    Something key;
+    Something value;
+    uint64_t hash;
+    /** The monotonic time in nanoseconds at which the item expires or 0 if it never expires. */
+    uint64_t expiry;
+    /** The entry that was used more recently or @c LRU_CACHE_NONE if this is the most recently used entry. */
+    uint32_t previous;
+    /** The entry that was used less recently or @c LRU_CACHE_NONE if this is the least recently used entry. */
+    uint32_t next;
+} LRUCacheEntry;
+
+/**
+ * Structure for 🎒, a cache with string keys that holds at most @c capacity items and evicts the least recently used
+ * item when it is full. Both arrays are allocated by the initializer, so storing and looking up items never allocates.
+ *
+ * The items are stored in the first @c count entries of @c entries. @c index is an open addressing hash table with
+ * linear probing that maps the keys to the positions of their entries.
+ */
+typedef struct {
+    /** The number of items. */
+    uint32_t count;
+    /** The maximal number of items. */
+    uint32_t capacity;
+    /** The number of slots of @c index. A power of two that is at least twice @c capacity. */
+    uint32_t indexCapacity;
+    /** The most recently used entry or @c LRU_CACHE_NONE if the cache is empty. */
+    uint32_t head;
+    /** The least recently used entry or @c LRU_CACHE_NONE if the cache is empty. */
+    uint32_t tail;
+    Object *entries;
+    Object *index;
+    /** The number of lookups that found an item. */
+    EmojicodeInteger hits;
+    /** The number of lookups that did not find an item or found an expired item. */
+    EmojicodeInteger misses;
+} LRUCache;
+
+/** Marker for LRU caches. */
+void lruCacheMark(Object *self);
+
+FunctionFunctionPointer lruCacheMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer lruCacheInitializerForName(EmojicodeChar name);
+
+#endif /* EmojicodeLRUCache_h */
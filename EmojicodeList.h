@@ -47,6 +47,15 @@ Object* listFromList(List *cpdList);
  */
 bool listRemove(List *list, Something x);
 
+/** Reverses the order of the items of the list in place. */
+void listReverse(List *list);
+
+/**
+ * Returns the index of the first item equal to @c x or -1 if there is none. Strings are compared by their
+ * characters, all other objects by identity.
+ */
+EmojicodeInteger listIndexOf(List *list, Something x);
+
 /**
  * Shuffles the list in place by using the Fisher Yates alogrithm.
  */
@@ -59,6 +68,8 @@ void listRelease(void *l);
 void listMark(Object *self);
 
 FunctionFunctionPointer listMethodForName(EmojicodeChar method);
+/** Returns the type method 🦁 of @c type, which sorts a list of instances of @c type without a comparator. */
+FunctionFunctionPointer listSortMethodForType(EmojicodeChar type);
 InitializerFunctionFunctionPointer listInitializerForName(EmojicodeChar method);
 
 #endif /* EmojicodeList_h */
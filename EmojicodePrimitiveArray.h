@@ -0,0 +1,35 @@
+//
+//  EmojicodePrimitiveArray.h
+//  Emojicode
+//
+
+#ifndef EmojicodePrimitiveArray_h
+#define EmojicodePrimitiveArray_h
+
+#include "EmojicodeAPI.h"
+
+/**
+ * Structure for the arrays of unboxed primitives: 🚃 stores integers, 🛰 doubles, 🙌 booleans and 💾 bytes.
+ * Unlike a list, which stores a @c Something per item, the values are stored contiguously without their type, so the
+ * garbage collector never needs to look at them.
+ */
+typedef struct {
+    /** The number of values in the array. */
+    size_t count;
+    /** The number of values @c values can store. */
+    size_t capacity;
+    /** The array storing the values. Can be @c NULL if @c capacity is 0. */
+    Object *values;
+    /** The type of the values: @c T_INTEGER for integers and bytes, @c T_DOUBLE or @c T_BOOLEAN. */
+    Type valueType;
+    /** The number of bytes per value. Booleans and bytes use one byte. */
+    uint8_t valueSize;
+} PrimitiveArray;
+
+/** Marker for primitive arrays. Only copies the values, which are never objects. */
+void primitiveArrayMark(Object *self);
+
+FunctionFunctionPointer primitiveArrayMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer primitiveArrayInitializerForName(EmojicodeChar cl, EmojicodeChar name);
+
+#endif /* EmojicodePrimitiveArray_h */
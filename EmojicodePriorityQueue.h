@@ -0,0 +1,47 @@
+//
+//  EmojicodePriorityQueue.h
+//  Emojicode
+//
+
+#ifndef EmojicodePriorityQueue_h
+#define EmojicodePriorityQueue_h
+
+#include "EmojicodeAPI.h"
+
+/** How the elements of a priority queue are ordered. */
+typedef enum {
+    /** The queue was created without a comparator and is still empty. The first element determines the order. */
+    PriorityQueueOrderUndetermined,
+    PriorityQueueOrderIntegers,
+    PriorityQueueOrderDoubles,
+    PriorityQueueOrderSymbols,
+    PriorityQueueOrderStrings,
+    /** The elements are ordered by calling @c comparator. */
+    PriorityQueueOrderCallable
+} PriorityQueueOrder;
+
+/**
+ * Structure for 🗻, a priority queue. The elements are stored in a 4-ary min-heap: The children of the element at
+ * index @c i are at the indices @c 4i+1 to @c 4i+4 and no child is smaller than its parent, so the smallest element
+ * is always at index 0. A 4-ary heap is half as deep as a binary heap and the children of an element share a cache
+ * line.
+ */
+typedef struct {
+    /** The number of elements in the queue. */
+    size_t count;
+    /** The number of elements @c items can store. */
+    size_t capacity;
+    /** The array storing the elements in heap order. Can be @c NULL if @c capacity is 0. */
+    Object *items;
+    /** The callable comparing two elements if @c order is @c PriorityQueueOrderCallable, otherwise @c NULL. */
+    Object *comparator;
+    PriorityQueueOrder order;
+} PriorityQueue;
+
+/** Marker for priority queues. */
+void priorityQueueMark(Object *self);
+
+FunctionFunctionPointer priorityQueueMethodForName(EmojicodeChar method);
+InitializerFunctionFunctionPointer priorityQueueInitializerForName(EmojicodeChar name);
+
+#endif /* EmojicodePriorityQueue_h */
@@ -6,7 +6,6 @@
 //  Copyright (c) 2015 Theo Weidmann. All rights reserved.
 //
 
-#include <locale.h>
 #include <string.h>
 #include <limits.h>
 #include <math.h>
@@ -18,36 +17,67 @@
 #include "EmojicodeDictionary.h"
 #include "utf8.h"
 
-Class *CL_OBJECT = NULL;
-Class *CL_STRING;
-Class *CL_LIST;
-Class *CL_ERROR;
-Class *CL_DATA;
-Class *CL_DICTIONARY;
-Class *CL_CAPTURED_FUNCTION_CALL;
-Class *CL_CLOSURE;
-Class *CL_RANGE;
-
 static Class cl_array = {
     NULL, NULL, NULL, 0, 0, NULL, 0, 0, 0, NULL, NULL, 0, 0
 };
 Class *CL_ARRAY = &cl_array;
 
-char **cliArguments;
-int cliArgumentCount;
-
 const char *packageDirectory = defaultPackagesDirectory;
 
 //MARK: Coins
 
-EmojicodeCoin consumeCoin(Thread *thread){
+EmojicodeInstruction consumeInstruction(Thread *thread){
     return *(thread->tokenStream++);
 }
 
-static EmojicodeCoin nextCoin(Thread *thread){
+static EmojicodeInstruction nextInstruction(Thread *thread){
     return *thread->tokenStream;
 }
 
+/** Reads a multi-byte LEB128 value. Kept out of line to keep @c parse small. */
+static __attribute__((noinline)) uint64_t consumeLEB128(Thread *thread){
+    uint64_t value = 0;
+    int shift = 0;
+    Byte b;
+    do {
+        b = *(thread->tokenStream++);
+        value |= (uint64_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b >= 0x80);
+    return value;
+}
+
+/** Reads a coin encoded as unsigned LEB128. Most coins fit into a single byte. */
+static inline EmojicodeCoin consumeCoin(Thread *thread){
+    if (*thread->tokenStream < 0x80) {
+        return *(thread->tokenStream++);
+    }
+    return (EmojicodeCoin)consumeLEB128(thread);
+}
+
+/** Reads a fixed-width coin as used for block lengths and counts. */
+static inline EmojicodeCoin consumeFixedCoin(Thread *thread){
+    Byte *s = thread->tokenStream;
+    thread->tokenStream += 4;
+    return (EmojicodeCoin)s[0] | (EmojicodeCoin)s[1] << 8 | (EmojicodeCoin)s[2] << 16 | (EmojicodeCoin)s[3] << 24;
+}
+
+/** Reads a zigzag encoded LEB128 integer. */
+static inline EmojicodeInteger consumeIntegerCoin(Thread *thread){
+    uint64_t value = *thread->tokenStream < 0x80 ? *(thread->tokenStream++) : consumeLEB128(thread);
+    return (EmojicodeInteger)(value >> 1) ^ -(EmojicodeInteger)(value & 1);
+}
+
+/** Reads a fixed-width 64-bit little endian value. */
+static uint64_t consumeLongCoin(Thread *thread){
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= (uint64_t)thread->tokenStream[i] << (i * 8);
+    }
+    thread->tokenStream += 8;
+    return value;
+}
+
 //MARK: Error
 
 _Noreturn void error(char *err, ...){
@@ -55,18 +85,19 @@ _Noreturn void error(char *err, ...){
     va_start(list, err);
     
     char error[350];
-    vsprintf(error, err, list);
+    vsnprintf(error, sizeof(error), err, list);
+    va_end(list);
     
-    fprintf(stderr, "🚨 Fatal Error: %s\n", error);
+    abortEmbeddedCall(error);
     
-    va_end(list);
+    fprintf(stderr, "🚨 Fatal Error: %s\n", error);
     exit(1);
 }
 
 //MARK: Block utilities
 
 static void passBlock(Thread *thread){
-    EmojicodeCoin length = consumeCoin(thread);
+    EmojicodeCoin length = consumeFixedCoin(thread);
     thread->tokenStream += length; //This coin only contains the length of the block
 }
 
@@ -76,11 +107,11 @@ static void passBlock(Thread *thread){
  * Every other block ran by runBlock will also automatically respond.
  */
 static bool runBlock(Thread *thread){
-    EmojicodeCoin length = consumeCoin(thread); //This token only contains the length of the block
+    EmojicodeCoin length = consumeFixedCoin(thread); //This token only contains the length of the block
     
-    EmojicodeCoin *end = thread->tokenStream + length;
+    Byte *end = thread->tokenStream + length;
     while (thread->tokenStream < end) {
-        parse(consumeCoin(thread), thread);
+        parse(consumeInstruction(thread), thread);
         
         pauseForGC(NULL);
         
@@ -93,11 +124,9 @@ static bool runBlock(Thread *thread){
 }
 
 static Something runFunctionPointerBlock(Thread *thread, uint32_t length){
-    EmojicodeCoin *end = thread->tokenStream + length;
+    Byte *end = thread->tokenStream + length;
     while (thread->tokenStream < end) {
-        EmojicodeCoin c = consumeCoin(thread);
-
-        parse(c, thread);
+        parse(consumeInstruction(thread), thread);
         
         pauseForGC(NULL);
         
@@ -111,14 +140,14 @@ static Something runFunctionPointerBlock(Thread *thread, uint32_t length){
 }
 
 static Class* readClass(Thread *thread) {
-    return parse(consumeCoin(thread), thread).eclass;
+    return parse(consumeInstruction(thread), thread).eclass;
 }
 
 static double readDouble(Thread *thread) {
-    EmojicodeInteger scale = ((EmojicodeInteger)consumeCoin(thread) << 32) ^ consumeCoin(thread);
-    EmojicodeInteger exp = consumeCoin(thread);
-    
-    return ldexp((double)scale/PORTABLE_INTLEAST64_MAX, (int)exp);
+    uint64_t bits = consumeLongCoin(thread);
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return d;
 }
 
 
@@ -134,33 +163,35 @@ bool isRealObject(Something sth){
 
 //MARK: Low level parsing
 
+Something performFunctionWithArguments(Function *method, Something this, Something *args, Thread *thread){
+    Something ret;
+    if (method->native) {
+        Something *t = stackReserveFrame(this, method->argumentCount, thread);
+        memcpy(t, args, method->argumentCount * sizeof(Something));
+        stackPushReservedFrame(thread);
+        ret = method->handler(thread);
+    }
+    else {
+        Something *t = stackReserveFrame(this, method->variableCount, thread);
+        memcpy(t, args, method->argumentCount * sizeof(Something));
+        stackPushReservedFrame(thread);
+        
+        Byte *preCoinStream = thread->tokenStream;
+        
+        thread->tokenStream = method->tokenStream;
+        
+        ret = runFunctionPointerBlock(thread, method->tokenCount);
+        
+        thread->tokenStream = preCoinStream;
+    }
+    stackPop(thread);
+    return ret;
+}
+
 Something executeCallableExtern(Object *callable, Something *args, Thread *thread){
     if (callable->class == CL_CAPTURED_FUNCTION_CALL) {
         CapturedFunctionCall *cmc = callable->value;
-        Function *method = cmc->function;
-        
-        Something ret;
-        if (method->native) {
-            Something *t = stackReserveFrame(cmc->callee, method->argumentCount, thread);
-            memcpy(t, args, method->argumentCount * sizeof(Something));
-            stackPushReservedFrame(thread);
-            ret = method->handler(thread);
-        }
-        else {
-            Something *t = stackReserveFrame(cmc->callee, method->variableCount, thread);
-            memcpy(t, args, method->argumentCount * sizeof(Something));
-            stackPushReservedFrame(thread);
-            
-            EmojicodeCoin *preCoinStream = thread->tokenStream;
-            
-            thread->tokenStream = method->tokenStream;
-            
-            ret = runFunctionPointerBlock(thread, method->tokenCount);
-            
-            thread->tokenStream = preCoinStream;
-        }
-        stackPop(thread);
-        return ret;
+        return performFunctionWithArguments(cmc->function, cmc->callee, args, thread);
     }
     else {
         Closure *c = callable->value;
@@ -174,7 +205,7 @@ Something executeCallableExtern(Object *callable, Something *args, Thread *threa
             stackSetVariable(c->argumentCount + i, cv[i], thread);
         }
         
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
+        Byte *preCoinStream = thread->tokenStream;
         thread->tokenStream = c->tokenStream;
         Something ret = runFunctionPointerBlock(thread, c->coinCount);
         thread->tokenStream = preCoinStream;
@@ -200,13 +231,13 @@ Something performInitializer(Class *class, InitializerFunction *initializer, Obj
     }
     else {
         stackPush(somethingObject(object), initializer->variableCount, initializer->argumentCount, thread);
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
+        Byte *preCoinStream = thread->tokenStream;
         
         thread->tokenStream = initializer->tokenStream;
         
-        EmojicodeCoin *end = thread->tokenStream + initializer->tokenCount;
+        Byte *end = thread->tokenStream + initializer->tokenCount;
         while (thread->tokenStream < end) {
-            parse(consumeCoin(thread), thread);
+            parse(consumeInstruction(thread), thread);
             
             if(thread->returned){
                 thread->tokenStream = preCoinStream;
@@ -232,7 +263,7 @@ Something performFunction(Function *method, Something this, Thread *thread){
     else {
         stackPush(this, method->variableCount, method->argumentCount, thread);
         
-        EmojicodeCoin *preCoinStream = thread->tokenStream;
+        Byte *preCoinStream = thread->tokenStream;
         
         thread->tokenStream = method->tokenStream;
         
@@ -245,22 +276,22 @@ Something performFunction(Function *method, Something this, Thread *thread){
     return ret;
 }
 
-Something parse(EmojicodeCoin coin, Thread *thread){
+Something parse(EmojicodeInstruction coin, Thread *thread){
     switch (coin) {
         case 0x1: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             
             EmojicodeCoin vti = consumeCoin(thread);
             return performFunction(sth.object->class->methodsVtable[vti], sth, thread);
         }
         case 0x2: { //donut – class method
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             
             EmojicodeCoin vti = consumeCoin(thread);
             return performFunction(sth.eclass->methodsVtable[vti], sth, thread);
         }
         case 0x3: {
-            Object *object = parse(consumeCoin(thread), thread).object;
+            Object *object = parse(consumeInstruction(thread), thread).object;
             
             EmojicodeCoin pti = consumeCoin(thread);
             EmojicodeCoin vti = consumeCoin(thread);
@@ -281,7 +312,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return performFunction(class->methodsVtable[vti], stackGetThisContext(thread), thread);
         }
         case 0x6: {
-            Something s = parse(consumeCoin(thread), thread);
+            Something s = parse(consumeInstruction(thread), thread);
             EmojicodeCoin c = consumeCoin(thread);
             return performFunction(functionTable[c], s, thread);
         }
@@ -290,7 +321,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return performFunction(functionTable[c], NOTHINGNESS, thread);
         }
         case 0xE:
-            return somethingClass(parse(consumeCoin(thread), thread).object->class);
+            return somethingClass(parse(consumeInstruction(thread), thread).object->class);
         case 0xF:
             return somethingClass(classTable[consumeCoin(thread)]);
         case 0x10:
@@ -300,10 +331,9 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         case 0x12:
             return EMOJICODE_FALSE;
         case 0x13:
-            return somethingInteger((EmojicodeInteger)(int)consumeCoin(thread));
+            return somethingInteger(consumeIntegerCoin(thread));
         case 0x14: {
-            EmojicodeInteger a = consumeCoin(thread);
-            return somethingInteger(a << 32 | consumeCoin(thread));
+            return somethingInteger((EmojicodeInteger)consumeLongCoin(thread));
         }
         case 0x15:
             return somethingDouble(readDouble(thread));
@@ -321,7 +351,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return stackGetVariable(consumeCoin(thread), thread);
         case 0x1B: {
             EmojicodeCoin index = consumeCoin(thread);
-            stackSetVariable(index, parse(consumeCoin(thread), thread), thread);
+            stackSetVariable(index, parse(consumeInstruction(thread), thread), thread);
             return NOTHINGNESS;
         }
         case 0x1C: {
@@ -330,7 +360,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         }
         case 0x1D: {
             EmojicodeCoin index = consumeCoin(thread);
-            objectSetVariable(stackGetThisObject(thread), index, parse(consumeCoin(thread), thread));
+            objectSetVariable(stackGetThisObject(thread), index, parse(consumeInstruction(thread), thread));
             return NOTHINGNESS;
         }
         case 0x1E: {
@@ -345,80 +375,80 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         }
         //Operators
         case 0x20:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw == parse(consumeCoin(thread), thread).raw);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).raw == parse(consumeInstruction(thread), thread).raw);
         case 0x21: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a - parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a - parse(consumeInstruction(thread), thread).raw);
         }
         case 0x22: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a + parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a + parse(consumeInstruction(thread), thread).raw);
         }
         case 0x23: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a * parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a * parse(consumeInstruction(thread), thread).raw);
         }
         case 0x24: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a / parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a / parse(consumeInstruction(thread), thread).raw);
         }
         case 0x25: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a % parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a % parse(consumeInstruction(thread), thread).raw);
         }
         case 0x26: //Invert
-            return !unwrapBool(parse(consumeCoin(thread), thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+            return !unwrapBool(parse(consumeInstruction(thread), thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
         case 0x27: {
-            Something a = parse(consumeCoin(thread), thread);
-            Something b = parse(consumeCoin(thread), thread);
+            Something a = parse(consumeInstruction(thread), thread);
+            Something b = parse(consumeInstruction(thread), thread);
             return unwrapBool(a) || unwrapBool(b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
         }
         case 0x28: {
-            Something a = parse(consumeCoin(thread), thread);
-            Something b = parse(consumeCoin(thread), thread);
+            Something a = parse(consumeInstruction(thread), thread);
+            Something b = parse(consumeInstruction(thread), thread);
             return unwrapBool(a) && unwrapBool(b) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
         }
         //MARK: Integers
         case 0x29:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw < parse(consumeCoin(thread), thread).raw);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).raw < parse(consumeInstruction(thread), thread).raw);
         case 0x2A:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw > parse(consumeCoin(thread), thread).raw);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).raw > parse(consumeInstruction(thread), thread).raw);
         case 0x2B:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw <= parse(consumeCoin(thread), thread).raw);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).raw <= parse(consumeInstruction(thread), thread).raw);
         case 0x2C:
-            return somethingBoolean(parse(consumeCoin(thread), thread).raw >= parse(consumeCoin(thread), thread).raw);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).raw >= parse(consumeInstruction(thread), thread).raw);
         //MARK: General Comparisons
         case 0x2D:
-            return somethingBoolean(parse(consumeCoin(thread), thread).object == parse(consumeCoin(thread), thread).object);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).object == parse(consumeInstruction(thread), thread).object);
         case 0x2E:
-            return isNothingness(parse(consumeCoin(thread), thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+            return isNothingness(parse(consumeInstruction(thread), thread)) ? EMOJICODE_TRUE : EMOJICODE_FALSE;
         //MARK: Floats
         case 0x2F:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl == parse(consumeCoin(thread), thread).doubl);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).doubl == parse(consumeInstruction(thread), thread).doubl);
         case 0x30:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl - parse(consumeCoin(thread), thread).doubl);
+            return somethingDouble(parse(consumeInstruction(thread), thread).doubl - parse(consumeInstruction(thread), thread).doubl);
         case 0x31:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl + parse(consumeCoin(thread), thread).doubl);
+            return somethingDouble(parse(consumeInstruction(thread), thread).doubl + parse(consumeInstruction(thread), thread).doubl);
         case 0x32:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl * parse(consumeCoin(thread), thread).doubl);
+            return somethingDouble(parse(consumeInstruction(thread), thread).doubl * parse(consumeInstruction(thread), thread).doubl);
         case 0x33:
-            return somethingDouble(parse(consumeCoin(thread), thread).doubl / parse(consumeCoin(thread), thread).doubl);
+            return somethingDouble(parse(consumeInstruction(thread), thread).doubl / parse(consumeInstruction(thread), thread).doubl);
         case 0x34:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl < parse(consumeCoin(thread), thread).doubl);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).doubl < parse(consumeInstruction(thread), thread).doubl);
         case 0x35:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl > parse(consumeCoin(thread), thread).doubl);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).doubl > parse(consumeInstruction(thread), thread).doubl);
         case 0x36:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl <= parse(consumeCoin(thread), thread).doubl);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).doubl <= parse(consumeInstruction(thread), thread).doubl);
         case 0x37:
-            return somethingBoolean(parse(consumeCoin(thread), thread).doubl >= parse(consumeCoin(thread), thread).doubl);
+            return somethingBoolean(parse(consumeInstruction(thread), thread).doubl >= parse(consumeInstruction(thread), thread).doubl);
         case 0x38: {
-            double a = parse(consumeCoin(thread), thread).doubl;
-            double b = parse(consumeCoin(thread), thread).doubl;
+            double a = parse(consumeInstruction(thread), thread).doubl;
+            double b = parse(consumeInstruction(thread), thread).doubl;
             return somethingDouble(fmod(a, b));
         }
         //MARK: Optionals
         case 0x3A: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             
             if(isNothingness(sth)){
                 error("Unexpectedly found ✨ while unwrapping a 🍬.");
@@ -427,9 +457,9 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return sth;
         }
         case 0x3B: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             EmojicodeCoin vti = consumeCoin(thread);
-            EmojicodeCoin count = consumeCoin(thread);
+            EmojicodeCoin count = consumeFixedCoin(thread);
             if(isNothingness(sth)){
                 thread->tokenStream += count;
                 return NOTHINGNESS;
@@ -454,7 +484,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         }
         case 0x3E: {
             EmojicodeCoin index = consumeCoin(thread);
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             if (isNothingness(sth)) {
                 return EMOJICODE_FALSE;
             }
@@ -465,10 +495,10 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         }
         //MARK: Int To Double
         case 0x3F:
-            return somethingDouble((double) parse(consumeCoin(thread), thread).raw);
+            return somethingDouble((double) parse(consumeInstruction(thread), thread).raw);
         //MARK: Casts
         case 0x40: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             Class *class = readClass(thread);
             if(sth.type == T_OBJECT && instanceof(sth.object, class)){
                 return sth;
@@ -477,7 +507,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x41: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             EmojicodeCoin pi = consumeCoin(thread);
             if(sth.type == T_OBJECT && conformsTo(sth.object->class, pi)){
                 return sth;
@@ -486,7 +516,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x42: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             if(sth.type == T_BOOLEAN){
                 return sth;
             }
@@ -494,7 +524,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x43: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             if(sth.type == T_INTEGER){
                 return sth;
             }
@@ -502,7 +532,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x44: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             Class *class = readClass(thread);
             if(sth.type == T_OBJECT && !isNothingness(sth) && instanceof(sth.object, class)){
                 return sth;
@@ -511,7 +541,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x45: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             EmojicodeCoin pi = consumeCoin(thread);
             if(sth.type == T_OBJECT && !isNothingness(sth) && conformsTo(sth.object->class, pi)){
                 return sth;
@@ -520,7 +550,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x46: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             if(sth.type == T_SYMBOL){
                 return sth;
             }
@@ -528,7 +558,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x47: {
-            Something sth = parse(consumeCoin(thread), thread);
+            Something sth = parse(consumeInstruction(thread), thread);
             if(sth.type == T_DOUBLE){
                 return sth;
             }
@@ -540,10 +570,11 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             stackPush(somethingObject(newObject(CL_DICTIONARY)), 0, 0, thread);
             dictionaryInit(thread);
             
-            EmojicodeCoin *end = thread->tokenStream + consumeCoin(thread);
+            EmojicodeCoin length = consumeFixedCoin(thread);
+            Byte *end = thread->tokenStream + length;
             while (thread->tokenStream < end) {
-                Object *key = parse(consumeCoin(thread), thread).object;
-                Something sth = parse(consumeCoin(thread), thread);
+                Something key = parse(consumeInstruction(thread), thread);
+                Something sth = parse(consumeInstruction(thread), thread);
                 
                 dictionarySet(stackGetThisObject(thread), key, sth, thread);
             }
@@ -555,9 +586,10 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         case 0x51: {
             stackPush(somethingObject(newObject(CL_LIST)), 0, 0, thread);
             
-            EmojicodeCoin *end = thread->tokenStream + consumeCoin(thread);
+            EmojicodeCoin length = consumeFixedCoin(thread);
+            Byte *end = thread->tokenStream + length;
             while (thread->tokenStream < end) {
-                listAppend(stackGetThisObject(thread), parse(consumeCoin(thread), thread), thread);
+                listAppend(stackGetThisObject(thread), parse(consumeInstruction(thread), thread), thread);
             }
             
             Something sth = stackGetThisContext(thread);
@@ -565,16 +597,20 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return sth;
         }
         case 0x52: {
-            EmojicodeCoin stringCount = consumeCoin(thread);
+            EmojicodeCoin stringCount = consumeFixedCoin(thread);
             Something *t = stackReserveFrame(NOTHINGNESS, stringCount + 1, thread);
             
             EmojicodeInteger length = 0;
+            uint8_t width = 1;
             
             for (EmojicodeCoin i = 0; i < stringCount; i++) {
-                Something sm = parse(consumeCoin(thread), thread);
+                Something sm = parse(consumeInstruction(thread), thread);
                 t[i] = sm;
                 String *string = sm.object->value;
                 length += string->length;
+                if (string->width > width) {
+                    width = string->width;
+                }
             }
             
             stackPushReservedFrame(thread);
@@ -583,30 +619,29 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             
             stackSetVariable(stringCount, somethingObject(object), thread);
             
-            Object *characters = newArray(length * sizeof(EmojicodeChar));
-            EmojicodeChar *chars = characters->value;
-            EmojicodeChar *writeChars = chars;
+            Object *characters = newArray(length * width);
             
             Something sm = stackGetVariable(stringCount, thread);
             String *string = sm.object->value;
+            string->length = length;
+            string->characters = characters;
+            string->width = width;
             
+            EmojicodeInteger writeIndex = 0;
             for (int i = 0; i < stringCount; i++) {
                 Object *o = stackGetVariable(i, thread).object;
-                String *string = o->value;
-                memcpy(writeChars, string->characters->value, string->length * sizeof(EmojicodeChar));
-                writeChars += string->length;
+                String *part = o->value;
+                stringCopyCharacters(string, writeIndex, part, 0, part->length);
+                writeIndex += part->length;
             }
             
-            string->length = length;
-            string->characters = characters;
-            
             stackPop(thread);
             
             return sm;
         }
         case 0x53: {
-            EmojicodeInteger start = parse(consumeCoin(thread), thread).raw;
-            EmojicodeInteger stop = parse(consumeCoin(thread), thread).raw;
+            EmojicodeInteger start = parse(consumeInstruction(thread), thread).raw;
+            EmojicodeInteger stop = parse(consumeInstruction(thread), thread).raw;
             Object *object = newObject(CL_RANGE);
             EmojicodeRange *range = object->value;
             range->start = start;
@@ -615,9 +650,9 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return somethingObject(object);
         }
         case 0x54: {
-            EmojicodeInteger start = parse(consumeCoin(thread), thread).raw;
-            EmojicodeInteger stop = parse(consumeCoin(thread), thread).raw;
-            EmojicodeInteger step = parse(consumeCoin(thread), thread).raw;
+            EmojicodeInteger start = parse(consumeInstruction(thread), thread).raw;
+            EmojicodeInteger stop = parse(consumeInstruction(thread), thread).raw;
+            EmojicodeInteger step = parse(consumeInstruction(thread), thread).raw;
             Object *object = newObject(CL_RANGE);
             EmojicodeRange *range = object->value;
             range->start = start;
@@ -628,30 +663,30 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         }
         //MARK: Binary Operations
         case 0x5A:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw & parse(consumeCoin(thread), thread).raw);
+            return somethingInteger(parse(consumeInstruction(thread), thread).raw & parse(consumeInstruction(thread), thread).raw);
         case 0x5B:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw | parse(consumeCoin(thread), thread).raw);
+            return somethingInteger(parse(consumeInstruction(thread), thread).raw | parse(consumeInstruction(thread), thread).raw);
         case 0x5C:
-            return somethingInteger(parse(consumeCoin(thread), thread).raw ^ parse(consumeCoin(thread), thread).raw);
+            return somethingInteger(parse(consumeInstruction(thread), thread).raw ^ parse(consumeInstruction(thread), thread).raw);
         case 0x5D:
-            return somethingInteger(~parse(consumeCoin(thread), thread).raw);
+            return somethingInteger(~parse(consumeInstruction(thread), thread).raw);
         case 0x5E: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a << parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a << parse(consumeInstruction(thread), thread).raw);
         }
         case 0x5F: {
-            EmojicodeInteger a = parse(consumeCoin(thread), thread).raw;
-            return somethingInteger(a >> parse(consumeCoin(thread), thread).raw);
+            EmojicodeInteger a = parse(consumeInstruction(thread), thread).raw;
+            return somethingInteger(a >> parse(consumeInstruction(thread), thread).raw);
         }
         //MARK: Flow Control
         case 0x60: { //Red apple - return
-            thread->returnValue = parse(consumeCoin(thread), thread);
+            thread->returnValue = parse(consumeInstruction(thread), thread);
             thread->returned = true;
             return NOTHINGNESS;
         }
         case 0x61: { //MARK: cherries
-            EmojicodeCoin *beginPosition = thread->tokenStream;
-            while (unwrapBool(parse(consumeCoin(thread), thread))) {
+            Byte *beginPosition = thread->tokenStream;
+            while (unwrapBool(parse(consumeInstruction(thread), thread))) {
                 if (runBlock(thread)) {
                     return NOTHINGNESS;
                 }
@@ -661,10 +696,10 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return NOTHINGNESS;
         }
         case 0x62: { //MARK: If
-            EmojicodeCoin length = consumeCoin(thread);
-            EmojicodeCoin *ifEnd = thread->tokenStream + length;
+            EmojicodeCoin length = consumeFixedCoin(thread);
+            Byte *ifEnd = thread->tokenStream + length;
             
-            Something boolSth = parse(consumeCoin(thread), thread);
+            Something boolSth = parse(consumeInstruction(thread), thread);
             if (unwrapBool(boolSth)) {  // Main if
                 if (runBlock(thread)) {
                     return NOTHINGNESS;
@@ -674,10 +709,10 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             else {
                 passBlock(thread);
                 
-                while (thread->tokenStream < ifEnd && nextCoin(thread) == 0x63) {  // All else ifs
-                    consumeCoin(thread);
+                while (thread->tokenStream < ifEnd && nextInstruction(thread) == 0x63) {  // All else ifs
+                    consumeInstruction(thread);
                     
-                    boolSth = parse(consumeCoin(thread), thread);
+                    boolSth = parse(consumeInstruction(thread), thread);
                     if (unwrapBool(boolSth)) {
                         if (runBlock(thread)) {
                             return NOTHINGNESS;
@@ -702,7 +737,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             //The destination variable
             EmojicodeCoin variable = consumeCoin(thread);
             
-            Something iteratee = parse(consumeCoin(thread), thread);
+            Something iteratee = parse(consumeInstruction(thread), thread);
             
             Something enumerator = performFunction(iteratee.object->class->protocolsTable[1 - iteratee.object->class->protocolsOffset][0], iteratee, thread);
             EmojicodeCoin enumeratorVindex = consumeCoin(thread);
@@ -711,7 +746,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             Function *nextMethod = enumerator.object->class->protocolsTable[0][0];
             Function *moreComing = enumerator.object->class->protocolsTable[0][1];
             
-            EmojicodeCoin *begin = thread->tokenStream;
+            Byte *begin = thread->tokenStream;
             
             while (unwrapBool(performFunction(moreComing, stackGetVariable(enumeratorVindex, thread), thread))) {
                 stackSetVariable(variable, performFunction(nextMethod, stackGetVariable(enumeratorVindex, thread), thread), thread);
@@ -730,13 +765,13 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             EmojicodeCoin variable = consumeCoin(thread);
             
             //Get the list
-            Something losm = parse(consumeCoin(thread), thread);
+            Something losm = parse(consumeInstruction(thread), thread);
             
             EmojicodeCoin listObjectVariable = consumeCoin(thread);
             stackSetVariable(listObjectVariable, losm, thread);
             List *list = losm.object->value;
             
-            EmojicodeCoin *begin = thread->tokenStream;
+            Byte *begin = thread->tokenStream;
             
             for (size_t i = 0; i < (list = stackGetVariable(listObjectVariable, thread).object->value)->count; i++) {
                 stackSetVariable(variable, listGet(list, i), thread);
@@ -752,8 +787,8 @@ Something parse(EmojicodeCoin coin, Thread *thread){
         }
         case 0x66: {
             EmojicodeCoin variable = consumeCoin(thread);
-            EmojicodeRange range = *(EmojicodeRange *)parse(consumeCoin(thread), thread).object->value;
-            EmojicodeCoin *begin = thread->tokenStream;
+            EmojicodeRange range = *(EmojicodeRange *)parse(consumeInstruction(thread), thread).object->value;
+            Byte *begin = thread->tokenStream;
             for (EmojicodeInteger i = range.start; i != range.stop; i += range.step) {
                 stackSetVariable(variable, somethingInteger(i), thread);
                 
@@ -766,8 +801,85 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             
             return NOTHINGNESS;
         }
+        case 0x67: { //MARK: foreach for strings
+            EmojicodeCoin variable = consumeCoin(thread);
+            
+            Something ssm = parse(consumeInstruction(thread), thread);
+            
+            EmojicodeCoin stringObjectVariable = consumeCoin(thread);
+            stackSetVariable(stringObjectVariable, ssm, thread);
+            String *string = ssm.object->value;
+            
+            Byte *begin = thread->tokenStream;
+            
+            for (EmojicodeInteger i = 0; i < (string = stackGetVariable(stringObjectVariable, thread).object->value)->length; i++) {
+                stackSetVariable(variable, somethingSymbol(stringCharacter(string, i)), thread);
+                
+                if(runBlock(thread)){
+                    return NOTHINGNESS;
+                }
+                thread->tokenStream = begin;
+            }
+            passBlock(thread);
+            
+            return NOTHINGNESS;
+        }
+        case 0x68: { //MARK: foreach for data
+            EmojicodeCoin variable = consumeCoin(thread);
+            
+            Something dsm = parse(consumeInstruction(thread), thread);
+            
+            EmojicodeCoin dataObjectVariable = consumeCoin(thread);
+            stackSetVariable(dataObjectVariable, dsm, thread);
+            Data *data = dsm.object->value;
+            
+            Byte *begin = thread->tokenStream;
+            
+            for (EmojicodeInteger i = 0; i < (data = stackGetVariable(dataObjectVariable, thread).object->value)->length; i++) {
+                stackSetVariable(variable, somethingInteger(data->bytes[i]), thread);
+                
+                if(runBlock(thread)){
+                    return NOTHINGNESS;
+                }
+                thread->tokenStream = begin;
+            }
+            passBlock(thread);
+            
+            return NOTHINGNESS;
+        }
+        case 0x69:
+        case 0x6A: { //MARK: foreach for dictionaries
+            //The destination variables, 0x6A also assigns the values
+            EmojicodeCoin keyVariable = consumeCoin(thread);
+            EmojicodeCoin valueVariable = coin == 0x6A ? consumeCoin(thread) : 0;
+            
+            Something dsm = parse(consumeInstruction(thread), thread);
+            
+            EmojicodeCoin dictionaryObjectVariable = consumeCoin(thread);
+            stackSetVariable(dictionaryObjectVariable, dsm, thread);
+            
+            Byte *begin = thread->tokenStream;
+            
+            Something key, value;
+            size_t slot = 0;
+            while (dictionaryNextItem(stackGetVariable(dictionaryObjectVariable, thread).object->value, &slot,
+                                      &key, coin == 0x6A ? &value : NULL)) {
+                stackSetVariable(keyVariable, key, thread);
+                if (coin == 0x6A) {
+                    stackSetVariable(valueVariable, value, thread);
+                }
+                
+                if(runBlock(thread)){
+                    return NOTHINGNESS;
+                }
+                thread->tokenStream = begin;
+            }
+            passBlock(thread);
+            
+            return NOTHINGNESS;
+        }
         case 0x70: {
-            Object *callable = parse(consumeCoin(thread), thread).object;
+            Object *callable = parse(consumeInstruction(thread), thread).object;
             if (callable->class == CL_CAPTURED_FUNCTION_CALL) {
                 CapturedFunctionCall *cmc = callable->value;
                 return performFunction(cmc->function, cmc->callee, thread);
@@ -781,7 +893,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
                     stackSetVariable(c->argumentCount + i, cv[i], thread);
                 }
                 
-                EmojicodeCoin *preCoinStream = thread->tokenStream;
+                Byte *preCoinStream = thread->tokenStream;
                 thread->tokenStream = c->tokenStream;
                 Something ret = runFunctionPointerBlock(thread, c->coinCount);
                 thread->tokenStream = preCoinStream;
@@ -797,21 +909,24 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             Object *co = stackGetVariable(0, thread).object;
             Closure *c = co->value;
             
-            c->variableCount = consumeCoin(thread);
-            c->coinCount = consumeCoin(thread);
+            c->variableCount = consumeFixedCoin(thread);
+            c->coinCount = consumeFixedCoin(thread);
             c->tokenStream = thread->tokenStream;
             thread->tokenStream += c->coinCount;
             
             EmojicodeCoin argumentCount = consumeCoin(thread);
             c->argumentCount = argumentCount;
-            
-            stackPop(thread);
-            
             c->capturedVariablesCount = consumeCoin(thread);
             
             Object *capturedVariables = newArray(sizeof(Something) * c->capturedVariablesCount);
+            
+            // The closure might have been moved by the garbage collector
+            co = stackGetVariable(0, thread).object;
+            c = co->value;
             c->capturedVariables = capturedVariables;
             
+            stackPop(thread);
+            
             Something *t = capturedVariables->value;
             for (uint_fast8_t i = 0; i < c->capturedVariablesCount; i++) {
                 t[i] = stackGetVariable(i, thread);
@@ -823,7 +938,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return somethingObject(co);
         }
         case 0x72: {
-            stackPush(parse(consumeCoin(thread), thread), 0, 0, thread);
+            stackPush(parse(consumeInstruction(thread), thread), 0, 0, thread);
             Object *cmco = newObject(CL_CAPTURED_FUNCTION_CALL);
             CapturedFunctionCall *cmc = cmco->value;
             
@@ -834,7 +949,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return somethingObject(cmco);
         }
         case 0x73: {
-            stackPush(parse(consumeCoin(thread), thread), 0, 0, thread);
+            stackPush(parse(consumeInstruction(thread), thread), 0, 0, thread);
             Object *cmco = newObject(CL_CAPTURED_FUNCTION_CALL);
             CapturedFunctionCall *cmc = cmco->value;
             
@@ -845,7 +960,7 @@ Something parse(EmojicodeCoin coin, Thread *thread){
             return somethingObject(cmco);
         }
         case 0x74: {
-            stackPush(parse(consumeCoin(thread), thread), 0, 0, thread);
+            stackPush(parse(consumeInstruction(thread), thread), 0, 0, thread);
             Object *cmco = newObject(CL_CAPTURED_FUNCTION_CALL);
             CapturedFunctionCall *cmc = cmco->value;
             
@@ -858,29 +973,3 @@ Something parse(EmojicodeCoin coin, Thread *thread){
     }
     return NOTHINGNESS;
 }
-
-int main(int argc, char *argv[]) {
-    cliArgumentCount = argc;
-    cliArguments = argv;
-    const char *ppath;
-    if ((ppath = getenv("EMOJICODE_PACKAGES_PATH"))) {
-        packageDirectory = ppath;
-    }
-    
-    setlocale(LC_CTYPE, "de_DE.UTF-8");
-    if (argc < 2){
-       error("No file provided.");
-    }
-    
-    FILE *f = fopen(argv[1], "rb");
-    if (!f || ferror(f)){
-       error("File couldn't be opened.");
-    }
-    
-    Thread *mainThread = allocateThread();
-    
-    allocateHeap();
-    
-    Function *handler = readBytecode(f);
-    return (int)performFunction(handler, NOTHINGNESS, mainThread).raw;
-}
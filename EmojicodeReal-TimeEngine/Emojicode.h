@@ -12,6 +12,9 @@
 #define _GNU_SOURCE
 #include "EmojicodeAPI.h"
 
+typedef struct Program Program;
+typedef struct Instance Instance;
+
 //MARK: Stack
 
 struct StackFrame {
@@ -42,7 +45,7 @@ void stackMark(Thread *);
 void gc();
 
 struct Thread {
-    EmojicodeCoin *tokenStream;
+    Byte *tokenStream;
     Something returnValue;
     bool returned;
     
@@ -51,35 +54,117 @@ struct Thread {
     Byte *stack;
     Byte *futureStack;
     
+    /** The instance this thread belongs to. */
+    Instance *instance;
     Thread *threadBefore;
     Thread *threadAfter;
 };
 
-extern Thread *lastThread;
-extern int threads;
-
 //MARK: VM
 
-Byte *currentHeap;
-Byte *otherHeap;
-void allocateHeap(void);
-
 #ifndef heapSize
 #define heapSize (512 * 1000 * 1000) //512 MB
 #endif
 
-/** The class table */
-Class **classTable;
-Function **functionTable;
+#ifndef arraySliceCompactionSize
+/** Arrays of at least this many bytes of which less than an eighth is used are trimmed, see @c markArraySlice. */
+#define arraySliceCompactionSize 4096 //0 disables trimming
+#endif
 
-uint_fast16_t stringPoolCount;
-Object **stringPool;
+typedef struct {
+    EmojicodeChar typeName;
+    EmojicodeChar name;
+    Function *function;
+} NamedFunction;
+
+/**
+ * A program loaded from a bytecode file or snapshot. Its classes, functions and string pool are never modified after
+ * loading and are shared by all instances of the program.
+ */
+struct Program {
+    Class **classTable;
+    uint_fast16_t classTableCount;
+    Function **functionTable;
+    uint_fast16_t functionTableCount;
+    Object **stringPool;
+    uint_fast16_t stringPoolCount;
+    
+    /** The function with the chequered flag. */
+    Function *main;
+    
+    /** The functions by the name of their type and their own name, only available if loaded from bytecode. */
+    NamedFunction *namedFunctions;
+    size_t namedFunctionCount;
+};
+
+/** An instance of a program. Every instance has its own heap and threads. */
+struct Instance {
+    Program *program;
+    
+    Byte *currentHeap;
+    Byte *otherHeap;
+    /** The number of bytes allocated in @c currentHeap. */
+    size_t memoryUse;
+    bool zeroingNeeded;
+    
+    Thread *lastThread;
+    int threads;
+    pthread_mutex_t threadListMutex;
+    
+    int pausingThreadsCount;
+    bool pauseThreads;
+    pthread_mutex_t pausingThreadsCountMutex;
+    pthread_mutex_t allocationMutex;
+    pthread_cond_t pauseThreadsFalsedCondition;
+    pthread_cond_t threadsCountCondition;
+    
+    char **cliArguments;
+    int cliArgumentCount;
+    
+    /** The interned strings in an open-addressing table, see @c stringIntern. The table holds weak references. */
+    Object **internTable;
+    size_t internTableCapacity;
+    size_t internTableCount;
+    pthread_mutex_t internTableMutex;
+    
+    /** Whether a runtime error occurred while the instance was called through the embedding API. */
+    bool failed;
+};
+
+/** The instance executed by the calling thread. */
+extern _Thread_local Instance *currentInstance;
+
+/**
+ * The tables of the program executed by the calling thread. They are set by @c enterInstance and, while a program is
+ * loaded, point to the tables being read.
+ */
+extern _Thread_local uint_fast16_t classTableCount;
+extern _Thread_local Function **functionTable;
+extern _Thread_local uint_fast16_t functionTableCount;
+extern _Thread_local Object **stringPool;
+extern _Thread_local uint_fast16_t stringPoolCount;
+
+/** Allocates an empty program. */
+Program* newProgram(void);
+/** Stores the tables of the calling thread, which were just read, and the given main function in the program. */
+void programSetTables(Program *program, Function *main);
+/** Records the name of a function so that it can be looked up by embedders. */
+void programAddNamedFunction(Program *program, EmojicodeChar typeName, EmojicodeChar name, Function *function);
+
+/** Creates a new instance of the program and allocates its heap. */
+Instance* newInstance(Program *program, char **arguments, int argumentCount);
+/** Makes the calling thread execute the given instance. */
+void enterInstance(Instance *instance);
 
 /** Whether the given pointer points into the heap. */
 extern bool isPossibleObjectPointer(void *);
-
-extern char **cliArguments;
-extern int cliArgumentCount;
+/**
+ * Updates the weak reference @c oPointer once all objects were marked. Must only be called during garbage collection.
+ * @returns False if the object is garbage, in which case the reference must be dropped.
+ */
+extern bool gcUpdateWeakReference(Object **oPointer);
+/** Removes the strings that were not marked from the intern table of @c instance. Called by the GC. */
+void stringInternTableSweep(Instance *instance);
 
 //MARK: Classes
 
@@ -107,6 +192,9 @@ struct Class {
     
     size_t size;
     size_t valueSize;
+    
+    /** The name of the class. */
+    EmojicodeChar name;
 };
 
 struct Function {
@@ -122,7 +210,7 @@ struct Function {
         FunctionFunctionPointer handler;
         struct {
             /** The method’s token stream */
-            EmojicodeCoin *tokenStream;
+            Byte *tokenStream;
             /** The number of tokens */
             uint32_t tokenCount;
         };
@@ -142,7 +230,7 @@ struct InitializerFunction {
         InitializerFunctionFunctionPointer handler;
         struct {
             /** The initializer’s token stream */
-            EmojicodeCoin *tokenStream;
+            Byte *tokenStream;
             /** The number of tokens */
             uint32_t tokenCount;
         };
@@ -155,7 +243,7 @@ typedef struct {
 } CapturedFunctionCall;
 
 typedef struct {
-    EmojicodeCoin *tokenStream;
+    Byte *tokenStream;
     uint32_t coinCount;
     uint8_t argumentCount;
     uint8_t capturedVariablesCount;
@@ -166,14 +254,27 @@ typedef struct {
 
 //MARK: Parsing
 
-EmojicodeCoin consumeCoin(Thread *thread);
+/** Reads the next instruction from the thread’s token stream. */
+EmojicodeInstruction consumeInstruction(Thread *thread);
 
 /** Parse a token */
-Something parse(EmojicodeCoin coin, Thread *);
+Something parse(EmojicodeInstruction coin, Thread *);
+
+/** Performs the function with the arguments parsed from the thread’s token stream. */
+Something performFunction(Function *method, Something this, Thread *thread);
+
+/** Performs the function with the given arguments, which must be as many as the function takes. */
+Something performFunctionWithArguments(Function *method, Something this, Something *args, Thread *thread);
 
 /** Throw a runtime error */
 _Noreturn void error(char *err, ...);
 
+/**
+ * Aborts the call made through the embedding API on the calling thread, if any, with the given error message.
+ * Returns if the thread is not executing such a call.
+ */
+void abortEmbeddedCall(const char *message);
+
 
 //MARK: Object
 
@@ -184,11 +285,59 @@ void objectSetVariable(Object *o, uint8_t index, Something value);
 void objectDecrementVariable(Object *o, uint8_t index);
 void objectIncrementVariable(Object *o, uint8_t index);
 
+/**
+ * Allocates zeroed memory in the immortal region. The immortal region holds everything created while loading the
+ * program: classes, function tables, token streams and the string pool. It is never collected and objects in it never
+ * move. The garbage collector recognizes them as they are not located in the heap.
+ */
+void* immortalAllocate(size_t size);
+/** Allocates an object in the immortal region. */
+Object* newImmortalObject(Class *class);
+/** Allocates an array in the immortal region. */
+Object* newImmortalArray(size_t size);
+/** Makes everything allocated in the immortal region so far read-only. */
+void sealImmortalRegion(void);
+
 
 //MARK: Reading bytecode file
 
-/** Reads all classes from the given bytecode file. Returns the class with the chequered flag. */
-Function* readBytecode(FILE *in);
+/** Reads all classes and functions from the given bytecode file. */
+Program* readBytecode(FILE *in);
+
+//MARK: Snapshots
+
+/**
+ * Makes the reader record the information needed to write a snapshot. Must be called before @c readBytecode.
+ */
+void snapshotBeginRecording(void);
+
+/** Records that the following classes and functions belong to the given package. Pass @c NULL for built-in ones. */
+void snapshotRecordPackage(const char *name, uint16_t major, uint16_t minor);
+void snapshotRecordClass(Class *class, EmojicodeChar name);
+void snapshotRecordNativeFunction(Function *function, EmojicodeChar className, EmojicodeChar name, MethodType type);
+void snapshotRecordNativeInitializer(InitializerFunction *initializer, EmojicodeChar className, EmojicodeChar name);
+void snapshotRecordProtocolAgreement(Function **table, uint16_t count);
+
+/** Writes an image of the loaded program, which can be started with @c readSnapshot. */
+void writeSnapshot(FILE *out);
+
+/** Whether the given file is a snapshot image. */
+bool isSnapshot(FILE *in);
+
+/** Loads the given snapshot image. */
+Program* readSnapshot(FILE *in);
+
+//MARK: Prefork
+
+/** The index of this worker process or -1 if the process is not a preforked worker. */
+extern EmojicodeInteger workerIndex;
+
+/**
+ * Forks @c count worker processes that share the loaded program and heap copy-on-write and returns the worker index
+ * in each of them. The calling process becomes the supervisor: it restarts workers that exit, forwards SIGTERM, SIGINT
+ * and SIGHUP to the workers and exits once they terminated. It never returns.
+ */
+EmojicodeInteger preforkWorkers(EmojicodeInteger count);
 
 
 //MARK: Packages
@@ -207,6 +356,10 @@ typedef uint_fast32_t (*SizeForClassFunction)(Class *cl, EmojicodeChar name);
 
 char* packageError(void);
 
+PackageLoadingState packageLoad(const char *name, uint16_t major, uint16_t minor, FunctionFunctionPointerProvider *hfpMethods,
+                                InitializerFunctionFunctionPointerProvider *hfpIntializer,
+                                mpfc *mpfc, dpfc *dpfc, SizeForClassFunction *sfch);
+
 FunctionFunctionPointer handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar symbol, MethodType);
 InitializerFunctionFunctionPointer handlerPointerForInitializer(EmojicodeChar cl, EmojicodeChar symbol);
 Marker markerPointerForClass(EmojicodeChar cl);
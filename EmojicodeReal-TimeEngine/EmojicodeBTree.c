@@ -0,0 +1,608 @@
+//
+//  EmojicodeBTree.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeBTree.h"
+#include "EmojicodeList.h"
+#include "EmojicodeString.h"
+
+#include <string.h>
+
+/** Every node but the root has at least @c BTREE_DEGREE - 1 and at most 2 * @c BTREE_DEGREE - 1 keys. */
+#define BTREE_DEGREE 16
+#define BTREE_MAX_KEYS (2 * BTREE_DEGREE - 1)
+/** The number of nodes removed by merging that are kept for later splits. */
+#define BTREE_MAX_SPARE_NODES 8
+
+typedef struct {
+    /** The number of keys in this node. */
+    uint8_t count;
+    /** Whether this node has no children. */
+    bool leaf;
+    /** The number of keys in this node and all its descendants. */
+    size_t size;
+    Something keys[BTREE_MAX_KEYS];
+    Something values[BTREE_MAX_KEYS];
+    /** The children of an inner node. The keys of @c children[i] are between @c keys[i - 1] and @c keys[i]. */
+    Object *children[BTREE_MAX_KEYS + 1];
+} BTreeNode;
+
+#define node(object) ((BTreeNode *)(object)->value)
+
+static inline BTree* thisTree(Thread *thread){
+    return stackGetThisObject(thread)->value;
+}
+
+static inline int btreeCompare(BTree *tree, Something a, Something b){
+    if (tree->keyType == T_INTEGER) {
+        return (a.raw > b.raw) - (a.raw < b.raw);
+    }
+    EmojicodeInteger c = stringCompare(a.object->value, b.object->value);
+    return (c > 0) - (c < 0);
+}
+
+/** Returns the index of the first key of @c n that is not less than @c key. */
+static inline uint8_t btreeLowerBound(BTree *tree, BTreeNode *n, Something key){
+    uint8_t lo = 0, hi = n->count;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (btreeCompare(tree, n->keys[mid], key) < 0) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static inline bool btreeKeyAt(BTree *tree, BTreeNode *n, uint8_t i, Something key){
+    return i < n->count && btreeCompare(tree, n->keys[i], key) == 0;
+}
+
+//MARK: Marking
+
+static void btreeMarkNode(Object **nodeObject){
+    mark(nodeObject);
+    BTreeNode *n = node(*nodeObject);
+    for (uint8_t i = 0; i < n->count; i++) {
+        if (isRealObject(n->keys[i])) {
+            mark(&n->keys[i].object);
+        }
+        if (isRealObject(n->values[i])) {
+            mark(&n->values[i].object);
+        }
+    }
+    if (!n->leaf) {
+        for (uint8_t i = 0; i <= n->count; i++) {
+            btreeMarkNode(&n->children[i]);
+        }
+    }
+}
+
+void btreeMark(Object *self){
+    BTree *tree = self->value;
+    if (tree->root) {
+        btreeMarkNode(&tree->root);
+    }
+    for (Object **spare = &tree->spareNodes; *spare; spare = &node(*spare)->children[0]) {
+        mark(spare);
+    }
+}
+
+//MARK: Nodes
+
+/**
+ * Allocates spare nodes until a node on every level and a new root could be created.
+ * @warning GC-invoking
+ */
+static BTree* btreeReserveSpareNodes(Thread *thread){
+    BTree *tree = thisTree(thread);
+    size_t needed = 1;
+    for (Object *o = tree->root; o; o = node(o)->leaf ? NULL : node(o)->children[0]) {
+        needed++;
+    }
+    while (tree->spareCount < needed) {
+        Object *spare = newArray(sizeof(BTreeNode));
+        tree = thisTree(thread);
+        node(spare)->children[0] = tree->spareNodes;
+        tree->spareNodes = spare;
+        tree->spareCount++;
+    }
+    return tree;
+}
+
+static Object* btreeTakeSpareNode(BTree *tree, bool leaf){
+    Object *o = tree->spareNodes;
+    BTreeNode *n = node(o);
+    tree->spareNodes = n->children[0];
+    tree->spareCount--;
+    n->count = 0;
+    n->leaf = leaf;
+    n->size = 0;
+    return o;
+}
+
+static void btreeReleaseNode(BTree *tree, Object *o){
+    if (tree->spareCount >= BTREE_MAX_SPARE_NODES) {
+        return;
+    }
+    node(o)->count = 0;
+    node(o)->children[0] = tree->spareNodes;
+    tree->spareNodes = o;
+    tree->spareCount++;
+}
+
+static inline void btreeInsertAt(BTreeNode *n, uint8_t i, Something key, Something value){
+    memmove(n->keys + i + 1, n->keys + i, (n->count - i) * sizeof(Something));
+    memmove(n->values + i + 1, n->values + i, (n->count - i) * sizeof(Something));
+    n->keys[i] = key;
+    n->values[i] = value;
+    n->count++;
+}
+
+static inline void btreeRemoveAt(BTreeNode *n, uint8_t i){
+    n->count--;
+    memmove(n->keys + i, n->keys + i + 1, (n->count - i) * sizeof(Something));
+    memmove(n->values + i, n->values + i + 1, (n->count - i) * sizeof(Something));
+}
+
+/** Splits the full child @c i of @c parent, which must not be full, into two nodes. Takes a spare node. */
+static void btreeSplitChild(BTree *tree, BTreeNode *parent, uint8_t i){
+    BTreeNode *left = node(parent->children[i]);
+    Object *rightObject = btreeTakeSpareNode(tree, left->leaf);
+    BTreeNode *right = node(rightObject);
+    
+    right->count = BTREE_DEGREE - 1;
+    right->size = BTREE_DEGREE - 1;
+    memcpy(right->keys, left->keys + BTREE_DEGREE, (BTREE_DEGREE - 1) * sizeof(Something));
+    memcpy(right->values, left->values + BTREE_DEGREE, (BTREE_DEGREE - 1) * sizeof(Something));
+    if (!left->leaf) {
+        memcpy(right->children, left->children + BTREE_DEGREE, BTREE_DEGREE * sizeof(Object *));
+        for (uint8_t j = 0; j < BTREE_DEGREE; j++) {
+            right->size += node(right->children[j])->size;
+        }
+    }
+    left->count = BTREE_DEGREE - 1;
+    left->size -= right->size + 1;
+    
+    memmove(parent->children + i + 2, parent->children + i + 1, (parent->count - i) * sizeof(Object *));
+    parent->children[i + 1] = rightObject;
+    btreeInsertAt(parent, i, left->keys[BTREE_DEGREE - 1], left->values[BTREE_DEGREE - 1]);
+}
+
+/** Merges child @c i + 1 of @c parent and the key between them into child @c i. Both children must be minimal. */
+static void btreeMergeChildren(BTree *tree, BTreeNode *parent, uint8_t i){
+    BTreeNode *left = node(parent->children[i]);
+    Object *rightObject = parent->children[i + 1];
+    BTreeNode *right = node(rightObject);
+    
+    left->keys[left->count] = parent->keys[i];
+    left->values[left->count] = parent->values[i];
+    memcpy(left->keys + left->count + 1, right->keys, right->count * sizeof(Something));
+    memcpy(left->values + left->count + 1, right->values, right->count * sizeof(Something));
+    if (!left->leaf) {
+        memcpy(left->children + left->count + 1, right->children, (right->count + 1) * sizeof(Object *));
+    }
+    left->count += right->count + 1;
+    left->size += right->size + 1;
+    
+    btreeRemoveAt(parent, i);
+    memmove(parent->children + i + 1, parent->children + i + 2, (parent->count - i) * sizeof(Object *));
+    btreeReleaseNode(tree, rightObject);
+}
+
+/** Moves the last key of child @c i - 1 through @c parent to the front of child @c i. */
+static void btreeRotateRight(BTreeNode *parent, uint8_t i){
+    BTreeNode *left = node(parent->children[i - 1]);
+    BTreeNode *child = node(parent->children[i]);
+    size_t moved = 1;
+    
+    btreeInsertAt(child, 0, parent->keys[i - 1], parent->values[i - 1]);
+    parent->keys[i - 1] = left->keys[left->count - 1];
+    parent->values[i - 1] = left->values[left->count - 1];
+    if (!child->leaf) {
+        memmove(child->children + 1, child->children, child->count * sizeof(Object *));
+        child->children[0] = left->children[left->count];
+        moved += node(child->children[0])->size;
+    }
+    left->count--;
+    left->size -= moved;
+    child->size += moved;
+}
+
+/** Moves the first key of child @c i + 1 through @c parent to the end of child @c i. */
+static void btreeRotateLeft(BTreeNode *parent, uint8_t i){
+    BTreeNode *child = node(parent->children[i]);
+    BTreeNode *right = node(parent->children[i + 1]);
+    size_t moved = 1;
+    
+    btreeInsertAt(child, child->count, parent->keys[i], parent->values[i]);
+    parent->keys[i] = right->keys[0];
+    parent->values[i] = right->values[0];
+    if (!child->leaf) {
+        child->children[child->count] = right->children[0];
+        moved += node(right->children[0])->size;
+        memmove(right->children, right->children + 1, right->count * sizeof(Object *));
+    }
+    btreeRemoveAt(right, 0);
+    right->size -= moved;
+    child->size += moved;
+}
+
+/**
+ * Removes @c key, which must be in the subtree of @c n, from the subtree. @c n must have more than the minimal number
+ * of keys unless it is the root, so that a key can be removed from it without merging.
+ */
+static void btreeRemoveFromNode(BTree *tree, BTreeNode *n, Something key){
+    n->size--;
+    uint8_t i = btreeLowerBound(tree, n, key);
+    
+    if (btreeKeyAt(tree, n, i, key)) {
+        if (n->leaf) {
+            btreeRemoveAt(n, i);
+            return;
+        }
+        BTreeNode *left = node(n->children[i]);
+        BTreeNode *right = node(n->children[i + 1]);
+        if (left->count >= BTREE_DEGREE) {
+            // Replace the key with its predecessor and remove the predecessor instead
+            BTreeNode *p = left;
+            while (!p->leaf) {
+                p = node(p->children[p->count]);
+            }
+            n->keys[i] = p->keys[p->count - 1];
+            n->values[i] = p->values[p->count - 1];
+            btreeRemoveFromNode(tree, left, n->keys[i]);
+        }
+        else if (right->count >= BTREE_DEGREE) {
+            BTreeNode *s = right;
+            while (!s->leaf) {
+                s = node(s->children[0]);
+            }
+            n->keys[i] = s->keys[0];
+            n->values[i] = s->values[0];
+            btreeRemoveFromNode(tree, right, n->keys[i]);
+        }
+        else {
+            btreeMergeChildren(tree, n, i);
+            btreeRemoveFromNode(tree, left, key);
+        }
+        return;
+    }
+    
+    if (node(n->children[i])->count < BTREE_DEGREE) {
+        if (i > 0 && node(n->children[i - 1])->count >= BTREE_DEGREE) {
+            btreeRotateRight(n, i);
+        }
+        else if (i < n->count && node(n->children[i + 1])->count >= BTREE_DEGREE) {
+            btreeRotateLeft(n, i);
+        }
+        else if (i < n->count) {
+            btreeMergeChildren(tree, n, i);
+        }
+        else {
+            btreeMergeChildren(tree, n, --i);
+        }
+    }
+    btreeRemoveFromNode(tree, node(n->children[i]), key);
+}
+
+//MARK: Queries
+
+static Something* btreeFindValue(BTree *tree, Something key){
+    for (Object *o = tree->root; o;) {
+        BTreeNode *n = node(o);
+        uint8_t i = btreeLowerBound(tree, n, key);
+        if (btreeKeyAt(tree, n, i, key)) {
+            return n->values + i;
+        }
+        o = n->leaf ? NULL : n->children[i];
+    }
+    return NULL;
+}
+
+/** Returns the number of keys less than @c key. */
+static size_t btreeRank(BTree *tree, Something key){
+    size_t rank = 0;
+    for (Object *o = tree->root; o;) {
+        BTreeNode *n = node(o);
+        uint8_t i = btreeLowerBound(tree, n, key);
+        bool found = btreeKeyAt(tree, n, i, key);
+        rank += i;
+        if (n->leaf) {
+            break;
+        }
+        for (uint8_t j = 0; j < i + found; j++) {
+            rank += node(n->children[j])->size;
+        }
+        o = found ? NULL : n->children[i];
+    }
+    return rank;
+}
+
+/** Returns the node containing the key with rank @c index, which must be less than the size, and its index there. */
+static BTreeNode* btreeSelect(BTree *tree, size_t index, uint8_t *position){
+    BTreeNode *n = node(tree->root);
+    while (!n->leaf) {
+        uint8_t j = 0;
+        for (;; j++) {
+            size_t size = node(n->children[j])->size;
+            if (index < size) {
+                break;
+            }
+            index -= size;
+            if (index == 0) {
+                *position = j;
+                return n;
+            }
+            index--;
+        }
+        n = node(n->children[j]);
+    }
+    *position = (uint8_t)index;
+    return n;
+}
+
+/**
+ * Copies the keys, or the values if @c values is true, of the items of the subtree of @c n in ascending order to
+ * @c *out, skipping the first @c *skip items, until @c *remaining items were copied.
+ */
+static void btreeCollect(BTreeNode *n, size_t *skip, size_t *remaining, Something **out, bool values){
+    for (uint8_t j = 0; j <= n->count && *remaining > 0; j++) {
+        if (!n->leaf) {
+            BTreeNode *child = node(n->children[j]);
+            if (*skip >= child->size) {
+                *skip -= child->size;
+            }
+            else {
+                btreeCollect(child, skip, remaining, out, values);
+            }
+        }
+        if (j == n->count || *remaining == 0) {
+            break;
+        }
+        if (*skip > 0) {
+            (*skip)--;
+            continue;
+        }
+        *(*out)++ = values ? n->values[j] : n->keys[j];
+        (*remaining)--;
+    }
+}
+
+static size_t btreeSize(BTree *tree){
+    return tree->root ? node(tree->root)->size : 0;
+}
+
+/**
+ * Returns a list of the keys, or values if @c values is true, of the items with a rank in [@c from, @c to).
+ * @warning GC-invoking
+ */
+static Something btreeCollectList(size_t from, size_t to, bool values, Thread *thread){
+    size_t count = to > from ? to - from : 0;
+    
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
+    Object *listItems = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+    List *list = stackGetVariable(0, thread).object->value;
+    list->items = listItems;
+    list->capacity = list->count = count;
+    
+    if (count) {
+        Something *out = listItems->value;
+        btreeCollect(node(thisTree(thread)->root), &from, &count, &out, values);
+    }
+    
+    Something listSomething = stackGetVariable(0, thread);
+    stackPop(thread);
+    return listSomething;
+}
+
+//MARK: Bridges
+
+static void btreeInit(Thread *thread, Type keyType){
+    BTree *tree = thisTree(thread);
+    tree->root = NULL;
+    tree->spareNodes = NULL;
+    tree->spareCount = 0;
+    tree->keyType = keyType;
+}
+
+static void btreeInitStringKeys(Thread *thread){
+    btreeInit(thread, T_OBJECT);
+}
+
+static void btreeInitIntegerKeys(Thread *thread){
+    btreeInit(thread, T_INTEGER);
+}
+
+static Something btreeSetBridge(Thread *thread){
+    BTree *tree = btreeReserveSpareNodes(thread);
+    Something key = stackGetVariable(0, thread);
+    Something value = stackGetVariable(1, thread);
+    
+    Something *existing = btreeFindValue(tree, key);
+    if (existing) {
+        *existing = value;
+        return NOTHINGNESS;
+    }
+    
+    if (tree->root == NULL) {
+        tree->root = btreeTakeSpareNode(tree, true);
+    }
+    else if (node(tree->root)->count == BTREE_MAX_KEYS) {
+        Object *root = btreeTakeSpareNode(tree, false);
+        node(root)->children[0] = tree->root;
+        node(root)->size = node(tree->root)->size;
+        tree->root = root;
+        btreeSplitChild(tree, node(root), 0);
+    }
+    
+    BTreeNode *n = node(tree->root);
+    while (true) {
+        n->size++;
+        uint8_t i = btreeLowerBound(tree, n, key);
+        if (n->leaf) {
+            btreeInsertAt(n, i, key, value);
+            break;
+        }
+        if (node(n->children[i])->count == BTREE_MAX_KEYS) {
+            btreeSplitChild(tree, n, i);
+            if (btreeCompare(tree, key, n->keys[i]) > 0) {
+                i++;
+            }
+        }
+        n = node(n->children[i]);
+    }
+    return NOTHINGNESS;
+}
+
+static Something btreeGetBridge(Thread *thread){
+    Something *value = btreeFindValue(thisTree(thread), stackGetVariable(0, thread));
+    return value ? *value : NOTHINGNESS;
+}
+
+static Something btreeContainsBridge(Thread *thread){
+    return somethingBoolean(btreeFindValue(thisTree(thread), stackGetVariable(0, thread)) != NULL);
+}
+
+static Something btreeRemoveBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    Something key = stackGetVariable(0, thread);
+    if (btreeFindValue(tree, key) == NULL) {
+        return EMOJICODE_FALSE;
+    }
+    
+    btreeRemoveFromNode(tree, node(tree->root), key);
+    
+    Object *root = tree->root;
+    if (node(root)->count == 0) {
+        tree->root = node(root)->leaf ? NULL : node(root)->children[0];
+        btreeReleaseNode(tree, root);
+    }
+    return EMOJICODE_TRUE;
+}
+
+static Something btreeCountBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)btreeSize(thisTree(thread)));
+}
+
+static Something btreeClearBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    size_t size = btreeSize(tree);
+    tree->root = NULL;
+    return somethingInteger((EmojicodeInteger)size);
+}
+
+/** Returns the greatest key not greater than @c key. */
+static Something btreeFloorBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    Something key = stackGetVariable(0, thread);
+    Something floor = NOTHINGNESS;
+    for (Object *o = tree->root; o;) {
+        BTreeNode *n = node(o);
+        uint8_t i = btreeLowerBound(tree, n, key);
+        if (btreeKeyAt(tree, n, i, key)) {
+            return n->keys[i];
+        }
+        if (i > 0) {
+            floor = n->keys[i - 1];
+        }
+        o = n->leaf ? NULL : n->children[i];
+    }
+    return floor;
+}
+
+/** Returns the least key not less than @c key. */
+static Something btreeCeilingBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    Something key = stackGetVariable(0, thread);
+    Something ceiling = NOTHINGNESS;
+    for (Object *o = tree->root; o;) {
+        BTreeNode *n = node(o);
+        uint8_t i = btreeLowerBound(tree, n, key);
+        if (i < n->count) {
+            ceiling = n->keys[i];
+            if (btreeCompare(tree, ceiling, key) == 0) {
+                return ceiling;
+            }
+        }
+        o = n->leaf ? NULL : n->children[i];
+    }
+    return ceiling;
+}
+
+static Something btreeRankBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)btreeRank(thisTree(thread), stackGetVariable(0, thread)));
+}
+
+static Something btreeKeyAtRankBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    EmojicodeInteger index = stackGetVariable(0, thread).raw;
+    if (index < 0) {
+        index += btreeSize(tree);
+    }
+    if (index < 0 || (size_t)index >= btreeSize(tree)) {
+        return NOTHINGNESS;
+    }
+    uint8_t position;
+    BTreeNode *n = btreeSelect(tree, index, &position);
+    return n->keys[position];
+}
+
+static Something btreeKeysBridge(Thread *thread){
+    return btreeCollectList(0, btreeSize(thisTree(thread)), false, thread);
+}
+
+static Something btreeRangeKeysBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    size_t from = btreeRank(tree, stackGetVariable(0, thread));
+    size_t to = btreeRank(tree, stackGetVariable(1, thread));
+    return btreeCollectList(from, to, false, thread);
+}
+
+static Something btreeRangeValuesBridge(Thread *thread){
+    BTree *tree = thisTree(thread);
+    size_t from = btreeRank(tree, stackGetVariable(0, thread));
+    size_t to = btreeRank(tree, stackGetVariable(1, thread));
+    return btreeCollectList(from, to, true, thread);
+}
+
+FunctionFunctionPointer btreeMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1F437: //🐷
+            return btreeSetBridge;
+        case 0x1F43D: //🐽
+            return btreeGetBridge;
+        case 0x1F423: //🐣
+            return btreeContainsBridge;
+        case 0x1F428: //🐨
+            return btreeRemoveBridge;
+        case 0x1F414: //🐔
+            return btreeCountBridge;
+        case 0x1F417: //🐗
+            return btreeClearBridge;
+        case 0x1F53D: //🔽
+            return btreeFloorBridge;
+        case 0x1F53C: //🔼
+            return btreeCeilingBridge;
+        case 0x1F522: //🔢
+            return btreeRankBridge;
+        case 0x1F516: //🔖
+            return btreeKeyAtRankBridge;
+        case 0x1F419: //🐙
+            return btreeKeysBridge;
+        case 0x1F422: //🐢
+            return btreeRangeKeysBridge;
+        case 0x1F41E: //🐞
+            return btreeRangeValuesBridge;
+    }
+    return NULL;
+}
+
+InitializerFunctionFunctionPointer btreeInitializerForName(EmojicodeChar cl){
+    return cl == 0x1f334 ? btreeInitIntegerKeys : btreeInitStringKeys;
+}
@@ -0,0 +1,372 @@
+//
+//  EmojicodeBitset.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeBitset.h"
+#include "EmojicodeList.h"
+
+#include <string.h>
+
+#define words(bitset) ((BitsetWord *)(bitset)->words->value)
+#define wordCount(bits) (((bits) + BITSET_WORD_BITS - 1) / BITSET_WORD_BITS)
+#define bitMask(index) ((BitsetWord)1 << ((index) % BITSET_WORD_BITS))
+
+static inline Bitset* thisBitset(Thread *thread){
+    return stackGetThisObject(thread)->value;
+}
+
+void bitsetMark(Object *self){
+    Bitset *bitset = self->value;
+    if (bitset->words) {
+        mark(&bitset->words);
+    }
+}
+
+/**
+ * Ensures that @c bitsetObject can store @c bits bits. Unless @c exactly is true, the words grow by at least half of
+ * their capacity. The new words are zero. Returns @c bitsetObject, which might have been moved.
+ * @warning GC-invoking
+ */
+static Object* bitsetReserve(Object *bitsetObject, size_t bits, bool exactly, Thread *thread){
+    Bitset *bitset = bitsetObject->value;
+    size_t needed = wordCount(bits);
+    if (bitset->capacity >= needed) {
+        return bitsetObject;
+    }
+    size_t capacity = bitset->capacity + (bitset->capacity >> 1);
+    if (exactly || capacity < needed) {
+        capacity = needed;
+    }
+    
+    stackPush(somethingObject(bitsetObject), 0, 0, thread);
+    Object *wordsObject = newArray(sizeCalculationWithOverflowProtection(capacity, sizeof(BitsetWord)));
+    bitsetObject = stackGetThisObject(thread);
+    stackPop(thread);
+    
+    bitset = bitsetObject->value;
+    BitsetWord *newWords = wordsObject->value;
+    if (bitset->capacity) {
+        memcpy(newWords, words(bitset), bitset->capacity * sizeof(BitsetWord));
+    }
+    memset(newWords + bitset->capacity, 0, (capacity - bitset->capacity) * sizeof(BitsetWord));
+    bitset->words = wordsObject;
+    bitset->capacity = capacity;
+    return bitsetObject;
+}
+
+/** Returns the index of the first set bit not before @c from or -1 if there is none. */
+static EmojicodeInteger bitsetNextSetBit(Bitset *bitset, size_t from){
+    if (from >= bitset->count) {
+        return -1;
+    }
+    size_t count = wordCount(bitset->count), i = from / BITSET_WORD_BITS;
+    BitsetWord word = words(bitset)[i] & (~(BitsetWord)0 << (from % BITSET_WORD_BITS));
+    while (word == 0) {
+        if (++i == count) {
+            return -1;
+        }
+        word = words(bitset)[i];
+    }
+    return (EmojicodeInteger)(i * BITSET_WORD_BITS + __builtin_ctzll(word));
+}
+
+//MARK: Kernels
+
+/*
+ * The kernels are written as plain loops over the words, which the compiler vectorizes. The population count uses
+ * the bit-parallel algorithm instead of a builtin, as the builtin is a library call on processors without a population
+ * count instruction and prevents vectorization.
+ */
+
+static inline size_t wordPopulationCount(BitsetWord word){
+    word = word - ((word >> 1) & 0x5555555555555555);
+    word = (word & 0x3333333333333333) + ((word >> 2) & 0x3333333333333333);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0F;
+    return (word * 0x0101010101010101) >> 56;
+}
+
+static size_t wordsPopulationCount(const BitsetWord *restrict words, size_t count){
+    size_t population = 0;
+    for (size_t i = 0; i < count; i++) {
+        population += wordPopulationCount(words[i]);
+    }
+    return population;
+}
+
+static void wordsAnd(BitsetWord *restrict a, const BitsetWord *restrict b, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        a[i] &= b[i];
+    }
+}
+
+static void wordsOr(BitsetWord *restrict a, const BitsetWord *restrict b, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        a[i] |= b[i];
+    }
+}
+
+static void wordsXor(BitsetWord *restrict a, const BitsetWord *restrict b, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        a[i] ^= b[i];
+    }
+}
+
+static void wordsAndNot(BitsetWord *restrict a, const BitsetWord *restrict b, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        a[i] &= ~b[i];
+    }
+}
+
+//MARK: Bridges
+
+static Something bitsetCountBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)thisBitset(thread)->count);
+}
+
+static Something bitsetSetBridge(Thread *thread){
+    EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
+    if (index < 0) {
+        return NOTHINGNESS;
+    }
+    Bitset *bitset = bitsetReserve(stackGetThisObject(thread), index + 1, false, thread)->value;
+    if (bitset->count <= index) {
+        bitset->count = index + 1;
+    }
+    words(bitset)[index / BITSET_WORD_BITS] |= bitMask(index);
+    return NOTHINGNESS;
+}
+
+static Something bitsetClearBridge(Thread *thread){
+    Bitset *bitset = thisBitset(thread);
+    EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
+    if (index >= 0 && index < bitset->count) {
+        words(bitset)[index / BITSET_WORD_BITS] &= ~bitMask(index);
+    }
+    return NOTHINGNESS;
+}
+
+static Something bitsetTestBridge(Thread *thread){
+    Bitset *bitset = thisBitset(thread);
+    EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
+    if (index < 0 || index >= bitset->count) {
+        return EMOJICODE_FALSE;
+    }
+    return somethingBoolean((words(bitset)[index / BITSET_WORD_BITS] & bitMask(index)) != 0);
+}
+
+static Something bitsetFillBridge(Thread *thread){
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(2, thread));
+    if (from < 0 || length <= 0) {
+        return NOTHINGNESS;
+    }
+    size_t to = from + length;
+    Bitset *bitset = bitsetReserve(stackGetThisObject(thread), to, false, thread)->value;
+    if (bitset->count < to) {
+        bitset->count = to;
+    }
+    
+    BitsetWord *w = words(bitset);
+    size_t first = from / BITSET_WORD_BITS, last = (to - 1) / BITSET_WORD_BITS;
+    BitsetWord firstMask = ~(BitsetWord)0 << (from % BITSET_WORD_BITS);
+    BitsetWord lastMask = ~(BitsetWord)0 >> (BITSET_WORD_BITS - 1 - (to - 1) % BITSET_WORD_BITS);
+    if (unwrapBool(stackGetVariable(0, thread))) {
+        if (first == last) {
+            w[first] |= firstMask & lastMask;
+            return NOTHINGNESS;
+        }
+        w[first] |= firstMask;
+        memset(w + first + 1, 0xFF, (last - first - 1) * sizeof(BitsetWord));
+        w[last] |= lastMask;
+    }
+    else {
+        if (first == last) {
+            w[first] &= ~(firstMask & lastMask);
+            return NOTHINGNESS;
+        }
+        w[first] &= ~firstMask;
+        memset(w + first + 1, 0, (last - first - 1) * sizeof(BitsetWord));
+        w[last] &= ~lastMask;
+    }
+    return NOTHINGNESS;
+}
+
+static Something bitsetResetBridge(Thread *thread){
+    Bitset *bitset = thisBitset(thread);
+    if (bitset->count) {
+        memset(words(bitset), 0, wordCount(bitset->count) * sizeof(BitsetWord));
+    }
+    return NOTHINGNESS;
+}
+
+static Something bitsetEnsureCapacityBridge(Thread *thread){
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > 0) {
+        bitsetReserve(stackGetThisObject(thread), capacity, true, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something bitsetPopulationCountBridge(Thread *thread){
+    Bitset *bitset = thisBitset(thread);
+    if (bitset->count == 0) {
+        return somethingInteger(0);
+    }
+    return somethingInteger((EmojicodeInteger)wordsPopulationCount(words(bitset), wordCount(bitset->count)));
+}
+
+static Something bitsetNextSetBitBridge(Thread *thread){
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(0, thread));
+    EmojicodeInteger index = bitsetNextSetBit(thisBitset(thread), from < 0 ? 0 : from);
+    return index < 0 ? NOTHINGNESS : somethingInteger(index);
+}
+
+static Something bitsetToListBridge(Thread *thread){
+    Bitset *bitset = thisBitset(thread);
+    size_t count = bitset->count ? wordsPopulationCount(words(bitset), wordCount(bitset->count)) : 0;
+    
+    Object *listO = newObject(CL_LIST);
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(listO), thread);
+    
+    if (count > 0) {
+        Object *items = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+        listO = stackGetVariable(0, thread).object;
+        List *list = listO->value;
+        list->items = items;
+        list->capacity = list->count = count;
+    
+        bitset = thisBitset(thread);
+        Something *listItems = items->value;
+        for (size_t i = 0, j = 0; j < count; i++) {
+            for (BitsetWord word = words(bitset)[i]; word; word &= word - 1) {
+                listItems[j++] = somethingInteger((EmojicodeInteger)(i * BITSET_WORD_BITS + __builtin_ctzll(word)));
+            }
+        }
+    }
+    
+    listO = stackGetVariable(0, thread).object;
+    stackPop(thread);
+    return somethingObject(listO);
+}
+
+/**
+ * Combines this bitset with the bitset in variable 0. If @c grow is true, this bitset first grows to the count of the
+ * other bitset, otherwise only the words both bitsets have are combined and the remaining words are cleared if
+ * @c clearRest is true.
+ */
+static Something bitsetCombine(Thread *thread, void (*kernel)(BitsetWord *restrict, const BitsetWord *restrict,
+                                                                size_t), bool grow, bool clearRest){
+    Bitset *bitset = thisBitset(thread), *other = stackGetVariable(0, thread).object->value;
+    if (grow && bitset->count < other->count) {
+        bitset = bitsetReserve(stackGetThisObject(thread), other->count, false, thread)->value;
+        other = stackGetVariable(0, thread).object->value;
+        bitset->count = other->count;
+    }
+    
+    size_t count = wordCount(bitset->count), otherCount = wordCount(other->count);
+    size_t common = count < otherCount ? count : otherCount;
+    if (count == 0) {
+        return NOTHINGNESS;
+    }
+    if (bitset == other) {
+        // The kernels must not be passed the same words twice. x & x and x | x are x, x ^ x and x & ~x are empty.
+        if (kernel == wordsXor || kernel == wordsAndNot) {
+            memset(words(bitset), 0, count * sizeof(BitsetWord));
+        }
+        return NOTHINGNESS;
+    }
+    if (common) {
+        kernel(words(bitset), words(other), common);
+    }
+    if (clearRest && count > common) {
+        memset(words(bitset) + common, 0, (count - common) * sizeof(BitsetWord));
+    }
+    return NOTHINGNESS;
+}
+
+static Something bitsetAndBridge(Thread *thread){
+    return bitsetCombine(thread, wordsAnd, false, true);
+}
+
+static Something bitsetOrBridge(Thread *thread){
+    return bitsetCombine(thread, wordsOr, true, false);
+}
+
+static Something bitsetXorBridge(Thread *thread){
+    return bitsetCombine(thread, wordsXor, true, false);
+}
+
+static Something bitsetAndNotBridge(Thread *thread){
+    return bitsetCombine(thread, wordsAndNot, false, false);
+}
+
+static Something bitsetIsSubsetBridge(Thread *thread){
+    Bitset *bitset = thisBitset(thread), *other = stackGetVariable(0, thread).object->value;
+    size_t count = wordCount(bitset->count), otherCount = wordCount(other->count);
+    for (size_t i = 0; i < count; i++) {
+        if (words(bitset)[i] & ~(i < otherCount ? words(other)[i] : 0)) {
+            return EMOJICODE_FALSE;
+        }
+    }
+    return EMOJICODE_TRUE;
+}
+
+FunctionFunctionPointer bitsetMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1F414: //🐔
+            return bitsetCountBridge;
+        case 0x1f437: //🐷
+            return bitsetSetBridge;
+        case 0x1f428: //🐨
+            return bitsetClearBridge;
+        case 0x1f423: //🐣
+            return bitsetTestBridge;
+        case 0x1f41c: //🐜
+            return bitsetFillBridge;
+        case 0x1f417: //🐗
+            return bitsetResetBridge;
+        case 0x1f434: //🐴
+            return bitsetEnsureCapacityBridge;
+        case 0x1f522: //🔢
+            return bitsetPopulationCountBridge;
+        case 0x1f51c: //🔜
+            return bitsetNextSetBitBridge;
+        case 0x1f4cb: //📋
+            return bitsetToListBridge;
+        case 0x1f420: //🐠
+            return bitsetAndBridge;
+        case 0x1f433: //🐳
+            return bitsetOrBridge;
+        case 0x1f421: //🐡
+            return bitsetXorBridge;
+        case 0x1f41f: //🐟
+            return bitsetAndNotBridge;
+        case 0x1f429: //🐩
+            return bitsetIsSubsetBridge;
+    }
+    return NULL;
+}
+
+//MARK: Initializers
+
+static void bitsetInit(Thread *thread){
+    Bitset *bitset = thisBitset(thread);
+    bitset->count = 0;
+    bitset->capacity = 0;
+    bitset->words = NULL;
+}
+
+static void bitsetInitWithCapacity(Thread *thread){
+    bitsetInit(thread);
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > 0) {
+        bitsetReserve(stackGetThisObject(thread), capacity, true, thread);
+    }
+}
+
+InitializerFunctionFunctionPointer bitsetInitializerForName(EmojicodeChar name){
+    return name == 0x1F427 ? bitsetInitWithCapacity : bitsetInit;
+}
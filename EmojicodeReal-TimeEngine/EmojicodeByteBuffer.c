@@ -0,0 +1,410 @@
+//
+//  EmojicodeByteBuffer.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeByteBuffer.h"
+#include "EmojicodeString.h"
+#include "utf8.h"
+
+#include <string.h>
+
+#define bytes(buffer) ((uint8_t *)(buffer)->bytes->value)
+
+/** The maximal number of bytes of a varint, which stores 7 bits of the integer per byte. */
+#define VARINT_MAX_LENGTH 10
+
+static inline ByteBuffer* thisByteBuffer(Thread *thread){
+    return stackGetThisObject(thread)->value;
+}
+
+void byteBufferMark(Object *self){
+    ByteBuffer *buffer = self->value;
+    if (buffer->bytes) {
+        mark(&buffer->bytes);
+    }
+}
+
+/**
+ * Ensures that the byte buffer in the this-slot can store @c size bytes. Unless @c exactly is true, the bytes grow by
+ * at least half of their capacity. The bytes are always copied to a new array, as they might be shared with a 📇.
+ * @warning GC-invoking
+ */
+static ByteBuffer* byteBufferReserve(size_t size, bool exactly, Thread *thread){
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    if (buffer->capacity >= size) {
+        return buffer;
+    }
+    size_t capacity = buffer->capacity + (buffer->capacity >> 1);
+    if (exactly || capacity < size) {
+        capacity = size;
+    }
+    if (!exactly && capacity < 16) {
+        capacity = 16;
+    }
+    
+    Object *bytesObject = newArray(capacity);
+    buffer = thisByteBuffer(thread);
+    
+    if (buffer->length) {
+        memcpy(bytesObject->value, bytes(buffer), buffer->length);
+    }
+    buffer->bytes = bytesObject;
+    buffer->capacity = capacity;
+    buffer->shared = false;
+    return buffer;
+}
+
+/**
+ * Appends @c count bytes to the byte buffer in the this-slot and returns a pointer to them, which the caller must fill
+ * before allocating again.
+ * @warning GC-invoking
+ */
+static uint8_t* byteBufferAppend(size_t count, Thread *thread){
+    ByteBuffer *buffer = byteBufferReserve(thisByteBuffer(thread)->length + count, false, thread);
+    uint8_t *appended = bytes(buffer) + buffer->length;
+    buffer->length += count;
+    return appended;
+}
+
+/**
+ * Returns a pointer to the next @c count bytes and advances the position past them, or @c NULL if fewer bytes remain.
+ * @c count must not be 0.
+ */
+static uint8_t* byteBufferConsume(ByteBuffer *buffer, EmojicodeInteger count){
+    if (count <= 0 || buffer->length - buffer->position < (size_t)count) {
+        return NULL;
+    }
+    uint8_t *consumed = bytes(buffer) + buffer->position;
+    buffer->position += count;
+    return consumed;
+}
+
+/** @warning GC-invoking */
+static void byteBufferWriteInteger(uint64_t value, size_t width, bool bigEndian, Thread *thread){
+    uint8_t *bytes = byteBufferAppend(width, thread);
+    for (size_t i = 0; i < width; i++) {
+        bytes[bigEndian ? width - 1 - i : i] = (uint8_t)(value >> (8 * i));
+    }
+}
+
+static uint64_t byteBufferReadInteger(const uint8_t *bytes, size_t width, bool bigEndian){
+    uint64_t value = 0;
+    for (size_t i = 0; i < width; i++) {
+        value |= (uint64_t)bytes[bigEndian ? width - 1 - i : i] << (8 * i);
+    }
+    return value;
+}
+
+static size_t integerWidth(Something width){
+    EmojicodeInteger w = unwrapInteger(width);
+    if (w < 1 || w > 8) {
+        error("The width of an integer in a 📼 must be between 1 and 8 bytes.");
+    }
+    return (size_t)w;
+}
+
+static size_t floatWidth(Something width){
+    EmojicodeInteger w = unwrapInteger(width);
+    if (w != 4 && w != 8) {
+        error("The width of a floating-point number in a 📼 must be 4 or 8 bytes.");
+    }
+    return (size_t)w;
+}
+
+//MARK: Writing
+
+static Something byteBufferAppendByteBridge(Thread *thread){
+    *byteBufferAppend(1, thread) = (uint8_t)unwrapInteger(stackGetVariable(0, thread));
+    return NOTHINGNESS;
+}
+
+static Something byteBufferAppendIntegerBridge(Thread *thread){
+    size_t width = integerWidth(stackGetVariable(1, thread));
+    byteBufferWriteInteger((uint64_t)unwrapInteger(stackGetVariable(0, thread)), width,
+                           unwrapBool(stackGetVariable(2, thread)), thread);
+    return NOTHINGNESS;
+}
+
+static Something byteBufferAppendFloatBridge(Thread *thread){
+    size_t width = floatWidth(stackGetVariable(1, thread));
+    bool bigEndian = unwrapBool(stackGetVariable(2, thread));
+    double value = unwrapDouble(stackGetVariable(0, thread));
+    if (width == 4) {
+        float single = (float)value;
+        uint32_t bits;
+        memcpy(&bits, &single, sizeof(bits));
+        byteBufferWriteInteger(bits, width, bigEndian, thread);
+    }
+    else {
+        uint64_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+        byteBufferWriteInteger(bits, width, bigEndian, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something byteBufferAppendVarintBridge(Thread *thread){
+    EmojicodeInteger integer = unwrapInteger(stackGetVariable(0, thread));
+    uint64_t value = (uint64_t)integer;
+    if (unwrapBool(stackGetVariable(1, thread))) {
+        value = (value << 1) ^ (uint64_t)(integer >> 63);
+    }
+    
+    uint8_t encoded[VARINT_MAX_LENGTH];
+    size_t length = 0;
+    do {
+        encoded[length] = value & 0x7F;
+        value >>= 7;
+        if (value) {
+            encoded[length] |= 0x80;
+        }
+        length++;
+    } while (value);
+    memcpy(byteBufferAppend(length, thread), encoded, length);
+    return NOTHINGNESS;
+}
+
+static Something byteBufferAppendDataBridge(Thread *thread){
+    size_t length = ((Data *)stackGetVariable(0, thread).object->value)->length;
+    if (length == 0) {
+        return NOTHINGNESS;
+    }
+    uint8_t *appended = byteBufferAppend(length, thread);
+    memcpy(appended, ((Data *)stackGetVariable(0, thread).object->value)->bytes, length);
+    return NOTHINGNESS;
+}
+
+static Something byteBufferAppendStringBridge(Thread *thread){
+    String *string = stackGetVariable(0, thread).object->value;
+    size_t size = u8_codingsize_width(stringBytes(string), string->width, string->length);
+    if (size == 0) {
+        return NOTHINGNESS;
+    }
+    uint8_t *appended = byteBufferAppend(size, thread);
+    string = stackGetVariable(0, thread).object->value;
+    u8_toutf8_width((char *)appended, size, stringBytes(string), string->width, string->length);
+    return NOTHINGNESS;
+}
+
+//MARK: Reading
+
+static Something byteBufferReadIntegerBridge(Thread *thread){
+    size_t width = integerWidth(stackGetVariable(0, thread));
+    uint8_t *bytes = byteBufferConsume(thisByteBuffer(thread), width);
+    if (!bytes) {
+        return NOTHINGNESS;
+    }
+    uint64_t value = byteBufferReadInteger(bytes, width, unwrapBool(stackGetVariable(1, thread)));
+    if (unwrapBool(stackGetVariable(2, thread)) && width < 8) {
+        size_t shift = 64 - 8 * width;
+        return somethingInteger((EmojicodeInteger)(value << shift) >> shift);
+    }
+    return somethingInteger((EmojicodeInteger)value);
+}
+
+static Something byteBufferReadFloatBridge(Thread *thread){
+    size_t width = floatWidth(stackGetVariable(0, thread));
+    uint8_t *bytes = byteBufferConsume(thisByteBuffer(thread), width);
+    if (!bytes) {
+        return NOTHINGNESS;
+    }
+    uint64_t bits = byteBufferReadInteger(bytes, width, unwrapBool(stackGetVariable(1, thread)));
+    if (width == 4) {
+        uint32_t singleBits = (uint32_t)bits;
+        float single;
+        memcpy(&single, &singleBits, sizeof(single));
+        return somethingDouble(single);
+    }
+    double value;
+    memcpy(&value, &bits, sizeof(value));
+    return somethingDouble(value);
+}
+
+static Something byteBufferReadVarintBridge(Thread *thread){
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    uint64_t value = 0;
+    for (size_t i = 0; i < VARINT_MAX_LENGTH && buffer->position + i < buffer->length; i++) {
+        uint8_t byte = bytes(buffer)[buffer->position + i];
+        if (i == VARINT_MAX_LENGTH - 1 && byte > 1) {
+            return NOTHINGNESS;
+        }
+        value |= (uint64_t)(byte & 0x7F) << (7 * i);
+        if (!(byte & 0x80)) {
+            buffer->position += i + 1;
+            if (unwrapBool(stackGetVariable(0, thread))) {
+                value = (value >> 1) ^ (~(value & 1) + 1);
+            }
+            return somethingInteger((EmojicodeInteger)value);
+        }
+    }
+    return NOTHINGNESS;
+}
+
+static Something byteBufferReadDataBridge(Thread *thread){
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(0, thread));
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    if (length < 0 || buffer->length - buffer->position < (size_t)length) {
+        return NOTHINGNESS;
+    }
+    
+    Object *dataObject = newObject(CL_DATA);
+    buffer = thisByteBuffer(thread);
+    if (length > 0) {
+        Data *data = dataObject->value;
+        data->length = length;
+        data->bytesObject = buffer->bytes;
+        data->bytes = (char *)byteBufferConsume(buffer, length);
+        buffer->shared = true;
+    }
+    return somethingObject(dataObject);
+}
+
+static Something byteBufferReadStringBridge(Thread *thread){
+    EmojicodeInteger size = unwrapInteger(stackGetVariable(0, thread));
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    if (size < 0 || buffer->length - buffer->position < (size_t)size) {
+        return NOTHINGNESS;
+    }
+    if (size == 0) {
+        return somethingObject(emptyString);
+    }
+    if (!u8_isvalid((char *)bytes(buffer) + buffer->position, size)) {
+        return NOTHINGNESS;
+    }
+    
+    EmojicodeChar max;
+    EmojicodeInteger length = u8_toucs_measure((char *)bytes(buffer) + buffer->position, size, &max);
+    uint8_t width = stringWidthForCharacter(max);
+    Object *characters = newArray(length * width);
+    
+    stackPush(somethingObject(characters), 0, 0, thread);
+    Object *stringObject = newObject(CL_STRING);
+    String *string = stringObject->value;
+    string->length = length;
+    string->width = width;
+    string->characters = stackGetThisObject(thread);
+    stackPop(thread);
+    
+    // The bytes might have been moved by the garbage collector
+    buffer = thisByteBuffer(thread);
+    u8_toucs_width(string->characters->value, width, length, (char *)byteBufferConsume(buffer, size), size);
+    return somethingObject(stringObject);
+}
+
+//MARK: Buffer
+
+static Something byteBufferLengthBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)thisByteBuffer(thread)->length);
+}
+
+static Something byteBufferPositionBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)thisByteBuffer(thread)->position);
+}
+
+static Something byteBufferSetPositionBridge(Thread *thread){
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    EmojicodeInteger position = unwrapInteger(stackGetVariable(0, thread));
+    if (position < 0) {
+        position = 0;
+    }
+    buffer->position = (size_t)position < buffer->length ? (size_t)position : buffer->length;
+    return NOTHINGNESS;
+}
+
+static Something byteBufferReserveBridge(Thread *thread){
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > 0) {
+        byteBufferReserve(capacity, true, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something byteBufferResetBridge(Thread *thread){
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    buffer->length = 0;
+    buffer->position = 0;
+    if (buffer->shared) {
+        buffer->bytes = NULL;
+        buffer->capacity = 0;
+        buffer->shared = false;
+    }
+    return NOTHINGNESS;
+}
+
+static Something byteBufferToDataBridge(Thread *thread){
+    Object *dataObject = newObject(CL_DATA);
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    if (buffer->length > 0) {
+        Data *data = dataObject->value;
+        data->length = buffer->length;
+        data->bytesObject = buffer->bytes;
+        data->bytes = (char *)bytes(buffer);
+        buffer->shared = true;
+    }
+    return somethingObject(dataObject);
+}
+
+FunctionFunctionPointer byteBufferMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1f43b: //🐻
+            return byteBufferAppendByteBridge;
+        case 0x1f437: //🐷
+            return byteBufferAppendIntegerBridge;
+        case 0x1f42c: //🐬
+            return byteBufferAppendFloatBridge;
+        case 0x1f40d: //🐍
+            return byteBufferAppendVarintBridge;
+        case 0x1f4e5: //📥
+            return byteBufferAppendDataBridge;
+        case 0x1f4dd: //📝
+            return byteBufferAppendStringBridge;
+        case 0x1f43d: //🐽
+            return byteBufferReadIntegerBridge;
+        case 0x1f420: //🐠
+            return byteBufferReadFloatBridge;
+        case 0x1f409: //🐉
+            return byteBufferReadVarintBridge;
+        case 0x1f4e4: //📤
+            return byteBufferReadDataBridge;
+        case 0x1f4d6: //📖
+            return byteBufferReadStringBridge;
+        case 0x1f4cf: //📏
+            return byteBufferLengthBridge;
+        case 0x1f4cd: //📍
+            return byteBufferPositionBridge;
+        case 0x1f4cc: //📌
+            return byteBufferSetPositionBridge;
+        case 0x1f434: //🐴
+            return byteBufferReserveBridge;
+        case 0x1f417: //🐗
+            return byteBufferResetBridge;
+        case 0x1f4c7: //📇
+            return byteBufferToDataBridge;
+    }
+    return NULL;
+}
+
+//MARK: Initializers
+
+static void byteBufferInit(Thread *thread){
+    ByteBuffer *buffer = thisByteBuffer(thread);
+    buffer->length = 0;
+    buffer->capacity = 0;
+    buffer->position = 0;
+    buffer->bytes = NULL;
+    buffer->shared = false;
+}
+
+static void byteBufferInitWithCapacity(Thread *thread){
+    byteBufferInit(thread);
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > 0) {
+        byteBufferReserve(capacity, true, thread);
+    }
+}
+
+InitializerFunctionFunctionPointer byteBufferInitializerForName(EmojicodeChar name){
+    return name == 0x1F427 ? byteBufferInitWithCapacity : byteBufferInit;
+}
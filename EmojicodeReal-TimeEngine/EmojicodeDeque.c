@@ -0,0 +1,252 @@
+//
+//  EmojicodeDeque.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeDeque.h"
+#include "EmojicodeList.h"
+
+#include <string.h>
+
+#define items(deque) ((Something *)(deque)->items->value)
+
+/** Returns the slot of the element at @c index. */
+static inline size_t dequeSlot(Deque *deque, size_t index){
+    return (deque->head + index) & (deque->capacity - 1);
+}
+
+void dequeMark(Object *self){
+    Deque *deque = self->value;
+    if (deque->items == NULL) {
+        return;
+    }
+    mark(&deque->items);
+    for (size_t i = 0; i < deque->count; i++) {
+        Something *item = items(deque) + dequeSlot(deque, i);
+        if (isRealObject(*item)) {
+            mark(&item->object);
+        }
+    }
+}
+
+static inline Deque* thisDeque(Thread *thread){
+    return stackGetThisObject(thread)->value;
+}
+
+/**
+ * Ensures that the deque in the this-slot can store @c size elements. The elements are moved to the start of the new
+ * ring buffer.
+ * @warning GC-invoking
+ */
+static Deque* dequeReserve(size_t size, Thread *thread){
+    Deque *deque = thisDeque(thread);
+    if (deque->capacity >= size) {
+        return deque;
+    }
+    if (size > SIZE_MAX / 2 / sizeof(Something)) {
+        error("Integer overflow while allocating memory. It’s not possible to allocate objects of this size due to hardware limitations.");
+    }
+    size_t capacity = deque->capacity ? deque->capacity : 8;
+    while (capacity < size) {
+        capacity *= 2;
+    }
+    
+    Object *itemsObject = newArray(sizeCalculationWithOverflowProtection(capacity, sizeof(Something)));
+    deque = thisDeque(thread);
+    
+    if (deque->count) {
+        size_t firstPart = deque->capacity - deque->head;
+        if (firstPart > deque->count) {
+            firstPart = deque->count;
+        }
+        memcpy(itemsObject->value, items(deque) + deque->head, firstPart * sizeof(Something));
+        memcpy((Something *)itemsObject->value + firstPart, items(deque), (deque->count - firstPart) * sizeof(Something));
+    }
+    deque->items = itemsObject;
+    deque->capacity = capacity;
+    deque->head = 0;
+    return deque;
+}
+
+/** Converts a possibly negative index, which counts from the end, to an index. Returns false if it is out of bounds. */
+static bool dequeIndex(Deque *deque, EmojicodeInteger index, size_t *result){
+    if (index < 0) {
+        index += deque->count;
+    }
+    if (index < 0 || (size_t)index >= deque->count) {
+        return false;
+    }
+    *result = (size_t)index;
+    return true;
+}
+
+//MARK: Bridges
+
+static void dequeInit(Thread *thread){
+    Deque *deque = thisDeque(thread);
+    deque->count = 0;
+    deque->capacity = 0;
+    deque->head = 0;
+    deque->items = NULL;
+}
+
+static void dequeInitWithCapacity(Thread *thread){
+    dequeInit(thread);
+    EmojicodeInteger capacity = stackGetVariable(0, thread).raw;
+    if (capacity > 0) {
+        dequeReserve(capacity, thread);
+    }
+}
+
+static Something dequeAppendBridge(Thread *thread){
+    Deque *deque = dequeReserve(thisDeque(thread)->count + 1, thread);
+    items(deque)[dequeSlot(deque, deque->count++)] = stackGetVariable(0, thread);
+    return NOTHINGNESS;
+}
+
+static Something dequePrependBridge(Thread *thread){
+    Deque *deque = dequeReserve(thisDeque(thread)->count + 1, thread);
+    deque->head = (deque->head - 1) & (deque->capacity - 1);
+    deque->count++;
+    items(deque)[deque->head] = stackGetVariable(0, thread);
+    return NOTHINGNESS;
+}
+
+static Something dequePopLastBridge(Thread *thread){
+    Deque *deque = thisDeque(thread);
+    if (deque->count == 0) {
+        return NOTHINGNESS;
+    }
+    return items(deque)[dequeSlot(deque, --deque->count)];
+}
+
+static Something dequePopFirstBridge(Thread *thread){
+    Deque *deque = thisDeque(thread);
+    if (deque->count == 0) {
+        return NOTHINGNESS;
+    }
+    Something item = items(deque)[deque->head];
+    deque->head = dequeSlot(deque, 1);
+    deque->count--;
+    return item;
+}
+
+static Something dequeGetBridge(Thread *thread){
+    Deque *deque = thisDeque(thread);
+    size_t index;
+    if (!dequeIndex(deque, stackGetVariable(0, thread).raw, &index)) {
+        return NOTHINGNESS;
+    }
+    return items(deque)[dequeSlot(deque, index)];
+}
+
+static Something dequeSetBridge(Thread *thread){
+    Deque *deque = thisDeque(thread);
+    size_t index;
+    if (!dequeIndex(deque, stackGetVariable(0, thread).raw, &index)) {
+        return EMOJICODE_FALSE;
+    }
+    items(deque)[dequeSlot(deque, index)] = stackGetVariable(1, thread);
+    return EMOJICODE_TRUE;
+}
+
+static Something dequeCountBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)thisDeque(thread)->count);
+}
+
+static Something dequeClearBridge(Thread *thread){
+    Deque *deque = thisDeque(thread);
+    deque->count = 0;
+    deque->head = 0;
+    return NOTHINGNESS;
+}
+
+static Something dequeReserveBridge(Thread *thread){
+    EmojicodeInteger capacity = stackGetVariable(0, thread).raw;
+    if (capacity > 0) {
+        dequeReserve(capacity, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something dequeAppendListBridge(Thread *thread){
+    size_t added = ((List *)stackGetVariable(0, thread).object->value)->count;
+    if (added == 0) {
+        return NOTHINGNESS;
+    }
+    Deque *deque = dequeReserve(thisDeque(thread)->count + added, thread);
+    Something *listItems = ((List *)stackGetVariable(0, thread).object->value)->items->value;
+    
+    size_t tail = dequeSlot(deque, deque->count);
+    size_t firstPart = deque->capacity - tail;
+    if (firstPart > added) {
+        firstPart = added;
+    }
+    memcpy(items(deque) + tail, listItems, firstPart * sizeof(Something));
+    memcpy(items(deque), listItems + firstPart, (added - firstPart) * sizeof(Something));
+    deque->count += added;
+    return NOTHINGNESS;
+}
+
+static Something dequeToListBridge(Thread *thread){
+    size_t count = thisDeque(thread)->count;
+    
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
+    Object *listItems = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+    Deque *deque = thisDeque(thread);
+    List *list = stackGetVariable(0, thread).object->value;
+    list->items = listItems;
+    list->capacity = list->count = count;
+    
+    if (count) {
+        size_t firstPart = deque->capacity - deque->head;
+        if (firstPart > count) {
+            firstPart = count;
+        }
+        memcpy(listItems->value, items(deque) + deque->head, firstPart * sizeof(Something));
+        memcpy((Something *)listItems->value + firstPart, items(deque), (count - firstPart) * sizeof(Something));
+    }
+    
+    Something listSomething = stackGetVariable(0, thread);
+    stackPop(thread);
+    return listSomething;
+}
+
+FunctionFunctionPointer dequeMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1F43B: //🐻
+            return dequeAppendBridge;
+        case 0x1F42B: //🐫
+            return dequePrependBridge;
+        case 0x1F43C: //🐼
+            return dequePopLastBridge;
+        case 0x1F42A: //🐪
+            return dequePopFirstBridge;
+        case 0x1F43D: //🐽
+            return dequeGetBridge;
+        case 0x1F437: //🐷
+            return dequeSetBridge;
+        case 0x1F414: //🐔
+            return dequeCountBridge;
+        case 0x1F417: //🐗
+            return dequeClearBridge;
+        case 0x1F434: //🐴
+            return dequeReserveBridge;
+        case 0x1F419: //🐙
+            return dequeAppendListBridge;
+        case 0x1F42E: //🐮
+            return dequeToListBridge;
+    }
+    return NULL;
+}
+
+InitializerFunctionFunctionPointer dequeInitializerForName(EmojicodeChar name){
+    switch (name) {
+        case 0x1F427: //🐧
+            return dequeInitWithCapacity;
+        default:
+            return dequeInit;
+    }
+}
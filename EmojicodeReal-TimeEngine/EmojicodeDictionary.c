@@ -9,375 +9,457 @@
 #include "EmojicodeAPI.h"
 #include "EmojicodeDictionary.h"
 #include "EmojicodeString.h"
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
-#define FNV_PRIME_64 1099511628211
-#define FNV_OFFSET_64 14695981039346656037U
-EmojicodeDictionaryHash fnv64(const char *k, size_t length) {
-    EmojicodeDictionaryHash hash = FNV_OFFSET_64;
-    for(size_t i = 0; i < length; i++){
-        hash = hash ^ k[i];
-        hash = hash * FNV_PRIME_64;
+EmojicodeDictionaryHash dictionaryHash(EmojicodeDictionary *dict, Something key) {
+    if (dict->keyType == T_OBJECT) {
+        return stringHash((String *) key.object->value);
     }
-    return hash;
+    return integerHash(key.raw);
 }
 
-EmojicodeDictionaryHash dictionaryHash(EmojicodeDictionary *dict, Object *key) {
-    #define hashString(keyString) fnv64((char*)characters(keyString), ((keyString)->length) * sizeof(EmojicodeChar))
-    return hashString((String *) key->value);
+bool dictionaryKeyEqual(EmojicodeDictionary *dict, Something key1, Something key2) {
+    if (dict->keyType == T_OBJECT) {
+        return stringEqual((String *) key1.object->value, (String *) key2.object->value);
+    }
+    return key1.raw == key2.raw;
 }
 
-bool dictionaryKeyEqual(EmojicodeDictionary *dict, Object *key1, Object *key2) {
-    return stringEqual((String *) key1->value, (String *) key2->value);
+// MARK: Control bytes
+
+/** Returned by @c dictionaryFind if the key is not in the dictionary. */
+#define DICTIONARY_NOT_FOUND SIZE_MAX
+
+#define dictionaryH1(hash) ((hash) >> 7)
+#define dictionaryH2(hash) ((int8_t)((hash) & 0x7F))
+
+/** The number of bytes used for the control bytes, padded so that the following hashes are aligned. */
+static inline size_t controlSize(size_t capacity) {
+    return (capacity + DICTIONARY_GROUP_WIDTH + 7) & ~(size_t)7;
 }
 
-bool dictionaryKeyHashEqual(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash1, EmojicodeDictionaryHash hash2, Object *key1, Object *key2) {
-    return (hash1 == hash2) && dictionaryKeyEqual(dict, key1, key2);
+static inline int8_t* dictionaryControl(EmojicodeDictionary *dict) {
+    return (int8_t *)dict->table->value;
 }
 
-// MARK: Internal dictionary
-EmojicodeDictionaryNode* dictionaryGetNode(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash, Object *key) {
-    EmojicodeDictionaryNode *e;
-    Object** bucko;
-    size_t n = 0;
-    if (dict->buckets != NULL) {
-        bucko = (Object**) dict->buckets->value;
-        if ((n = dict->bucketsCounter) > 0) {
-            Object *firsto = bucko[hash & (n - 1)];
-            if (firsto != NULL) {
-                e = firsto->value;
-                if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                    return e;
-                }
-                Object *eo;
-                while ((eo = e->next)) {
-                    e = eo->value;
-                    if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                        return e;
-                    }
-                }
-            }
-        }
+static inline EmojicodeDictionaryHash* dictionaryHashes(EmojicodeDictionary *dict) {
+    return (EmojicodeDictionaryHash *)((Byte *)dict->table->value + controlSize(dict->capacity));
+}
+
+static inline Something* dictionaryKeySlots(EmojicodeDictionary *dict) {
+    return (Something *)(dictionaryHashes(dict) + dict->capacity);
+}
+
+static inline Something* dictionaryValueSlots(EmojicodeDictionary *dict) {
+    return (Something *)(dictionaryKeySlots(dict) + dict->capacity);
+}
+
+/** Sets the control byte of the given slot and its copy behind the end of the control bytes. */
+static inline void setControl(int8_t *control, size_t index, int8_t value, size_t capacity) {
+    control[index] = value;
+    if (index < DICTIONARY_GROUP_WIDTH) {
+        control[capacity + index] = value;
     }
-    return NULL;
 }
 
-/** @warning GC-Invoking */
-Object* dictionaryNewNode(Object **dicto, EmojicodeDictionaryHash hash, Object *key, Something value, Object *next, Thread *thread){
-    stackPush(somethingObject(*dicto), 0, 0, thread);
-    Object *nodeo = newArray(sizeof(EmojicodeDictionaryNode));
-    EmojicodeDictionaryNode *node = (EmojicodeDictionaryNode *) nodeo->value;
-    *dicto = stackGetThisObject(thread);
-    stackPop(thread);
-    
-    node->hash = hash;
-    node->key = key;
-    node->value = value;
-    node->next = next;
-    return nodeo;
+// The following functions return a bit mask whose nth bit is set if the nth control byte of the group matches.
+
+#ifdef __SSE2__
+
+static inline uint32_t groupMatch(const int8_t *group, int8_t h2) {
+    __m128i controls = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(h2)));
 }
 
-/** @warning GC-Invoking */
-Object* dictionaryResize(Object *dicto, Thread *thread) {
-    EmojicodeDictionary *dict = dicto->value;
+static inline uint32_t groupMatchEmpty(const int8_t *group) {
+    __m128i controls = _mm_loadu_si128((const __m128i *)group);
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(controls, _mm_set1_epi8(DICTIONARY_CONTROL_EMPTY)));
+}
+
+static inline uint32_t groupMatchEmptyOrDeleted(const int8_t *group) {
+    // Empty and deleted are the only control bytes with the sign bit set
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)group));
+}
+
+#else
+
+static inline uint32_t groupMatch(const int8_t *group, int8_t h2) {
+    uint32_t mask = 0;
+    for (int i = 0; i < DICTIONARY_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] == h2) << i;
+    }
+    return mask;
+}
+
+static inline uint32_t groupMatchEmpty(const int8_t *group) {
+    return groupMatch(group, DICTIONARY_CONTROL_EMPTY);
+}
+
+static inline uint32_t groupMatchEmptyOrDeleted(const int8_t *group) {
+    uint32_t mask = 0;
+    for (int i = 0; i < DICTIONARY_GROUP_WIDTH; i++) {
+        mask |= (uint32_t)(group[i] < 0) << i;
+    }
+    return mask;
+}
+
+#endif
 
-    Object *oldBuckoo = dict->buckets;
-    size_t oldCap = (oldBuckoo == NULL) ? 0 : dict->bucketsCounter;
-    size_t oldThr = dict->nextThreshold;
-    size_t newCap = oldCap << 1, newThr = 0;
+// MARK: Internal dictionary
+
+/**
+ * Returns the slot of @c key or @c DICTIONARY_NOT_FOUND. The groups are probed triangularly, which visits every group
+ * because the number of groups is a power of two.
+ */
+static size_t dictionaryFind(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash, Something key) {
+    if (dict->capacity == 0) {
+        return DICTIONARY_NOT_FOUND;
+    }
     
-    if (oldCap > 0) {
-        if (oldCap >= DICTIONARY_MAXIMUM_CAPACTIY) {
-            dict->nextThreshold = DICTIONARY_MAXIMUM_CAPACTIY_THRESHOLD;
-            return dicto;
+    int8_t *control = dictionaryControl(dict);
+    EmojicodeDictionaryHash *hashes = dictionaryHashes(dict);
+    Something *keys = dictionaryKeySlots(dict);
+    size_t mask = dict->capacity - 1;
+    size_t position = dictionaryH1(hash) & mask;
+    int8_t h2 = dictionaryH2(hash);
+    
+    for (size_t step = DICTIONARY_GROUP_WIDTH; ; step += DICTIONARY_GROUP_WIDTH) {
+        for (uint32_t match = groupMatch(control + position, h2); match; match &= match - 1) {
+            size_t index = (position + __builtin_ctz(match)) & mask;
+            if (hashes[index] == hash && dictionaryKeyEqual(dict, key, keys[index])) {
+                return index;
+            }
         }
-        else if (newCap < DICTIONARY_MAXIMUM_CAPACTIY && oldCap >= DICTIONARY_DEFAULT_INITIAL_CAPACITY) {
-            newThr = oldThr << 1; // double threshold
+        if (groupMatchEmpty(control + position)) {
+            return DICTIONARY_NOT_FOUND;
         }
+        position = (position + step) & mask;
     }
-    else if (oldThr > 0) { // initial capacity was placed in threshold
-        newCap = oldThr;
-    }
-    else { // zero initial threshold signifies using defaults
-        newCap = DICTIONARY_DEFAULT_INITIAL_CAPACITY;
-        newThr = (size_t) (DICTIONARY_DEFAULT_LOAD_FACTOR * DICTIONARY_DEFAULT_INITIAL_CAPACITY);
-    }
+}
+
+/** Returns the first empty or deleted slot in the probe sequence of @c hash. The table must not be full. */
+static size_t dictionaryFindInsertSlot(int8_t *control, size_t capacity, EmojicodeDictionaryHash hash) {
+    size_t mask = capacity - 1;
+    size_t position = dictionaryH1(hash) & mask;
     
-    if (newThr == 0) {
-        float ft = (float) newCap * dict->loadFactor;
-        newThr = (newCap < DICTIONARY_MAXIMUM_CAPACTIY && ft < (float)DICTIONARY_MAXIMUM_CAPACTIY) ? (size_t)ft : DICTIONARY_MAXIMUM_CAPACTIY_THRESHOLD;
+    for (size_t step = DICTIONARY_GROUP_WIDTH; ; step += DICTIONARY_GROUP_WIDTH) {
+        uint32_t match = groupMatchEmptyOrDeleted(control + position);
+        if (match) {
+            return (position + __builtin_ctz(match)) & mask;
+        }
+        position = (position + step) & mask;
+    }
+}
+
+/** Returns the smallest capacity at which @c size items can be stored without resizing. */
+static size_t dictionaryCapacityForSize(size_t size) {
+    size_t capacity = DICTIONARY_GROUP_WIDTH;
+    while (capacity - capacity / 8 < size) {
+        capacity *= 2;
     }
+    return capacity;
+}
+
+/**
+ * Moves all items into a new table with @c newCapacity slots, which also drops all deleted slots.
+ * @warning GC-Invoking
+ */
+static Object* dictionaryResize(Object *dicto, size_t newCapacity, Thread *thread) {
+    size_t slotSize = sizeof(EmojicodeDictionaryHash) +
+                      (((EmojicodeDictionary *)dicto->value)->storesValues ? 2 : 1) * sizeof(Something);
+    size_t tableSize = controlSize(newCapacity) + newCapacity * slotSize;
     
     stackPush(somethingObject(dicto), 0, 0, thread);
-    Object *newBuckoo = newArray(newCap * sizeof(Object *));
+    Object *newTable = newArray(tableSize);
     dicto = stackGetThisObject(thread);
-    dict = dicto->value;
     stackPop(thread);
     
-    dict->buckets = newBuckoo;
-    dict->nextThreshold = newThr;
-    dict->bucketsCounter = newCap;
+    EmojicodeDictionary *dict = dicto->value;
+    EmojicodeDictionary old = *dict;
     
-    Object **newBucko = newBuckoo->value;
-    if (oldBuckoo != NULL) {
-        for (int j = 0; j < oldCap; ++j) {
-            Object **oldBucko = oldBuckoo->value;
-            Object *eo = oldBucko[j];
-            if (eo != NULL) {
-                EmojicodeDictionaryNode *e = eo->value;
-                oldBucko[j] = NULL;
-                if (e->next == NULL) {
-                    newBucko[e->hash & (newCap - 1)] = eo;
-                }
-                else { // preserve order
-                    Object *loHeado = NULL, *loTailo = NULL;
-                    Object *hiHeado = NULL, *hiTailo = NULL;
-                    Object *nexto;
-                    do {
-                        e = eo->value;
-                        nexto = e->next;
-                        if ((e->hash & oldCap) == 0) {
-                            if (loTailo == NULL) {
-                                loHeado = eo;
-                            }
-                            else {
-                                EmojicodeDictionaryNode *loTail = loTailo->value;
-                                loTail->next = eo;
-                            }
-                            loTailo = eo;
-                        }
-                        else {
-                            if (hiTailo == NULL) {
-                                hiHeado = eo;
-                            }
-                            else {
-                                EmojicodeDictionaryNode *hiTail = hiTailo->value;
-                                hiTail->next = eo;
-                            }
-                            hiTailo = eo;
-                        }
-                    } while ((eo = nexto) != NULL);
-                    
-                    if (loTailo != NULL) {
-                        EmojicodeDictionaryNode *loTail = loTailo->value;
-                        loTail->next = NULL;
-                        newBucko[j] = loHeado;
-                    }
-                    if(hiTailo != NULL) {
-                        EmojicodeDictionaryNode *hiTail = hiTailo->value;
-                        hiTail->next = NULL;
-                        newBucko[j + oldCap] = hiHeado;
-                    }
-                }
-            }
+    dict->table = newTable;
+    dict->capacity = newCapacity;
+    dict->growthLeft = newCapacity - newCapacity / 8 - dict->size;
+    
+    int8_t *control = dictionaryControl(dict);
+    EmojicodeDictionaryHash *hashes = dictionaryHashes(dict);
+    Something *keys = dictionaryKeySlots(dict);
+    Something *values = dictionaryValueSlots(dict);
+    memset(control, DICTIONARY_CONTROL_EMPTY, newCapacity + DICTIONARY_GROUP_WIDTH);
+    
+    if (old.table == NULL) {
+        return dicto;
+    }
+    
+    int8_t *oldControl = dictionaryControl(&old);
+    EmojicodeDictionaryHash *oldHashes = dictionaryHashes(&old);
+    Something *oldKeys = dictionaryKeySlots(&old);
+    Something *oldValues = dictionaryValueSlots(&old);
+    for (size_t i = 0; i < old.capacity; i++) {
+        if (oldControl[i] < 0) {
+            continue;
+        }
+        EmojicodeDictionaryHash hash = oldHashes[i];
+        size_t index = dictionaryFindInsertSlot(control, newCapacity, hash);
+        setControl(control, index, dictionaryH2(hash), newCapacity);
+        hashes[index] = hash;
+        keys[index] = oldKeys[i];
+        if (dict->storesValues) {
+            values[index] = oldValues[i];
         }
     }
     return dicto;
 }
 
-void dictionaryPutVal(Object *dicto, Object *key, Something value, Thread *thread) {
+/**
+ * Makes sure that @c count more items can be inserted without resizing.
+ * @warning GC-Invoking
+ */
+static Object* dictionaryReserve(Object *dicto, size_t count, Thread *thread) {
+    EmojicodeDictionary *dict = dicto->value;
+    if (dict->table && dict->growthLeft >= count) {
+        return dicto;
+    }
+    size_t capacity = dictionaryCapacityForSize(dict->size + count);
+    return dictionaryResize(dicto, capacity < dict->capacity ? dict->capacity : capacity, thread);
+}
+
+/** Inserts a key that is not in the dictionary. There must be room for it, see @c dictionaryReserve. */
+static void dictionaryInsertNew(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash, Something key) {
+    int8_t *control = dictionaryControl(dict);
+    size_t index = dictionaryFindInsertSlot(control, dict->capacity, hash);
+    if (control[index] == DICTIONARY_CONTROL_EMPTY) {
+        dict->growthLeft--;
+    }
+    setControl(control, index, dictionaryH2(hash), dict->capacity);
+    dictionaryHashes(dict)[index] = hash;
+    dictionaryKeySlots(dict)[index] = key;
+    dict->size++;
+}
+
+/**
+ * Stores @c value for @c key. The value is ignored if the dictionary is a set.
+ * Returns true if the key was not in the dictionary before.
+ * @warning GC-Invoking
+ */
+static bool dictionaryPutVal(Object *dicto, Something key, Something value, Thread *thread) {
     EmojicodeDictionaryHash hash = dictionaryHash(dicto->value, key);
-    
     EmojicodeDictionary *dict = dicto->value;
     
-    if (dict->buckets == NULL || dict->bucketsCounter == 0) {
-        dicto = dictionaryResize(dicto, thread);
+    size_t index = dictionaryFind(dict, hash, key);
+    if (index != DICTIONARY_NOT_FOUND) {
+        if (dict->storesValues) {
+            dictionaryValueSlots(dict)[index] = value;
+        }
+        return false;
+    }
+    
+    if (dict->capacity == 0 ||
+        (dictionaryControl(dict)[index = dictionaryFindInsertSlot(dictionaryControl(dict), dict->capacity, hash)]
+         == DICTIONARY_CONTROL_EMPTY && dict->growthLeft == 0)) {
+        size_t newCapacity = DICTIONARY_GROUP_WIDTH;
+        if (dict->capacity > 0) {
+            // If many slots are only deleted, rehashing at the same capacity suffices
+            newCapacity = dict->size * 32 <= dict->capacity * 25 ? dict->capacity : dict->capacity * 2;
+        }
+        
+        stackPush(somethingObject(dicto), 2, 0, thread);
+        stackSetVariable(0, key, thread);
+        stackSetVariable(1, value, thread);
+        dicto = dictionaryResize(dicto, newCapacity, thread);
+        key = stackGetVariable(0, thread);
+        value = stackGetVariable(1, thread);
+        stackPop(thread);
+        
         dict = dicto->value;
+        index = dictionaryFindInsertSlot(dictionaryControl(dict), dict->capacity, hash);
     }
     
-    Object **bucko;
-    size_t n = 0, i = 0;
-    bucko = dict->buckets->value;
-    n = dict->bucketsCounter;
+    int8_t *control = dictionaryControl(dict);
+    if (control[index] == DICTIONARY_CONTROL_EMPTY) {
+        dict->growthLeft--;
+    }
+    setControl(control, index, dictionaryH2(hash), dict->capacity);
+    dictionaryHashes(dict)[index] = hash;
+    dictionaryKeySlots(dict)[index] = key;
+    if (dict->storesValues) {
+        dictionaryValueSlots(dict)[index] = value;
+    }
+    dict->size++;
+    return true;
+}
+
+/** Removes the item in the given slot. */
+static void dictionaryRemoveSlot(EmojicodeDictionary *dict, size_t index) {
+    int8_t *control = dictionaryControl(dict);
+    size_t mask = dict->capacity - 1;
     
-    Object *po;
+    // If a group containing the slot has never been full, no probe sequence continued past it and the slot
+    // can become empty again. Otherwise it must be marked as deleted so that lookups continue probing.
+    uint32_t emptyBefore = groupMatchEmpty(control + ((index - DICTIONARY_GROUP_WIDTH) & mask));
+    uint32_t emptyAfter = groupMatchEmpty(control + index);
+    bool wasNeverFull = emptyBefore && emptyAfter &&
+                        (__builtin_clz(emptyBefore) - (32 - DICTIONARY_GROUP_WIDTH)) + __builtin_ctz(emptyAfter)
+                            < DICTIONARY_GROUP_WIDTH;
     
-    if ((po = bucko[i = (hash & (n - 1))]) == NULL) {
-        bucko[i] = dictionaryNewNode(&dicto, hash, key, value, NULL, thread);
-        dict = dicto->value;
+    if (wasNeverFull) {
+        setControl(control, index, DICTIONARY_CONTROL_EMPTY, dict->capacity);
+        dict->growthLeft++;
     }
     else {
-        EmojicodeDictionaryNode *p = po->value;
-        Object *eo = NULL;
-        if (dictionaryKeyHashEqual(dict, hash, p->hash, key, p->key)) {
-            eo = po;
-        }
-        else {
-            for (int binCount = 0; ; ++binCount) {
-                if (p->next == NULL) {
-                    p->next = dictionaryNewNode(&dicto, hash, key, value, NULL, thread);
-                    dict = dicto->value;
-                    break;
-                }
-                eo = p->next;
-                EmojicodeDictionaryNode *e = eo->value;
-                
-                if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                    break;
-                }
-                p = e;
-            }
-        }
-        if (eo != NULL) { // existing mapping for key
-            EmojicodeDictionaryNode *e = eo->value;
-            e->value = value;
-            return;
-        }
+        setControl(control, index, DICTIONARY_CONTROL_DELETED, dict->capacity);
     }
-    if(++(dict->size) > dict->nextThreshold) {
-        dicto = dictionaryResize(dicto, thread);
-        dict = dicto->value;
+    dictionaryKeySlots(dict)[index] = NOTHINGNESS;
+    if (dict->storesValues) {
+        dictionaryValueSlots(dict)[index] = NOTHINGNESS;
     }
+    dict->size--;
 }
 
-EmojicodeDictionaryNode* dictionaryRemoveNode(EmojicodeDictionary *dict, EmojicodeDictionaryHash hash, Object *key, Thread *thread) {
-    size_t n = 0, index = 0;
-    if (dict->buckets != NULL && (n = dict->bucketsCounter) > 0) {
-        Object **bucko = dict->buckets->value;
-        Object *po = bucko[index = hash & (n - 1)];
-        if (po != NULL) {
-            EmojicodeDictionaryNode *p = po->value;
-            EmojicodeDictionaryNode *node = NULL;
-            if (dictionaryKeyHashEqual(dict, hash, p->hash, key, p->key)) {
-                node = p;
-            }
-            else {
-                Object *nexto = p->next;
-                while (nexto) {
-                    EmojicodeDictionaryNode *e = nexto->value;
-                    if (dictionaryKeyHashEqual(dict, hash, e->hash, key, e->key)) {
-                        node = e;
-                        break;
-                    }
-                    p = e;
-                    nexto = e->next;
-                }
-            }
-            if(node != NULL) {
-                if (node == p) {
-                    bucko[index] = node->next;
-                }
-                else {
-                    p->next = node->next;
-                }
-                dict->size--;
-                return node;
-            }
-        }
+// MARK: Bridge -> Dictionary interface
+void dictionaryRemove(EmojicodeDictionary *dict, Something key, Thread *thread) {
+    size_t index = dictionaryFind(dict, dictionaryHash(dict, key), key);
+    if (index != DICTIONARY_NOT_FOUND) {
+        dictionaryRemoveSlot(dict, index);
     }
-    return NULL;
 }
 
-
-// MARK: Bridge -> Dictionary interface
-void dictionaryRemove(EmojicodeDictionary *dict, Object *key, Thread *thread) {
-    dictionaryRemoveNode(dict, dictionaryHash(dict, key), key, thread);
+Something dictionaryLookup(EmojicodeDictionary *dict, Something key, Thread *thread) {
+    size_t index = dictionaryFind(dict, dictionaryHash(dict, key), key);
+    if (index == DICTIONARY_NOT_FOUND) {
+        return NOTHINGNESS;
+    }
+    return dictionaryValueSlots(dict)[index];
 }
 
-bool dictionaryContains(EmojicodeDictionary *dict, Object *key) {
-    return dictionaryGetNode(dict, dictionaryHash(dict, key), key) != NULL;
+bool dictionaryContains(EmojicodeDictionary *dict, Something key) {
+    return dictionaryFind(dict, dictionaryHash(dict, key), key) != DICTIONARY_NOT_FOUND;
 }
 
 size_t dictionaryClear(EmojicodeDictionary *dict) {
     size_t sizeBefore = dict->size;
-    dict->loadFactor = DICTIONARY_DEFAULT_LOAD_FACTOR;
+    dict->table = NULL;
+    dict->capacity = 0;
     dict->size = 0;
-    dict->buckets = NULL;
-    dict->nextThreshold = 0;
+    dict->growthLeft = 0;
     return sizeBefore;
 }
 
 Something dictionaryKeys(Object *dicto, Thread *thread) {
-    stackPush(somethingObject(dicto), 2, 0, thread);
+    stackPush(somethingObject(dicto), 1, 0, thread);
     
-    {
-        Object *listObject = newObject(CL_LIST);
-        stackSetVariable(0, somethingObject(listObject), thread);
-        
-        dicto = stackGetThisObject(thread);
-        EmojicodeDictionary *dict = dicto->value;
-        
-        List *newList = listObject->value;
-        newList->capacity = dict->size;
-        Object *items = newArray(sizeof(Something) * dict->size);
-        ((List *)stackGetVariable(0, thread).object->value)->items = items;
-    }
+    Object *listObject = newObject(CL_LIST);
+    stackSetVariable(0, somethingObject(listObject), thread);
     
-    dicto = stackGetThisObject(thread);
-    EmojicodeDictionary *dict = dicto->value;
+    size_t size = ((EmojicodeDictionary *)stackGetThisObject(thread)->value)->size;
+    Object *items = newArray(sizeof(Something) * size);
     
-    for (size_t i = 0; i < dict->bucketsCounter; i++) {
-        Object **bucko = (Object **)dict->buckets->value;
-        Object *nodeo = bucko[i];
-        while (nodeo) {
-            stackSetVariable(1, somethingObject(nodeo), thread);
-            
-            listAppend(stackGetVariable(0, thread).object, somethingObject(((EmojicodeDictionaryNode *) nodeo->value)->key), thread);
-
-            nodeo = ((EmojicodeDictionaryNode *) stackGetVariable(1, thread).object->value)->next;
-            
-            dicto = stackGetThisObject(thread);
-            dict = dicto->value;
+    listObject = stackGetVariable(0, thread).object;
+    EmojicodeDictionary *dict = stackGetThisObject(thread)->value;
+    stackPop(thread);
+    
+    List *list = listObject->value;
+    list->items = items;
+    list->capacity = size;
+    list->count = size;
+    
+    if (dict->table) {
+        Something *listItems = items->value;
+        int8_t *control = dictionaryControl(dict);
+        Something *keys = dictionaryKeySlots(dict);
+        for (size_t i = 0, j = 0; i < dict->capacity; i++) {
+            if (control[i] >= 0) {
+                listItems[j++] = keys[i];
+            }
         }
     }
     
-    Something listSth = stackGetVariable(0, thread);
-    stackPop(thread);
-    
-    return listSth;
+    return somethingObject(listObject);
 }
 
-void dictionaryInit(Thread *thread) {
+bool dictionaryNextItem(EmojicodeDictionary *dict, size_t *slot, Something *key, Something *value) {
+    if (!dict->table) {
+        return false;
+    }
+    int8_t *control = dictionaryControl(dict);
+    size_t i = *slot;
+    while (i < dict->capacity) {
+        if (i % DICTIONARY_GROUP_WIDTH == 0 && groupMatchEmptyOrDeleted(control + i) == 0xFFFF) {
+            i += DICTIONARY_GROUP_WIDTH;
+            continue;
+        }
+        if (control[i] >= 0) {
+            *key = dictionaryKeySlots(dict)[i];
+            if (value) {
+                *value = dict->storesValues ? dictionaryValueSlots(dict)[i] : NOTHINGNESS;
+            }
+            *slot = i + 1;
+            return true;
+        }
+        i++;
+    }
+    *slot = i;
+    return false;
+}
+
+static void dictionaryInitWithKeyType(Thread *thread, Type keyType) {
     EmojicodeDictionary *dict = stackGetThisObject(thread)->value;
-    dict->loadFactor = DICTIONARY_DEFAULT_LOAD_FACTOR;
+    dict->table = NULL;
+    dict->capacity = 0;
+    dict->size = 0;
+    dict->growthLeft = 0;
+    dict->keyType = keyType;
+    dict->storesValues = true;
+}
+
+void dictionaryInit(Thread *thread) {
+    dictionaryInitWithKeyType(thread, T_OBJECT);
 }
 
 void dictionaryMark(Object *object) {
     EmojicodeDictionary *dict = object->value;
     
-    if(dict->buckets == NULL){
+    if (dict->table == NULL) {
         return;
     }
-    mark(&dict->buckets);
+    mark(&dict->table);
     
-    Object **buckets = dict->buckets->value;
-    for (size_t i = 0; i < dict->bucketsCounter; i++) {
-        Object **eo = &buckets[i];
-        while (*(eo)) {
-            mark(eo);
-            EmojicodeDictionaryNode *e = (*eo)->value;
-            mark(&(e->key));
-            if (isRealObject(e->value)){
-                mark(&(e->value.object));
-            }
-            eo = &(e->next);
+    int8_t *control = dictionaryControl(dict);
+    Something *keys = dictionaryKeySlots(dict);
+    Something *values = dictionaryValueSlots(dict);
+    for (size_t i = 0; i < dict->capacity; i++) {
+        if (control[i] < 0) {
+            continue;
+        }
+        if (isRealObject(keys[i])) {
+            mark(&keys[i].object);
+        }
+        if (dict->storesValues && isRealObject(values[i])) {
+            mark(&values[i].object);
         }
     }
 }
 
-void dictionarySet(Object *dicto, Object *key, Something value, Thread *thread){
+void dictionarySet(Object *dicto, Something key, Something value, Thread *thread){
     dictionaryPutVal(dicto, key, value, thread);
 }
 
 //MARK: Bridges
 
 static Something bridgeDictionarySet(Thread *thread) {
-    dictionarySet(stackGetThisObject(thread), stackGetVariable(0, thread).object, stackGetVariable(1, thread), thread);
+    dictionarySet(stackGetThisObject(thread), stackGetVariable(0, thread), stackGetVariable(1, thread), thread);
     return NOTHINGNESS;
 }
 
 static Something bridgeDictionaryGet(Thread *thread) {
-    Object *key = stackGetVariable(0, thread).object;
-    EmojicodeDictionaryNode *node = dictionaryGetNode(stackGetThisObject(thread)->value, dictionaryHash(stackGetThisObject(thread)->value, key), key);
-    if(node == NULL){
-        return NOTHINGNESS;
-    }
-    else {
-        return node->value;
-    }
+    return dictionaryLookup(stackGetThisObject(thread)->value, stackGetVariable(0, thread), thread);
 }
 
 static Something bridgeDictionaryRemove(Thread *thread) {
-    dictionaryRemove(stackGetThisObject(thread)->value, stackGetVariable(0, thread).object, thread);
+    dictionaryRemove(stackGetThisObject(thread)->value, stackGetVariable(0, thread), thread);
     return NOTHINGNESS;
 }
 
@@ -390,8 +472,7 @@ static Something bridgeDictionaryClear(Thread *thread) {
 }
 
 static Something bridgeDictionaryContains(Thread *thread) {
-    Object *key = stackGetVariable(0, thread).object;
-    return somethingBoolean(dictionaryContains(stackGetThisObject(thread)->value, key));
+    return somethingBoolean(dictionaryContains(stackGetThisObject(thread)->value, stackGetVariable(0, thread)));
 }
 
 static Something bridgeDictionarySize(Thread *thread) {
@@ -402,6 +483,14 @@ void bridgeDictionaryInit(Thread *thread) {
     dictionaryInit(thread);
 }
 
+void bridgeIntegerDictionaryInit(Thread *thread) {
+    dictionaryInitWithKeyType(thread, T_INTEGER);
+}
+
+void bridgeSymbolDictionaryInit(Thread *thread) {
+    dictionaryInitWithKeyType(thread, T_SYMBOL);
+}
+
 FunctionFunctionPointer dictionaryMethodForName(EmojicodeChar name) {
     switch (name) {
         case 0x1F43D: //🐽
@@ -421,3 +510,230 @@ FunctionFunctionPointer dictionaryMethodForName(EmojicodeChar name) {
     }
     return NULL;
 }
+
+//MARK: Sets
+
+static void setInitWithKeyType(Thread *thread, Type keyType) {
+    dictionaryInitWithKeyType(thread, keyType);
+    ((EmojicodeDictionary *)stackGetThisObject(thread)->value)->storesValues = false;
+}
+
+void bridgeStringSetInit(Thread *thread) {
+    setInitWithKeyType(thread, T_OBJECT);
+}
+
+void bridgeIntegerSetInit(Thread *thread) {
+    setInitWithKeyType(thread, T_INTEGER);
+}
+
+void bridgeSymbolSetInit(Thread *thread) {
+    setInitWithKeyType(thread, T_SYMBOL);
+}
+
+static Type setKeyTypeForClass(EmojicodeChar cl) {
+    switch (cl) {
+        case 0x1f5c4: //🗄
+            return T_INTEGER;
+        case 0x1f5f3: //🗳
+            return T_SYMBOL;
+    }
+    return T_OBJECT;
+}
+
+#define setCapacityInitializer(keyType, name) static void name(Thread *thread) {\
+    setInitWithKeyType(thread, keyType);\
+    EmojicodeInteger capacity = stackGetVariable(0, thread).raw;\
+    if (capacity > 0) {\
+        dictionaryReserve(stackGetThisObject(thread), capacity, thread);\
+    }\
+}
+
+setCapacityInitializer(T_OBJECT, bridgeStringSetInitCapacity)
+setCapacityInitializer(T_INTEGER, bridgeIntegerSetInitCapacity)
+setCapacityInitializer(T_SYMBOL, bridgeSymbolSetInitCapacity)
+
+/**
+ * Creates an empty set of the same class as the set in the this-slot that can store @c count items without resizing.
+ * @warning GC-Invoking
+ */
+static Object* setNewLikeThis(size_t count, Thread *thread) {
+    Object *thiso = stackGetThisObject(thread);
+    Object *seto = newObject(thiso->class);
+    EmojicodeDictionary *set = seto->value;
+    set->table = NULL;
+    set->capacity = 0;
+    set->size = 0;
+    set->growthLeft = 0;
+    set->keyType = ((EmojicodeDictionary *)stackGetThisObject(thread)->value)->keyType;
+    set->storesValues = false;
+    if (count > 0) {
+        seto = dictionaryReserve(seto, count, thread);
+    }
+    return seto;
+}
+
+static Something bridgeSetInsert(Thread *thread) {
+    return somethingBoolean(dictionaryPutVal(stackGetThisObject(thread), stackGetVariable(0, thread), NOTHINGNESS,
+                                             thread));
+}
+
+static Something bridgeSetRemove(Thread *thread) {
+    EmojicodeDictionary *set = stackGetThisObject(thread)->value;
+    Something key = stackGetVariable(0, thread);
+    size_t index = dictionaryFind(set, dictionaryHash(set, key), key);
+    if (index == DICTIONARY_NOT_FOUND) {
+        return EMOJICODE_FALSE;
+    }
+    dictionaryRemoveSlot(set, index);
+    return EMOJICODE_TRUE;
+}
+
+static Something bridgeSetInsertList(Thread *thread) {
+    List *list = stackGetVariable(0, thread).object->value;
+    Object *seto = dictionaryReserve(stackGetThisObject(thread), list->count, thread);
+    
+    // No more garbage collection can happen, so the pointers stay valid
+    EmojicodeDictionary *set = seto->value;
+    list = stackGetVariable(0, thread).object->value;
+    Something *items = list->items ? list->items->value : NULL;
+    size_t sizeBefore = set->size;
+    for (size_t i = 0; i < list->count; i++) {
+        EmojicodeDictionaryHash hash = dictionaryHash(set, items[i]);
+        if (dictionaryFind(set, hash, items[i]) == DICTIONARY_NOT_FOUND) {
+            dictionaryInsertNew(set, hash, items[i]);
+        }
+    }
+    return somethingInteger((EmojicodeInteger)(set->size - sizeBefore));
+}
+
+/** Inserts all items of @c source that are (or are not, if @c contained is false) in @c filter into @c destination. */
+static void setInsertFiltered(EmojicodeDictionary *destination, EmojicodeDictionary *source,
+                              EmojicodeDictionary *filter, bool contained) {
+    if (source->table == NULL) {
+        return;
+    }
+    int8_t *control = dictionaryControl(source);
+    EmojicodeDictionaryHash *hashes = dictionaryHashes(source);
+    Something *keys = dictionaryKeySlots(source);
+    for (size_t i = 0; i < source->capacity; i++) {
+        if (control[i] < 0) {
+            continue;
+        }
+        if (filter && (dictionaryFind(filter, hashes[i], keys[i]) != DICTIONARY_NOT_FOUND) != contained) {
+            continue;
+        }
+        dictionaryInsertNew(destination, hashes[i], keys[i]);
+    }
+}
+
+static Something bridgeSetUnion(Thread *thread) {
+    EmojicodeDictionary *a = stackGetThisObject(thread)->value;
+    EmojicodeDictionary *b = stackGetVariable(0, thread).object->value;
+    Object *resulto = setNewLikeThis(a->size + b->size, thread);
+    
+    a = stackGetThisObject(thread)->value;
+    b = stackGetVariable(0, thread).object->value;
+    if (a->size < b->size) {
+        EmojicodeDictionary *t = a;
+        a = b;
+        b = t;
+    }
+    setInsertFiltered(resulto->value, a, NULL, false);
+    setInsertFiltered(resulto->value, b, a, false);
+    return somethingObject(resulto);
+}
+
+static Something bridgeSetIntersection(Thread *thread) {
+    EmojicodeDictionary *a = stackGetThisObject(thread)->value;
+    EmojicodeDictionary *b = stackGetVariable(0, thread).object->value;
+    Object *resulto = setNewLikeThis(a->size < b->size ? a->size : b->size, thread);
+    
+    a = stackGetThisObject(thread)->value;
+    b = stackGetVariable(0, thread).object->value;
+    if (a->size > b->size) {
+        EmojicodeDictionary *t = a;
+        a = b;
+        b = t;
+    }
+    setInsertFiltered(resulto->value, a, b, true);
+    return somethingObject(resulto);
+}
+
+static Something bridgeSetDifference(Thread *thread) {
+    Object *resulto = setNewLikeThis(((EmojicodeDictionary *)stackGetThisObject(thread)->value)->size, thread);
+    setInsertFiltered(resulto->value, stackGetThisObject(thread)->value, stackGetVariable(0, thread).object->value,
+                      false);
+    return somethingObject(resulto);
+}
+
+/** Whether all keys of @c a are in @c b. */
+static bool setIsSubset(EmojicodeDictionary *a, EmojicodeDictionary *b) {
+    if (a->size > b->size) {
+        return false;
+    }
+    if (a->table == NULL) {
+        return true;
+    }
+    int8_t *control = dictionaryControl(a);
+    EmojicodeDictionaryHash *hashes = dictionaryHashes(a);
+    Something *keys = dictionaryKeySlots(a);
+    for (size_t i = 0; i < a->capacity; i++) {
+        if (control[i] >= 0 && dictionaryFind(b, hashes[i], keys[i]) == DICTIONARY_NOT_FOUND) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static Something bridgeSetIsSubset(Thread *thread) {
+    return somethingBoolean(setIsSubset(stackGetThisObject(thread)->value, stackGetVariable(0, thread).object->value));
+}
+
+static Something bridgeSetEqual(Thread *thread) {
+    EmojicodeDictionary *a = stackGetThisObject(thread)->value;
+    EmojicodeDictionary *b = stackGetVariable(0, thread).object->value;
+    return somethingBoolean(a->size == b->size && setIsSubset(a, b));
+}
+
+InitializerFunctionFunctionPointer setInitializerForName(EmojicodeChar cl, EmojicodeChar name) {
+    Type keyType = setKeyTypeForClass(cl);
+    switch (name) {
+        case 0x1F438: //🐸
+            return keyType == T_INTEGER ? bridgeIntegerSetInit :
+                   keyType == T_SYMBOL ? bridgeSymbolSetInit : bridgeStringSetInit;
+        case 0x1F427: //🐧
+            return keyType == T_INTEGER ? bridgeIntegerSetInitCapacity :
+                   keyType == T_SYMBOL ? bridgeSymbolSetInitCapacity : bridgeStringSetInitCapacity;
+    }
+    return NULL;
+}
+
+FunctionFunctionPointer setMethodForName(EmojicodeChar name) {
+    switch (name) {
+        case 0x1F437: //🐷
+            return bridgeSetInsert;
+        case 0x1F428: //🐨
+            return bridgeSetRemove;
+        case 0x1F423: //🐣
+            return bridgeDictionaryContains;
+        case 0x1F414: //🐔
+            return bridgeDictionarySize;
+        case 0x1F417: //🐗
+            return bridgeDictionaryClear;
+        case 0x1F419: //🐙
+            return bridgeDictionaryKeys;
+        case 0x1F418: //🐘
+            return bridgeSetInsertList;
+        case 0x1F433: //🐳
+            return bridgeSetUnion;
+        case 0x1F420: //🐠
+            return bridgeSetIntersection;
+        case 0x1F41F: //🐟
+            return bridgeSetDifference;
+        case 0x1F429: //🐩
+            return bridgeSetIsSubset;
+        case 0x1F61B: //😛
+            return bridgeSetEqual;
+    }
+    return NULL;
+}
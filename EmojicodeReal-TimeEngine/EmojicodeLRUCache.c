@@ -0,0 +1,368 @@
+//
+//  EmojicodeLRUCache.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeLRUCache.h"
+#include "EmojicodeList.h"
+#include "EmojicodeString.h"
+
+#include <string.h>
+#include <time.h>
+
+#define entries(cache) ((LRUCacheEntry *)(cache)->entries->value)
+#define slots(cache) ((uint32_t *)(cache)->index->value)
+
+static inline LRUCache* thisCache(Thread *thread){
+    return stackGetThisObject(thread)->value;
+}
+
+void lruCacheMark(Object *self){
+    LRUCache *cache = self->value;
+    if (cache->index) {
+        mark(&cache->index);
+    }
+    if (cache->entries) {
+        mark(&cache->entries);
+        LRUCacheEntry *entries = entries(cache);
+        for (uint32_t i = 0; i < cache->count; i++) {
+            mark(&entries[i].key.object);
+            if (isRealObject(entries[i].value)) {
+                mark(&entries[i].value.object);
+            }
+        }
+    }
+}
+
+/** Returns the time of the monotonic clock in nanoseconds. */
+static uint64_t lruCacheNow(){
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return (uint64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+}
+
+static inline bool lruCacheIsExpired(LRUCacheEntry *entry, uint64_t now){
+    return entry->expiry && entry->expiry <= now;
+}
+
+//MARK: Index
+
+/** Returns the slot of the index that refers to the entry with @c key or the empty slot where it would be inserted. */
+static uint32_t lruCacheFindSlot(LRUCache *cache, uint64_t hash, String *key){
+    uint32_t mask = cache->indexCapacity - 1;
+    for (uint32_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        uint32_t e = slots(cache)[slot];
+        if (e == LRU_CACHE_NONE) {
+            return slot;
+        }
+        LRUCacheEntry *entry = entries(cache) + e;
+        if (entry->hash == hash && stringEqual(entry->key.object->value, key)) {
+            return slot;
+        }
+    }
+}
+
+/** Returns the slot of the index that refers to the entry @c e. */
+static uint32_t lruCacheSlotOfEntry(LRUCache *cache, uint32_t e){
+    uint32_t mask = cache->indexCapacity - 1;
+    uint32_t slot = entries(cache)[e].hash & mask;
+    while (slots(cache)[slot] != e) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+/** Empties @c slot and moves the following slots back, so that no lookup has to probe past a removed entry. */
+static void lruCacheRemoveSlot(LRUCache *cache, uint32_t slot){
+    uint32_t mask = cache->indexCapacity - 1, *slots = slots(cache);
+    uint32_t hole = slot;
+    for (uint32_t i = (slot + 1) & mask; slots[i] != LRU_CACHE_NONE; i = (i + 1) & mask) {
+        uint32_t home = entries(cache)[slots[i]].hash & mask;
+        // The entry can fill the hole if the hole is between its home slot and its slot
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            slots[hole] = slots[i];
+            hole = i;
+        }
+    }
+    slots[hole] = LRU_CACHE_NONE;
+}
+
+//MARK: Recency list
+
+static void lruCacheUnlink(LRUCache *cache, uint32_t e){
+    LRUCacheEntry *entries = entries(cache);
+    if (entries[e].previous != LRU_CACHE_NONE) {
+        entries[entries[e].previous].next = entries[e].next;
+    }
+    else {
+        cache->head = entries[e].next;
+    }
+    if (entries[e].next != LRU_CACHE_NONE) {
+        entries[entries[e].next].previous = entries[e].previous;
+    }
+    else {
+        cache->tail = entries[e].previous;
+    }
+}
+
+static void lruCachePushFront(LRUCache *cache, uint32_t e){
+    LRUCacheEntry *entries = entries(cache);
+    entries[e].previous = LRU_CACHE_NONE;
+    entries[e].next = cache->head;
+    if (cache->head != LRU_CACHE_NONE) {
+        entries[cache->head].previous = e;
+    }
+    else {
+        cache->tail = e;
+    }
+    cache->head = e;
+}
+
+/** Marks the entry @c e as the most recently used entry. */
+static void lruCacheTouch(LRUCache *cache, uint32_t e){
+    if (cache->head != e) {
+        lruCacheUnlink(cache, e);
+        lruCachePushFront(cache, e);
+    }
+}
+
+//MARK: Entries
+
+/** Removes the entry @c e and moves the last entry to its position. */
+static void lruCacheRemoveEntry(LRUCache *cache, uint32_t e){
+    lruCacheRemoveSlot(cache, lruCacheSlotOfEntry(cache, e));
+    lruCacheUnlink(cache, e);
+    
+    uint32_t last = --cache->count;
+    if (e == last) {
+        return;
+    }
+    LRUCacheEntry *entries = entries(cache);
+    slots(cache)[lruCacheSlotOfEntry(cache, last)] = e;
+    entries[e] = entries[last];
+    if (entries[e].previous != LRU_CACHE_NONE) {
+        entries[entries[e].previous].next = e;
+    }
+    else {
+        cache->head = e;
+    }
+    if (entries[e].next != LRU_CACHE_NONE) {
+        entries[entries[e].next].previous = e;
+    }
+    else {
+        cache->tail = e;
+    }
+}
+
+/**
+ * Returns the entry of the string @c key or @c LRU_CACHE_NONE if there is none. An expired entry is removed and
+ * @c LRU_CACHE_NONE is returned.
+ */
+static uint32_t lruCacheFind(LRUCache *cache, Something key){
+    String *string = key.object->value;
+    uint32_t e = slots(cache)[lruCacheFindSlot(cache, stringHash(string), string)];
+    if (e != LRU_CACHE_NONE && entries(cache)[e].expiry && entries(cache)[e].expiry <= lruCacheNow()) {
+        lruCacheRemoveEntry(cache, e);
+        return LRU_CACHE_NONE;
+    }
+    return e;
+}
+
+/**
+ * Assigns @c value to the string @c key and makes it the most recently used item. If the cache is full, the least
+ * recently used item is evicted. Never allocates.
+ */
+static void lruCachePut(LRUCache *cache, Something key, Something value, uint64_t expiry){
+    String *string = key.object->value;
+    uint64_t hash = stringHash(string);
+    uint32_t slot = lruCacheFindSlot(cache, hash, string);
+    uint32_t e = slots(cache)[slot];
+    
+    if (e == LRU_CACHE_NONE) {
+        if (cache->count == cache->capacity) {
+            lruCacheRemoveEntry(cache, cache->tail);
+            slot = lruCacheFindSlot(cache, hash, string);
+        }
+        e = cache->count++;
+        slots(cache)[slot] = e;
+        entries(cache)[e].key = key;
+        entries(cache)[e].hash = hash;
+        lruCachePushFront(cache, e);
+    }
+    else {
+        lruCacheTouch(cache, e);
+    }
+    entries(cache)[e].value = value;
+    entries(cache)[e].expiry = expiry;
+}
+
+//MARK: Bridges
+
+static Something lruCacheGetBridge(Thread *thread){
+    LRUCache *cache = thisCache(thread);
+    uint32_t e = lruCacheFind(cache, stackGetVariable(0, thread));
+    if (e == LRU_CACHE_NONE) {
+        cache->misses++;
+        return NOTHINGNESS;
+    }
+    cache->hits++;
+    lruCacheTouch(cache, e);
+    return entries(cache)[e].value;
+}
+
+static Something lruCacheSetBridge(Thread *thread){
+    lruCachePut(thisCache(thread), stackGetVariable(0, thread), stackGetVariable(1, thread), 0);
+    return NOTHINGNESS;
+}
+
+static Something lruCacheSetWithTimeToLiveBridge(Thread *thread){
+    LRUCache *cache = thisCache(thread);
+    double timeToLive = unwrapDouble(stackGetVariable(2, thread));
+    if (timeToLive <= 0) {
+        uint32_t e = lruCacheFind(cache, stackGetVariable(0, thread));
+        if (e != LRU_CACHE_NONE) {
+            lruCacheRemoveEntry(cache, e);
+        }
+        return NOTHINGNESS;
+    }
+    uint64_t expiry = lruCacheNow() + (uint64_t)(timeToLive * 1000000000);
+    lruCachePut(cache, stackGetVariable(0, thread), stackGetVariable(1, thread), expiry);
+    return NOTHINGNESS;
+}
+
+static Something lruCacheContainsBridge(Thread *thread){
+    return somethingBoolean(lruCacheFind(thisCache(thread), stackGetVariable(0, thread)) != LRU_CACHE_NONE);
+}
+
+static Something lruCacheRemoveBridge(Thread *thread){
+    LRUCache *cache = thisCache(thread);
+    uint32_t e = lruCacheFind(cache, stackGetVariable(0, thread));
+    if (e == LRU_CACHE_NONE) {
+        return EMOJICODE_FALSE;
+    }
+    lruCacheRemoveEntry(cache, e);
+    return EMOJICODE_TRUE;
+}
+
+static Something lruCacheGetOrComputeBridge(Thread *thread){
+    LRUCache *cache = thisCache(thread);
+    uint32_t e = lruCacheFind(cache, stackGetVariable(0, thread));
+    if (e != LRU_CACHE_NONE) {
+        cache->hits++;
+        lruCacheTouch(cache, e);
+        return entries(cache)[e].value;
+    }
+    cache->misses++;
+    
+    Something key = stackGetVariable(0, thread);
+    Something value = executeCallableExtern(stackGetVariable(1, thread).object, &key, thread);
+    // The callable might have moved or modified the cache
+    lruCachePut(thisCache(thread), stackGetVariable(0, thread), value, 0);
+    return value;
+}
+
+static Something lruCacheCountBridge(Thread *thread){
+    return somethingInteger(thisCache(thread)->count);
+}
+
+static Something lruCacheClearBridge(Thread *thread){
+    LRUCache *cache = thisCache(thread);
+    cache->count = 0;
+    cache->head = cache->tail = LRU_CACHE_NONE;
+    memset(slots(cache), 0xFF, cache->indexCapacity * sizeof(uint32_t));
+    return NOTHINGNESS;
+}
+
+static Something lruCacheHitsBridge(Thread *thread){
+    return somethingInteger(thisCache(thread)->hits);
+}
+
+static Something lruCacheMissesBridge(Thread *thread){
+    return somethingInteger(thisCache(thread)->misses);
+}
+
+static Something lruCacheKeysBridge(Thread *thread){
+    size_t count = thisCache(thread)->count;
+    
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
+    Object *listItems = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+    List *list = stackGetVariable(0, thread).object->value;
+    LRUCache *cache = thisCache(thread);
+    list->items = listItems;
+    list->capacity = count;
+    
+    uint64_t now = lruCacheNow();
+    Something *out = listItems->value;
+    for (uint32_t e = cache->head; e != LRU_CACHE_NONE; e = entries(cache)[e].next) {
+        if (!lruCacheIsExpired(entries(cache) + e, now)) {
+            out[list->count++] = entries(cache)[e].key;
+        }
+    }
+    
+    Something listSomething = stackGetVariable(0, thread);
+    stackPop(thread);
+    return listSomething;
+}
+
+FunctionFunctionPointer lruCacheMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1F43D: //🐽
+            return lruCacheGetBridge;
+        case 0x1F437: //🐷
+            return lruCacheSetBridge;
+        case 0x23F0: //⏰
+            return lruCacheSetWithTimeToLiveBridge;
+        case 0x1F423: //🐣
+            return lruCacheContainsBridge;
+        case 0x1F428: //🐨
+            return lruCacheRemoveBridge;
+        case 0x1F372: //🍲
+            return lruCacheGetOrComputeBridge;
+        case 0x1F414: //🐔
+            return lruCacheCountBridge;
+        case 0x1F417: //🐗
+            return lruCacheClearBridge;
+        case 0x1F3AF: //🎯
+            return lruCacheHitsBridge;
+        case 0x1F4A8: //💨
+            return lruCacheMissesBridge;
+        case 0x1F419: //🐙
+            return lruCacheKeysBridge;
+    }
+    return NULL;
+}
+
+//MARK: Initializer
+
+static void lruCacheInitWithCapacity(Thread *thread){
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity < 1 || capacity > (1 << 30)) {
+        error("The capacity of a 🎒 must be between 1 and 2^30.");
+    }
+    uint32_t indexCapacity = 2;
+    while (indexCapacity < 2 * capacity) {
+        indexCapacity <<= 1;
+    }
+    
+    LRUCache *cache = thisCache(thread);
+    cache->count = 0;
+    cache->capacity = (uint32_t)capacity;
+    cache->indexCapacity = indexCapacity;
+    cache->head = cache->tail = LRU_CACHE_NONE;
+    cache->entries = NULL;
+    cache->index = NULL;
+    cache->hits = cache->misses = 0;
+    
+    Object *entriesObject = newArray(sizeCalculationWithOverflowProtection(capacity, sizeof(LRUCacheEntry)));
+    thisCache(thread)->entries = entriesObject;
+    Object *indexObject = newArray(sizeCalculationWithOverflowProtection(indexCapacity, sizeof(uint32_t)));
+    cache = thisCache(thread);
+    cache->index = indexObject;
+    memset(slots(cache), 0xFF, indexCapacity * sizeof(uint32_t));
+}
+
+InitializerFunctionFunctionPointer lruCacheInitializerForName(EmojicodeChar name){
+    return lruCacheInitWithCapacity;
+}
@@ -6,45 +6,52 @@
 //  Copyright (c) 2015 Theo Weidmann. All rights reserved.
 //
 
+#include "Emojicode.h"
 #include "EmojicodeList.h"
 #include "EmojicodeString.h"
 
 #include <string.h>
+#include <stdlib.h>
 
 #define items(list) ((Something *)(list)->items->value)
 
+/**
+ * Gives the list, which must be this of the top stack frame, an items array of @c capacity.
+ * The items are copied after the allocation as a garbage collection might have moved them.
+ */
+static void listResize(Thread *thread, size_t capacity){
+    Object *object = newArray(sizeCalculationWithOverflowProtection(capacity, sizeof(Something)));
+    List *list = stackGetThisObject(thread)->value;
+    if (list->items) {
+        memcpy(object->value, list->items->value, list->count * sizeof(Something));
+    }
+    list->items = object;
+    list->capacity = capacity;
+}
+
 void expandListSize(Thread *thread){
 #define initialSize 7
     List *list = stackGetThisObject(thread)->value;
-    if (list->capacity == 0) {
-        Object *object = newArray(sizeof(Something) * initialSize);
-        list = stackGetThisObject(thread)->value;
-        list->items = object;
-        list->capacity = initialSize;
-    }
-    else {
-        size_t newSize = list->capacity + (list->capacity >> 1);
-        Object *object = resizeArray(list->items, sizeCalculationWithOverflowProtection(newSize, sizeof(Something)));
-        list = stackGetThisObject(thread)->value;
-        list->items = object;
-        list->capacity = newSize;
-    }
+    listResize(thread, list->capacity == 0 ? initialSize : list->capacity + (list->capacity >> 1));
 #undef initialSize
 }
 
 void listEnsureCapacity(Thread *thread, size_t size) {
     List *list = stackGetThisObject(thread)->value;
     if (list->capacity < size) {
-        Object *object;
-        if (list->capacity == 0) {
-            object = newArray(sizeCalculationWithOverflowProtection(size, sizeof(Something)));
-        }
-        else {
-            object = resizeArray(list->items, sizeCalculationWithOverflowProtection(size, sizeof(Something)));
-        }
-        list = stackGetThisObject(thread)->value;
-        list->items = object;
-        list->capacity = size;
+        listResize(thread, size);
+    }
+}
+
+/**
+ * Ensures that the list, which must be this of the top stack frame, can store @c size items. If the list must grow,
+ * it grows by at least half of its capacity so that repeated bulk operations take amortized linear time.
+ */
+static void listReserve(Thread *thread, size_t size){
+    List *list = stackGetThisObject(thread)->value;
+    if (list->capacity < size) {
+        size_t grown = list->capacity + (list->capacity >> 1);
+        listResize(thread, grown > size ? grown : size);
     }
 }
 
@@ -60,13 +67,14 @@ void listMark(Object *self){
 }
 
 void listAppend(Object *lo, Something o, Thread *thread){
-    stackPush(somethingObject(lo), 0, 0, thread);
+    stackPush(somethingObject(lo), 1, 0, thread);
+    stackSetVariable(0, o, thread);
     List *list = lo->value;
     if (list->capacity - list->count == 0) {
         expandListSize(thread);
     }
     list = stackGetThisObject(thread)->value;
-    items(list)[list->count++] = o;
+    items(list)[list->count++] = stackGetVariable(0, thread);
     stackPop(thread);
 }
 
@@ -115,6 +123,54 @@ Something listSet(EmojicodeInteger index, Something value, Thread *thread) {
     return NOTHINGNESS;
 }
 
+void listReverse(List *list) {
+    if (list->count < 2) {
+        return;
+    }
+    for (Something *a = items(list), *b = items(list) + list->count - 1; a < b; a++, b--) {
+        Something tmp = *a;
+        *a = *b;
+        *b = tmp;
+    }
+}
+
+/** Whether @c a and @c b are equal. Strings are compared by their characters, all other objects by identity. */
+static bool listItemsEqual(Something a, Something b) {
+    if (a.type != b.type) {
+        return false;
+    }
+    switch (a.type) {
+        case T_OBJECT:
+            if (a.object == b.object) {
+                return true;
+            }
+            return a.object && b.object && a.object->class == CL_STRING && b.object->class == CL_STRING &&
+                   stringEqual(a.object->value, b.object->value);
+        case T_DOUBLE:
+            return a.doubl == b.doubl;
+        default:
+            return a.raw == b.raw;
+    }
+}
+
+EmojicodeInteger listIndexOf(List *list, Something x) {
+    Something *items = items(list);
+    if (x.type == T_INTEGER || x.type == T_SYMBOL || x.type == T_BOOLEAN) {
+        for (size_t i = 0; i < list->count; i++) {
+            if (items[i].raw == x.raw && items[i].type == x.type) {
+                return (EmojicodeInteger)i;
+            }
+        }
+        return -1;
+    }
+    for (size_t i = 0; i < list->count; i++) {
+        if (listItemsEqual(items[i], x)) {
+            return (EmojicodeInteger)i;
+        }
+    }
+    return -1;
+}
+
 void listShuffleInPlace(List *list) {
     EmojicodeInteger i, j, n = (EmojicodeInteger)list->count;
     Something tmp;
@@ -127,6 +183,301 @@ void listShuffleInPlace(List *list) {
     }
 }
 
+//MARK: Sorting
+
+/*
+ * Lists are sorted by a merge sort similar to TimSort: Ascending and strictly descending runs already present in
+ * the list are detected, short runs are extended by binary insertion sort and runs are merged while keeping the
+ * run lengths balanced. The sort is stable and needs O(n log n) comparisons in the worst case but only O(n) if the
+ * list is already sorted.
+ */
+
+typedef struct ListSort ListSort;
+
+/**
+ * Returns an integer less than, equal to, or greater than 0 if @c a is less than, equal to, or greater than @c b.
+ * If the comparison can invoke the garbage collector it must update @c items and @c buffer of the sort.
+ */
+typedef EmojicodeInteger (*ListSortComparator)(ListSort *sort, Something a, Something b);
+
+struct ListSort {
+    /** The items to sort. */
+    Something *items;
+    /** A buffer for at least half of the items. */
+    Something *buffer;
+    ListSortComparator compare;
+    /** The keys for @c listSortCompareKeys, which sorts the indices of @c keys. */
+    Something *keys;
+    ListSortComparator compareKeys;
+    Thread *thread;
+    
+    size_t runsCount;
+    size_t runBase[85];
+    size_t runLength[85];
+};
+
+/** Runs shorter than this are extended with binary insertion sort. */
+#define LIST_SORT_MINIMUM_MERGE 32
+
+static size_t listSortMinimumRunLength(size_t n){
+    size_t r = 0;
+    while (n >= LIST_SORT_MINIMUM_MERGE) {
+        r |= n & 1;
+        n >>= 1;
+    }
+    return n + r;
+}
+
+/** Sorts the items from @c lo to @c hi of which the items before @c start are already sorted. */
+static void listBinaryInsertionSort(ListSort *sort, size_t lo, size_t hi, size_t start){
+    for (; start < hi; start++) {
+        size_t left = lo, right = start;
+        while (left < right) {
+            size_t mid = left + (right - left) / 2;
+            if (sort->compare(sort, sort->items[start], sort->items[mid]) < 0) {
+                right = mid;
+            }
+            else {
+                left = mid + 1;
+            }
+        }
+        Something pivot = sort->items[start];
+        memmove(sort->items + left + 1, sort->items + left, (start - left) * sizeof(Something));
+        sort->items[left] = pivot;
+    }
+}
+
+/** Returns the end of the run beginning at @c lo and reverses the run if it is descending. */
+static size_t listCountRun(ListSort *sort, size_t lo, size_t hi){
+    size_t end = lo + 1;
+    if (end == hi) {
+        return hi;
+    }
+    if (sort->compare(sort, sort->items[end++], sort->items[lo]) < 0) {
+        while (end < hi && sort->compare(sort, sort->items[end], sort->items[end - 1]) < 0) {
+            end++;
+        }
+        for (size_t i = lo, j = end - 1; i < j; i++, j--) {
+            Something tmp = sort->items[i];
+            sort->items[i] = sort->items[j];
+            sort->items[j] = tmp;
+        }
+    }
+    else {
+        while (end < hi && sort->compare(sort, sort->items[end], sort->items[end - 1]) >= 0) {
+            end++;
+        }
+    }
+    return end;
+}
+
+/**
+ * Returns the index of the first item between @c lo and @c hi that is greater than the item at @c key, or not less if
+ * @c equal. The key is read again for every comparison as the comparison might move it.
+ */
+static size_t listSortSearch(ListSort *sort, size_t key, size_t lo, size_t hi, bool equal){
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        EmojicodeInteger c = sort->compare(sort, sort->items[mid], sort->items[key]);
+        if (equal ? c >= 0 : c > 0) {
+            hi = mid;
+        }
+        else {
+            lo = mid + 1;
+        }
+    }
+    return lo;
+}
+
+/** Merges the run at @c i with the run after it. */
+static void listMergeAt(ListSort *sort, size_t i){
+    size_t lo = sort->runBase[i], mid = lo + sort->runLength[i], hi = mid + sort->runLength[i + 1];
+    sort->runLength[i] += sort->runLength[i + 1];
+    if (i + 3 == sort->runsCount) {
+        sort->runBase[i + 1] = sort->runBase[i + 2];
+        sort->runLength[i + 1] = sort->runLength[i + 2];
+    }
+    sort->runsCount--;
+    
+    // Items at the beginning of the left run and at the end of the right run are already in place
+    lo = listSortSearch(sort, mid, lo, mid, false);
+    if (lo == mid) {
+        return;
+    }
+    hi = listSortSearch(sort, mid - 1, mid, hi, true);
+    
+    if (mid - lo <= hi - mid) {
+        size_t a = 0, aEnd = mid - lo, b = mid, out = lo;
+        memcpy(sort->buffer, sort->items + lo, aEnd * sizeof(Something));
+        while (a < aEnd && b < hi) {
+            if (sort->compare(sort, sort->items[b], sort->buffer[a]) < 0) {
+                sort->items[out++] = sort->items[b++];
+            }
+            else {
+                sort->items[out++] = sort->buffer[a++];
+            }
+        }
+        memcpy(sort->items + out, sort->buffer + a, (aEnd - a) * sizeof(Something));
+    }
+    else {
+        size_t a = mid, b = hi - mid, out = hi;
+        memcpy(sort->buffer, sort->items + mid, b * sizeof(Something));
+        while (a > lo && b > 0) {
+            if (sort->compare(sort, sort->buffer[b - 1], sort->items[a - 1]) < 0) {
+                sort->items[--out] = sort->items[--a];
+            }
+            else {
+                sort->items[--out] = sort->buffer[--b];
+            }
+        }
+        memcpy(sort->items + out - b, sort->buffer, b * sizeof(Something));
+    }
+}
+
+/** Merges runs until the length of each run is greater than the lengths of the two following runs together. */
+static void listMergeCollapse(ListSort *sort, bool force){
+    size_t *length = sort->runLength;
+    while (sort->runsCount > 1) {
+        size_t n = sort->runsCount - 2;
+        if (force) {
+            if (n > 0 && length[n - 1] < length[n + 1]) {
+                n--;
+            }
+        }
+        else if ((n > 0 && length[n - 1] <= length[n] + length[n + 1]) ||
+                 (n > 1 && length[n - 2] <= length[n - 1] + length[n])) {
+            if (length[n - 1] < length[n + 1]) {
+                n--;
+            }
+        }
+        else if (length[n] > length[n + 1]) {
+            break;
+        }
+        listMergeAt(sort, n);
+    }
+}
+
+/** Sorts @c count items. @c items and @c buffer of @c sort must have been set. */
+static void listSortItems(ListSort *sort, size_t count){
+    if (count < 2) {
+        return;
+    }
+    size_t minimumRun = listSortMinimumRunLength(count);
+    sort->runsCount = 0;
+    for (size_t lo = 0; lo < count;) {
+        size_t end = listCountRun(sort, lo, count);
+        if (end - lo < minimumRun) {
+            size_t forcedEnd = count - lo < minimumRun ? count : lo + minimumRun;
+            listBinaryInsertionSort(sort, lo, forcedEnd, end);
+            end = forcedEnd;
+        }
+        sort->runBase[sort->runsCount] = lo;
+        sort->runLength[sort->runsCount++] = end - lo;
+        listMergeCollapse(sort, false);
+        lo = end;
+    }
+    listMergeCollapse(sort, true);
+}
+
+static EmojicodeInteger listSortCompareIntegers(ListSort *sort, Something a, Something b){
+    return (a.raw > b.raw) - (a.raw < b.raw);
+}
+
+static EmojicodeInteger listSortCompareDoubles(ListSort *sort, Something a, Something b){
+    return (a.doubl > b.doubl) - (a.doubl < b.doubl);
+}
+
+static EmojicodeInteger listSortCompareSymbols(ListSort *sort, Something a, Something b){
+    return (unwrapSymbol(a) > unwrapSymbol(b)) - (unwrapSymbol(a) < unwrapSymbol(b));
+}
+
+static EmojicodeInteger listSortCompareStrings(ListSort *sort, Something a, Something b){
+    return stringCompare(a.object->value, b.object->value);
+}
+
+static EmojicodeInteger listSortCompareKeys(ListSort *sort, Something a, Something b){
+    return sort->compareKeys(sort, sort->keys[a.raw], sort->keys[b.raw]);
+}
+
+/** Calls the comparator in variable 0. The buffer is the items of the list in variable 1. */
+static EmojicodeInteger listSortCompareCallable(ListSort *sort, Something a, Something b){
+    Thread *thread = sort->thread;
+    Something args[2] = {a, b};
+    EmojicodeInteger c = executeCallableExtern(stackGetVariable(0, thread).object, args, thread).raw;
+    sort->items = items((List *)stackGetThisObject(thread)->value);
+    sort->buffer = items((List *)stackGetVariable(1, thread).object->value);
+    return c;
+}
+
+/** Sorts @c list with a comparator that does not invoke the garbage collector. */
+static void listSortNative(List *list, ListSortComparator compare){
+    if (list->count < 2) {
+        return;
+    }
+    ListSort sort = { .items = items(list), .compare = compare };
+    sort.buffer = malloc((list->count / 2 + 1) * sizeof(Something));
+    if (!sort.buffer) {
+        error("Cannot allocate the buffer to sort the list.");
+    }
+    listSortItems(&sort, list->count);
+    free(sort.buffer);
+}
+
+/**
+ * Sorts the list that is this by the keys the callable in variable 0 returns for its items. The keys are compared
+ * using @c compareKeys. The callable is called exactly once per item.
+ */
+static void listSortByKey(Thread *thread, ListSortComparator compareKeys){
+    size_t count = ((List *)stackGetThisObject(thread)->value)->count;
+    if (count < 2) {
+        return;
+    }
+    
+    Something callable = stackGetVariable(0, thread);
+    stackPush(stackGetThisContext(thread), 2, 0, thread);
+    stackSetVariable(0, callable, thread);
+    stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
+    Object *keysItems = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+    List *keys = stackGetVariable(1, thread).object->value;
+    keys->items = keysItems;
+    keys->capacity = count;
+    
+    for (size_t i = 0; i < count; i++) {
+        List *list = stackGetThisObject(thread)->value;
+        if (list->count <= i) {
+            break;
+        }
+        Something item = items(list)[i];
+        Something key = executeCallableExtern(stackGetVariable(0, thread).object, &item, thread);
+        keys = stackGetVariable(1, thread).object->value;
+        items(keys)[keys->count++] = key;
+    }
+    
+    // No garbage collection can occur from here on
+    List *list = stackGetThisObject(thread)->value;
+    keys = stackGetVariable(1, thread).object->value;
+    count = keys->count < list->count ? keys->count : list->count;
+    
+    ListSort sort = { .compare = listSortCompareKeys, .compareKeys = compareKeys, .keys = items(keys) };
+    sort.items = malloc(count * sizeof(Something));
+    sort.buffer = malloc(count * sizeof(Something));
+    if (!sort.items || !sort.buffer) {
+        error("Cannot allocate the buffer to sort the list.");
+    }
+    for (size_t i = 0; i < count; i++) {
+        sort.items[i] = somethingInteger(i);
+    }
+    listSortItems(&sort, count);
+    
+    memcpy(sort.buffer, items(list), count * sizeof(Something));
+    for (size_t i = 0; i < count; i++) {
+        items(list)[i] = sort.buffer[sort.items[i].raw];
+    }
+    free(sort.items);
+    free(sort.buffer);
+    stackPop(thread);
+}
+
 /* MARK: Emoji bridges */
 
 static Something listCountBridge(Thread *thread){
@@ -173,49 +524,228 @@ static Something listInsertBridge(Thread *thread){
     return NOTHINGNESS;
 }
 
-static void listQSort(Thread *thread, size_t off, size_t n) {
-    if (n < 2)
-        return;
+static Something listSortBridge(Thread *thread) {
+    size_t count = ((List *)stackGetThisObject(thread)->value)->count;
+    if (count < 2) {
+        return NOTHINGNESS;
+    }
     
-    Something *items = items((List *)stackGetThisObject(thread)->value) + off;
-    Something pivot = items[n / 2];
-    size_t i, j;
-    
-    for (i = 0, j = n - 1; ; i++, j--) {
-        while (true) {
-            Something args[2] = {items[i], pivot};
-            EmojicodeInteger c = executeCallableExtern(stackGetVariable(0, thread).object, args, thread).raw;
-            items = items((List *)stackGetThisObject(thread)->value) + off;
-            if (c >= 0) break;
-            i++;
-        }
-        
-        while (true) {
-            Something args[2] = {pivot, items[j]};
-            EmojicodeInteger c = executeCallableExtern(stackGetVariable(0, thread).object, args, thread).raw;
-            items = items((List *)stackGetThisObject(thread)->value) + off;
-            if (c >= 0) break;
-            j--;
-        }
-        
-        if (i >= j)
-            break;
-        
-        Something temp = items[i];
-        items[i] = items[j];
-        items[j] = temp;
+    Something comparator = stackGetVariable(0, thread);
+    stackPush(stackGetThisContext(thread), 2, 0, thread);
+    stackSetVariable(0, comparator, thread);
+    stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
+    Object *bufferItems = newArray(sizeCalculationWithOverflowProtection(count / 2 + 1, sizeof(Something)));
+    List *buffer = stackGetVariable(1, thread).object->value;
+    buffer->items = bufferItems;
+    buffer->capacity = buffer->count = count / 2 + 1;
+    
+    ListSort sort = { .compare = listSortCompareCallable, .thread = thread, .buffer = items(buffer) };
+    sort.items = items((List *)stackGetThisObject(thread)->value);
+    listSortItems(&sort, count);
+    
+    stackPop(thread);
+    return NOTHINGNESS;
+}
+
+static Something listSortByIntegerKeyBridge(Thread *thread) {
+    listSortByKey(thread, listSortCompareIntegers);
+    return NOTHINGNESS;
+}
+
+static Something listSortByDoubleKeyBridge(Thread *thread) {
+    listSortByKey(thread, listSortCompareDoubles);
+    return NOTHINGNESS;
+}
+
+static Something listSortByStringKeyBridge(Thread *thread) {
+    listSortByKey(thread, listSortCompareStrings);
+    return NOTHINGNESS;
+}
+
+static Something listSortIntegersBridge(Thread *thread) {
+    listSortNative(stackGetVariable(0, thread).object->value, listSortCompareIntegers);
+    return NOTHINGNESS;
+}
+
+static Something listSortDoublesBridge(Thread *thread) {
+    listSortNative(stackGetVariable(0, thread).object->value, listSortCompareDoubles);
+    return NOTHINGNESS;
+}
+
+static Something listSortSymbolsBridge(Thread *thread) {
+    listSortNative(stackGetVariable(0, thread).object->value, listSortCompareSymbols);
+    return NOTHINGNESS;
+}
+
+static Something listSortStringsBridge(Thread *thread) {
+    listSortNative(stackGetVariable(0, thread).object->value, listSortCompareStrings);
+    return NOTHINGNESS;
+}
+
+static Something listAppendListBridge(Thread *thread) {
+    List *list = stackGetThisObject(thread)->value;
+    size_t count = list->count, otherCount = ((List *)stackGetVariable(0, thread).object->value)->count;
+    if (otherCount == 0) {
+        return NOTHINGNESS;
     }
+    listReserve(thread, count + otherCount);
     
-    listQSort(thread, off, i);
-    listQSort(thread, off + i, n - i);
+    list = stackGetThisObject(thread)->value;
+    List *other = stackGetVariable(0, thread).object->value;
+    memcpy(items(list) + count, items(other), otherCount * sizeof(Something));
+    list->count = count + otherCount;
+    return NOTHINGNESS;
 }
 
-static Something listSort(Thread *thread) {
+static Something listSliceBridge(Thread *thread) {
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(0, thread));
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger count = (EmojicodeInteger)((List *)stackGetThisObject(thread)->value)->count;
+    
+    if (from < 0) {
+        from += count;
+    }
+    if (length < 0) {
+        length += count;
+    }
+    if (from < 0) {
+        from = 0;
+    }
+    if (from > count) {
+        from = count;
+    }
+    if (length < 0) {
+        length = 0;
+    }
+    if (length > count - from) {
+        length = count - from;
+    }
+    
+    Object *sliceO = newObject(CL_LIST);
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(sliceO), thread);
+    
+    if (length > 0) {
+        Object *items = newArray(sizeCalculationWithOverflowProtection(length, sizeof(Something)));
+        sliceO = stackGetVariable(0, thread).object;
+        List *slice = sliceO->value;
+        slice->items = items;
+        slice->capacity = slice->count = length;
+        memcpy(items(slice), items((List *)stackGetThisObject(thread)->value) + from, length * sizeof(Something));
+    }
+    
+    sliceO = stackGetVariable(0, thread).object;
+    stackPop(thread);
+    return somethingObject(sliceO);
+}
+
+static Something listInsertListBridge(Thread *thread) {
+    EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
+    List *list = stackGetThisObject(thread)->value;
+    size_t count = list->count, otherCount = ((List *)stackGetVariable(1, thread).object->value)->count;
+    
+    if (index < 0) {
+        index += count;
+    }
+    if (index < 0 || count < index){
+        return NOTHINGNESS;
+    }
+    if (otherCount == 0) {
+        return NOTHINGNESS;
+    }
+    listReserve(thread, count + otherCount);
+    
+    list = stackGetThisObject(thread)->value;
+    List *other = stackGetVariable(1, thread).object->value;
+    memmove(items(list) + index + otherCount, items(list) + index, (count - index) * sizeof(Something));
+    if (list == other) {
+        // The items after index have already been moved
+        memmove(items(list) + index, items(list), index * sizeof(Something));
+        memmove(items(list) + 2 * index, items(list) + index + otherCount, (count - index) * sizeof(Something));
+    }
+    else {
+        memcpy(items(list) + index, items(other), otherCount * sizeof(Something));
+    }
+    list->count = count + otherCount;
+    return NOTHINGNESS;
+}
+
+static Something listRemoveRangeBridge(Thread *thread) {
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(0, thread));
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(1, thread));
+    List *list = stackGetThisObject(thread)->value;
+    EmojicodeInteger count = (EmojicodeInteger)list->count;
+    
+    if (from < 0) {
+        from += count;
+    }
+    if (from < 0 || count <= from || length <= 0) {
+        return NOTHINGNESS;
+    }
+    if (length > count - from) {
+        length = count - from;
+    }
+    
+    memmove(items(list) + from, items(list) + from + length, (count - from - length) * sizeof(Something));
+    memset(items(list) + count - length, 0, length * sizeof(Something));
+    list->count -= length;
+    return NOTHINGNESS;
+}
+
+static Something listReverseBridge(Thread *thread) {
+    listReverse(stackGetThisObject(thread)->value);
+    return NOTHINGNESS;
+}
+
+static Something listFillBridge(Thread *thread) {
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(2, thread));
+    // Filling past the end would leave items in between that are Nothingness
+    if (from < 0 || ((List *)stackGetThisObject(thread)->value)->count < from || length <= 0) {
+        return NOTHINGNESS;
+    }
+    listReserve(thread, from + length);
+    
     List *list = stackGetThisObject(thread)->value;
-    listQSort(thread, 0, list->count);
+    Something value = stackGetVariable(0, thread);
+    for (Something *item = items(list) + from, *end = item + length; item < end; item++) {
+        *item = value;
+    }
+    if (list->count < from + length) {
+        list->count = from + length;
+    }
     return NOTHINGNESS;
 }
 
+static Something listIndexOfBridge(Thread *thread) {
+    EmojicodeInteger index = listIndexOf(stackGetThisObject(thread)->value, stackGetVariable(0, thread));
+    return index < 0 ? NOTHINGNESS : somethingInteger(index);
+}
+
+static Something listBinarySearchBridge(Thread *thread) {
+    size_t lo = 0, hi = ((List *)stackGetThisObject(thread)->value)->count;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        List *list = stackGetThisObject(thread)->value;
+        if (list->count <= mid) {
+            hi = list->count;
+            continue;
+        }
+        Something args[2] = {items(list)[mid], stackGetVariable(0, thread)};
+        EmojicodeInteger c = executeCallableExtern(stackGetVariable(1, thread).object, args, thread).raw;
+        if (c < 0) {
+            lo = mid + 1;
+        }
+        else if (c > 0) {
+            hi = mid;
+        }
+        else {
+            return somethingInteger((EmojicodeInteger)mid);
+        }
+    }
+    return somethingInteger(-(EmojicodeInteger)lo - 1);
+}
+
 static Something listFromListBridge(Thread *thread) {
     Object *listO = newObject(CL_LIST);
     stackPush(stackGetThisContext(thread), 1, 0, thread);
@@ -240,7 +770,9 @@ static Something listFromListBridge(Thread *thread) {
 
 static Something listRemoveAllBridge(Thread *thread) {
     List *list = stackGetThisObject(thread)->value;
-    memset(items(list), 0, list->count);
+    if (list->items) {
+        memset(items(list), 0, list->count * sizeof(Something));
+    }
     list->count = 0;
     return NOTHINGNESS;
 }
@@ -291,13 +823,49 @@ FunctionFunctionPointer listMethodForName(EmojicodeChar method) {
         case 0x1F42E: //🐮
             return listFromListBridge;
         case 0x1F981: //🦁
-            return listSort;
+            return listSortBridge;
+        case 0x1f405: //🐅
+            return listSortByIntegerKeyBridge;
+        case 0x1f406: //🐆
+            return listSortByDoubleKeyBridge;
+        case 0x1f403: //🐃
+            return listSortByStringKeyBridge;
         case 0x1f417: //🐗
             return listRemoveAllBridge;
         case 0x1f437: //🐷
             return listSetBridge;
         case 0x1f434: //🐴
             return listEnsureCapacityBridge;
+        case 0x1f419: //🐙
+            return listAppendListBridge;
+        case 0x1f422: //🐢
+            return listSliceBridge;
+        case 0x1f421: //🐡
+            return listInsertListBridge;
+        case 0x1f40c: //🐌
+            return listRemoveRangeBridge;
+        case 0x1f41e: //🐞
+            return listReverseBridge;
+        case 0x1f41c: //🐜
+            return listFillBridge;
+        case 0x1f41d: //🐝
+            return listIndexOfBridge;
+        case 0x1f42c: //🐬
+            return listBinarySearchBridge;
+    }
+    return NULL;
+}
+
+FunctionFunctionPointer listSortMethodForType(EmojicodeChar type) {
+    switch (type) {
+        case 0x1F682: //🚂
+            return listSortIntegersBridge;
+        case 0x1F680: //🚀
+            return listSortDoublesBridge;
+        case 0x1f523: //🔣
+            return listSortSymbolsBridge;
+        case 0x1F521: //🔡
+            return listSortStringsBridge;
     }
     return NULL;
 }
@@ -0,0 +1,632 @@
+//
+//  EmojicodePrimitiveArray.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodePrimitiveArray.h"
+#include "EmojicodeList.h"
+
+#include <string.h>
+
+#define integers(array) ((EmojicodeInteger *)(array)->values->value)
+#define doubles(array) ((double *)(array)->values->value)
+#define bytes(array) ((uint8_t *)(array)->values->value)
+
+void primitiveArrayMark(Object *self){
+    PrimitiveArray *array = self->value;
+    if (array->values) {
+        mark(&array->values);
+    }
+}
+
+static void primitiveArrayInit(Thread *thread, Type valueType, uint8_t valueSize){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    array->valueType = valueType;
+    array->valueSize = valueSize;
+}
+
+/**
+ * Ensures that @c arrayObject can store @c size values. Unless @c exactly is true, the array grows by at least half of
+ * its capacity. Returns @c arrayObject, which might have been moved.
+ * @warning GC-invoking
+ */
+static Object* primitiveArrayReserve(Object *arrayObject, size_t size, bool exactly, Thread *thread){
+    PrimitiveArray *array = arrayObject->value;
+    if (array->capacity >= size) {
+        return arrayObject;
+    }
+    size_t capacity = array->capacity + (array->capacity >> 1);
+    if (exactly || capacity < size) {
+        capacity = size;
+    }
+    
+    stackPush(somethingObject(arrayObject), 0, 0, thread);
+    Object *values = newArray(sizeCalculationWithOverflowProtection(capacity, array->valueSize));
+    arrayObject = stackGetThisObject(thread);
+    stackPop(thread);
+    
+    array = arrayObject->value;
+    if (array->count) {
+        memcpy(values->value, array->values->value, array->count * array->valueSize);
+    }
+    array->values = values;
+    array->capacity = capacity;
+    return arrayObject;
+}
+
+/** Sets the count of @c array, which must have the capacity, and zeroes the values that are added. */
+static void primitiveArraySetCount(PrimitiveArray *array, size_t count){
+    if (count > array->count) {
+        memset(bytes(array) + array->count * array->valueSize, 0, (count - array->count) * array->valueSize);
+    }
+    array->count = count;
+}
+
+static Something primitiveArrayGet(PrimitiveArray *array, size_t index){
+    switch (array->valueType) {
+        case T_DOUBLE:
+            return somethingDouble(doubles(array)[index]);
+        case T_BOOLEAN:
+            return somethingBoolean(bytes(array)[index]);
+        default:
+            return somethingInteger(array->valueSize == 1 ? bytes(array)[index] : integers(array)[index]);
+    }
+}
+
+static void primitiveArraySet(PrimitiveArray *array, size_t index, Something value){
+    switch (array->valueType) {
+        case T_DOUBLE:
+            doubles(array)[index] = unwrapDouble(value);
+            break;
+        case T_BOOLEAN:
+            bytes(array)[index] = unwrapBool(value);
+            break;
+        default:
+            if (array->valueSize == 1) {
+                bytes(array)[index] = (uint8_t)unwrapInteger(value);
+            }
+            else {
+                integers(array)[index] = unwrapInteger(value);
+            }
+            break;
+    }
+}
+
+/** Appends the items of the list in variable 0 to the array that is this. */
+static void primitiveArrayAppendList(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    size_t count = array->count, listCount = ((List *)stackGetVariable(0, thread).object->value)->count;
+    array = primitiveArrayReserve(stackGetThisObject(thread), count + listCount, true, thread)->value;
+    
+    List *list = stackGetVariable(0, thread).object->value;
+    array->count = count + listCount;
+    for (size_t i = 0; i < listCount; i++) {
+        primitiveArraySet(array, count + i, listGet(list, i));
+    }
+}
+
+/** Creates an empty array of the same class and value type as the array that is this. */
+static Object* primitiveArrayNewLikeThis(Thread *thread){
+    Object *object = newObject(stackGetThisObject(thread)->class);
+    PrimitiveArray *array = object->value, *this = stackGetThisObject(thread)->value;
+    array->valueType = this->valueType;
+    array->valueSize = this->valueSize;
+    return object;
+}
+
+//MARK: Kernels
+
+/*
+ * The kernels are written as plain loops over the values, which the compiler vectorizes. Binary kernels operate on the
+ * first min(count, other count) values.
+ */
+
+static EmojicodeInteger integersSum(const EmojicodeInteger *restrict values, size_t count){
+    EmojicodeInteger sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static double doublesSum(const double *restrict values, size_t count){
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+static EmojicodeInteger integersDot(const EmojicodeInteger *restrict a, const EmojicodeInteger *restrict b,
+                                    size_t count){
+    EmojicodeInteger sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+static double doublesDot(const double *restrict a, const double *restrict b, size_t count){
+    double sum = 0;
+    for (size_t i = 0; i < count; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+/** Computes @c a += @c factor * @c b. @c a and @c b may be the same. */
+static void integersAddScaled(EmojicodeInteger *a, const EmojicodeInteger *b, EmojicodeInteger factor, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        a[i] += factor * b[i];
+    }
+}
+
+static void doublesAddScaled(double *a, const double *b, double factor, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        a[i] += factor * b[i];
+    }
+}
+
+static void integersScale(EmojicodeInteger *restrict values, EmojicodeInteger factor, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        values[i] *= factor;
+    }
+}
+
+static void doublesScale(double *restrict values, double factor, size_t count){
+    for (size_t i = 0; i < count; i++) {
+        values[i] *= factor;
+    }
+}
+
+/** The comparisons of the comparison kernels. */
+typedef enum {
+    COMPARISON_LESS, COMPARISON_GREATER, COMPARISON_EQUAL
+} Comparison;
+
+static void integersCompare(const EmojicodeInteger *restrict values, EmojicodeInteger value, uint8_t *restrict mask,
+                            size_t count, Comparison comparison){
+    switch (comparison) {
+        case COMPARISON_LESS:
+            for (size_t i = 0; i < count; i++) mask[i] = values[i] < value;
+            break;
+        case COMPARISON_GREATER:
+            for (size_t i = 0; i < count; i++) mask[i] = values[i] > value;
+            break;
+        case COMPARISON_EQUAL:
+            for (size_t i = 0; i < count; i++) mask[i] = values[i] == value;
+            break;
+    }
+}
+
+static void doublesCompare(const double *restrict values, double value, uint8_t *restrict mask, size_t count,
+                           Comparison comparison){
+    switch (comparison) {
+        case COMPARISON_LESS:
+            for (size_t i = 0; i < count; i++) mask[i] = values[i] < value;
+            break;
+        case COMPARISON_GREATER:
+            for (size_t i = 0; i < count; i++) mask[i] = values[i] > value;
+            break;
+        case COMPARISON_EQUAL:
+            for (size_t i = 0; i < count; i++) mask[i] = values[i] == value;
+            break;
+    }
+}
+
+//MARK: Bridges
+
+static Something primitiveArrayCountBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)((PrimitiveArray *)stackGetThisObject(thread)->value)->count);
+}
+
+static Something primitiveArrayAppendBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    array = primitiveArrayReserve(stackGetThisObject(thread), array->count + 1, false, thread)->value;
+    primitiveArraySet(array, array->count++, stackGetVariable(0, thread));
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayGetBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
+    if (index < 0) {
+        index += array->count;
+    }
+    if (index < 0 || array->count <= index) {
+        return NOTHINGNESS;
+    }
+    return primitiveArrayGet(array, index);
+}
+
+static Something primitiveArraySetBridge(Thread *thread){
+    EmojicodeInteger index = unwrapInteger(stackGetVariable(0, thread));
+    if (index < 0) {
+        return NOTHINGNESS;
+    }
+    PrimitiveArray *array = primitiveArrayReserve(stackGetThisObject(thread), index + 1, false, thread)->value;
+    if (array->count <= index) {
+        primitiveArraySetCount(array, index + 1);
+    }
+    primitiveArraySet(array, index, stackGetVariable(1, thread));
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayPopBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    if (array->count == 0) {
+        return NOTHINGNESS;
+    }
+    return primitiveArrayGet(array, --array->count);
+}
+
+static Something primitiveArrayRemoveAllBridge(Thread *thread){
+    ((PrimitiveArray *)stackGetThisObject(thread)->value)->count = 0;
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayEnsureCapacityBridge(Thread *thread){
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread));
+    if (capacity > 0) {
+        primitiveArrayReserve(stackGetThisObject(thread), capacity, true, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayAppendArrayBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    size_t count = array->count, otherCount = ((PrimitiveArray *)stackGetVariable(0, thread).object->value)->count;
+    if (otherCount == 0) {
+        return NOTHINGNESS;
+    }
+    array = primitiveArrayReserve(stackGetThisObject(thread), count + otherCount, false, thread)->value;
+    
+    PrimitiveArray *other = stackGetVariable(0, thread).object->value;
+    memcpy(bytes(array) + count * array->valueSize, bytes(other), otherCount * array->valueSize);
+    array->count = count + otherCount;
+    return NOTHINGNESS;
+}
+
+static Something primitiveArraySliceBridge(Thread *thread){
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(0, thread));
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger count = (EmojicodeInteger)((PrimitiveArray *)stackGetThisObject(thread)->value)->count;
+    
+    if (from < 0) {
+        from += count;
+    }
+    if (length < 0) {
+        length += count;
+    }
+    if (from < 0) {
+        from = 0;
+    }
+    if (from > count) {
+        from = count;
+    }
+    if (length < 0) {
+        length = 0;
+    }
+    if (length > count - from) {
+        length = count - from;
+    }
+    
+    Object *sliceO = primitiveArrayNewLikeThis(thread);
+    if (length > 0) {
+        sliceO = primitiveArrayReserve(sliceO, length, true, thread);
+        PrimitiveArray *slice = sliceO->value, *array = stackGetThisObject(thread)->value;
+        memcpy(bytes(slice), bytes(array) + from * array->valueSize, length * array->valueSize);
+        slice->count = length;
+    }
+    return somethingObject(sliceO);
+}
+
+static Something primitiveArrayFillBridge(Thread *thread){
+    EmojicodeInteger from = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger length = unwrapInteger(stackGetVariable(2, thread));
+    if (from < 0 || length <= 0) {
+        return NOTHINGNESS;
+    }
+    PrimitiveArray *array = primitiveArrayReserve(stackGetThisObject(thread), from + length, false, thread)->value;
+    if (array->count < from + length) {
+        primitiveArraySetCount(array, from + length);
+    }
+    
+    Something value = stackGetVariable(0, thread);
+    if (array->valueSize == 1) {
+        primitiveArraySet(array, from, value);
+        memset(bytes(array) + from, bytes(array)[from], length);
+    }
+    else {
+        for (EmojicodeInteger i = from; i < from + length; i++) {
+            primitiveArraySet(array, i, value);
+        }
+    }
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayToListBridge(Thread *thread){
+    size_t count = ((PrimitiveArray *)stackGetThisObject(thread)->value)->count;
+    
+    Object *listO = newObject(CL_LIST);
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(listO), thread);
+    
+    if (count > 0) {
+        Object *items = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+        listO = stackGetVariable(0, thread).object;
+        List *list = listO->value;
+        list->items = items;
+        list->capacity = list->count = count;
+    
+        PrimitiveArray *array = stackGetThisObject(thread)->value;
+        Something *listItems = items->value;
+        for (size_t i = 0; i < count; i++) {
+            listItems[i] = primitiveArrayGet(array, i);
+        }
+    }
+    
+    listO = stackGetVariable(0, thread).object;
+    stackPop(thread);
+    return somethingObject(listO);
+}
+
+static Something primitiveArraySumBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    if (array->count == 0) {
+        return array->valueType == T_DOUBLE ? somethingDouble(0) : somethingInteger(0);
+    }
+    if (array->valueType == T_DOUBLE) {
+        return somethingDouble(doublesSum(doubles(array), array->count));
+    }
+    return somethingInteger(integersSum(integers(array), array->count));
+}
+
+static Something primitiveArrayExtremum(Thread *thread, bool maximum){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    if (array->count == 0) {
+        return NOTHINGNESS;
+    }
+    if (array->valueType == T_DOUBLE) {
+        const double *values = doubles(array);
+        double extremum = values[0];
+        for (size_t i = 1; i < array->count; i++) {
+            extremum = (maximum ? values[i] > extremum : values[i] < extremum) ? values[i] : extremum;
+        }
+        return somethingDouble(extremum);
+    }
+    const EmojicodeInteger *values = integers(array);
+    EmojicodeInteger extremum = values[0];
+    for (size_t i = 1; i < array->count; i++) {
+        extremum = (maximum ? values[i] > extremum : values[i] < extremum) ? values[i] : extremum;
+    }
+    return somethingInteger(extremum);
+}
+
+static Something primitiveArrayMinimumBridge(Thread *thread){
+    return primitiveArrayExtremum(thread, false);
+}
+
+static Something primitiveArrayMaximumBridge(Thread *thread){
+    return primitiveArrayExtremum(thread, true);
+}
+
+static Something primitiveArrayDotBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value, *other = stackGetVariable(0, thread).object->value;
+    size_t count = array->count < other->count ? array->count : other->count;
+    if (count == 0) {
+        return array->valueType == T_DOUBLE ? somethingDouble(0) : somethingInteger(0);
+    }
+    if (array->valueType == T_DOUBLE) {
+        return somethingDouble(doublesDot(doubles(array), doubles(other), count));
+    }
+    return somethingInteger(integersDot(integers(array), integers(other), count));
+}
+
+static Something primitiveArrayScaleBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    if (array->count == 0) {
+        return NOTHINGNESS;
+    }
+    if (array->valueType == T_DOUBLE) {
+        doublesScale(doubles(array), unwrapDouble(stackGetVariable(0, thread)), array->count);
+    }
+    else {
+        integersScale(integers(array), unwrapInteger(stackGetVariable(0, thread)), array->count);
+    }
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayAddScaledBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value, *other = stackGetVariable(0, thread).object->value;
+    size_t count = array->count < other->count ? array->count : other->count;
+    if (count == 0) {
+        return NOTHINGNESS;
+    }
+    if (array->valueType == T_DOUBLE) {
+        doublesAddScaled(doubles(array), doubles(other), unwrapDouble(stackGetVariable(1, thread)), count);
+    }
+    else {
+        integersAddScaled(integers(array), integers(other), unwrapInteger(stackGetVariable(1, thread)), count);
+    }
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayPrefixSumBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    if (array->count == 0) {
+        return NOTHINGNESS;
+    }
+    if (array->valueType == T_DOUBLE) {
+        double *values = doubles(array);
+        for (size_t i = 1; i < array->count; i++) {
+            values[i] += values[i - 1];
+        }
+    }
+    else {
+        EmojicodeInteger *values = integers(array);
+        for (size_t i = 1; i < array->count; i++) {
+            values[i] += values[i - 1];
+        }
+    }
+    return NOTHINGNESS;
+}
+
+/** Compares all values with variable 0 and stores the results in the 🙌 in variable 1. */
+static Something primitiveArrayCompare(Thread *thread, Comparison comparison){
+    size_t count = ((PrimitiveArray *)stackGetThisObject(thread)->value)->count;
+    PrimitiveArray *mask = primitiveArrayReserve(stackGetVariable(1, thread).object, count, false, thread)->value;
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    mask->count = count;
+    if (count == 0) {
+        return NOTHINGNESS;
+    }
+    if (array->valueType == T_DOUBLE) {
+        doublesCompare(doubles(array), unwrapDouble(stackGetVariable(0, thread)), bytes(mask), count, comparison);
+    }
+    else {
+        integersCompare(integers(array), unwrapInteger(stackGetVariable(0, thread)), bytes(mask), count, comparison);
+    }
+    return NOTHINGNESS;
+}
+
+static Something primitiveArrayLessBridge(Thread *thread){
+    return primitiveArrayCompare(thread, COMPARISON_LESS);
+}
+
+static Something primitiveArrayGreaterBridge(Thread *thread){
+    return primitiveArrayCompare(thread, COMPARISON_GREATER);
+}
+
+static Something primitiveArrayEqualBridge(Thread *thread){
+    return primitiveArrayCompare(thread, COMPARISON_EQUAL);
+}
+
+static Something primitiveArraySelectBridge(Thread *thread){
+    Object *selectionO = primitiveArrayNewLikeThis(thread);
+    PrimitiveArray *array = stackGetThisObject(thread)->value, *mask = stackGetVariable(0, thread).object->value;
+    size_t count = array->count < mask->count ? array->count : mask->count, selected = 0;
+    for (size_t i = 0; i < count; i++) {
+        selected += bytes(mask)[i];
+    }
+    if (selected == 0) {
+        return somethingObject(selectionO);
+    }
+    
+    selectionO = primitiveArrayReserve(selectionO, selected, true, thread);
+    PrimitiveArray *selection = selectionO->value;
+    array = stackGetThisObject(thread)->value;
+    mask = stackGetVariable(0, thread).object->value;
+    for (size_t i = 0, j = 0; i < count; i++) {
+        if (bytes(mask)[i]) {
+            memcpy(bytes(selection) + j++ * array->valueSize, bytes(array) + i * array->valueSize, array->valueSize);
+        }
+    }
+    selection->count = selected;
+    return somethingObject(selectionO);
+}
+
+static Something primitiveArrayCountTrueBridge(Thread *thread){
+    PrimitiveArray *array = stackGetThisObject(thread)->value;
+    EmojicodeInteger count = 0;
+    for (size_t i = 0; i < array->count; i++) {
+        count += bytes(array)[i];
+    }
+    return somethingInteger(count);
+}
+
+FunctionFunctionPointer primitiveArrayMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1F414: //🐔
+            return primitiveArrayCountBridge;
+        case 0x1F43B: //🐻
+            return primitiveArrayAppendBridge;
+        case 0x1F43D: //🐽
+            return primitiveArrayGetBridge;
+        case 0x1f437: //🐷
+            return primitiveArraySetBridge;
+        case 0x1F43C: //🐼
+            return primitiveArrayPopBridge;
+        case 0x1f417: //🐗
+            return primitiveArrayRemoveAllBridge;
+        case 0x1f434: //🐴
+            return primitiveArrayEnsureCapacityBridge;
+        case 0x1f419: //🐙
+            return primitiveArrayAppendArrayBridge;
+        case 0x1f422: //🐢
+            return primitiveArraySliceBridge;
+        case 0x1f41c: //🐜
+            return primitiveArrayFillBridge;
+        case 0x1f4cb: //📋
+            return primitiveArrayToListBridge;
+        case 0x1f4af: //💯
+            return primitiveArraySumBridge;
+        case 0x1f53d: //🔽
+            return primitiveArrayMinimumBridge;
+        case 0x1f53c: //🔼
+            return primitiveArrayMaximumBridge;
+        case 0x1f3af: //🎯
+            return primitiveArrayDotBridge;
+        case 0x1f4d0: //📐
+            return primitiveArrayScaleBridge;
+        case 0x1f517: //🔗
+            return primitiveArrayAddScaledBridge;
+        case 0x1f4c8: //📈
+            return primitiveArrayPrefixSumBridge;
+        case 0x1f53b: //🔻
+            return primitiveArrayLessBridge;
+        case 0x1f53a: //🔺
+            return primitiveArrayGreaterBridge;
+        case 0x2696: //⚖
+            return primitiveArrayEqualBridge;
+        case 0x1f52c: //🔬
+            return primitiveArraySelectBridge;
+        case 0x1f522: //🔢
+            return primitiveArrayCountTrueBridge;
+    }
+    return NULL;
+}
+
+//MARK: Initializers
+
+#define primitiveArrayInitializers(name, valueType, valueSize) \
+static void name##Init(Thread *thread){ \
+    primitiveArrayInit(thread, valueType, valueSize); \
+} \
+static void name##InitWithCapacity(Thread *thread){ \
+    primitiveArrayInit(thread, valueType, valueSize); \
+    EmojicodeInteger capacity = unwrapInteger(stackGetVariable(0, thread)); \
+    if (capacity > 0) { \
+        primitiveArrayReserve(stackGetThisObject(thread), capacity, true, thread); \
+    } \
+} \
+static void name##InitWithList(Thread *thread){ \
+    primitiveArrayInit(thread, valueType, valueSize); \
+    primitiveArrayAppendList(thread); \
+}
+
+primitiveArrayInitializers(integerArray, T_INTEGER, sizeof(EmojicodeInteger))
+primitiveArrayInitializers(doubleArray, T_DOUBLE, sizeof(double))
+primitiveArrayInitializers(booleanArray, T_BOOLEAN, 1)
+primitiveArrayInitializers(byteArray, T_INTEGER, 1)
+
+#undef primitiveArrayInitializers
+
+InitializerFunctionFunctionPointer primitiveArrayInitializerForName(EmojicodeChar cl, EmojicodeChar name){
+    switch (cl) {
+        case 0x1f683: //🚃
+            return name == 0x1F427 ? integerArrayInitWithCapacity : name == 0x1F368 ? integerArrayInitWithList :
+                   integerArrayInit;
+        case 0x1f6f0: //🛰
+            return name == 0x1F427 ? doubleArrayInitWithCapacity : name == 0x1F368 ? doubleArrayInitWithList :
+                   doubleArrayInit;
+        case 0x1f64c: //🙌
+            return name == 0x1F427 ? booleanArrayInitWithCapacity : name == 0x1F368 ? booleanArrayInitWithList :
+                   booleanArrayInit;
+        case 0x1f4be: //💾
+            return name == 0x1F427 ? byteArrayInitWithCapacity : name == 0x1F368 ? byteArrayInitWithList :
+                   byteArrayInit;
+    }
+    return NULL;
+}
@@ -0,0 +1,353 @@
+//
+//  EmojicodePriorityQueue.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodePriorityQueue.h"
+#include "EmojicodeList.h"
+#include "EmojicodeString.h"
+
+#include <string.h>
+
+#define items(queue) ((Something *)(queue)->items->value)
+
+/** The number of children of every element in the heap. */
+#define PRIORITY_QUEUE_ARITY 4
+
+void priorityQueueMark(Object *self){
+    PriorityQueue *queue = self->value;
+    if (queue->items) {
+        mark(&queue->items);
+    }
+    for (size_t i = 0; i < queue->count; i++) {
+        if (isRealObject(items(queue)[i])) {
+            mark(&items(queue)[i].object);
+        }
+    }
+    if (queue->comparator) {
+        mark(&queue->comparator);
+    }
+}
+
+static inline PriorityQueue* thisQueue(Thread *thread){
+    return stackGetThisObject(thread)->value;
+}
+
+/**
+ * Ensures that the queue can store @c size elements. Unless @c exactly is true, the queue grows by at least half of
+ * its capacity. Returns @c queueObject, which might have been moved.
+ * @warning GC-invoking
+ */
+static Object* priorityQueueReserve(Object *queueObject, size_t size, bool exactly, Thread *thread){
+    PriorityQueue *queue = queueObject->value;
+    if (queue->capacity >= size) {
+        return queueObject;
+    }
+    size_t capacity = queue->capacity + (queue->capacity >> 1);
+    if (exactly || capacity < size) {
+        capacity = size;
+    }
+    
+    stackPush(somethingObject(queueObject), 0, 0, thread);
+    Object *itemsObject = newArray(sizeCalculationWithOverflowProtection(capacity, sizeof(Something)));
+    queueObject = stackGetThisObject(thread);
+    stackPop(thread);
+    
+    queue = queueObject->value;
+    if (queue->count) {
+        memcpy(itemsObject->value, items(queue), queue->count * sizeof(Something));
+    }
+    queue->items = itemsObject;
+    queue->capacity = capacity;
+    return queueObject;
+}
+
+/** Determines the order of a queue without comparator from its first element or checks that @c item matches it. */
+static void priorityQueueCheckItem(PriorityQueue *queue, Something item){
+    PriorityQueueOrder order;
+    switch (item.type) {
+        case T_INTEGER:
+            order = PriorityQueueOrderIntegers;
+            break;
+        case T_DOUBLE:
+            order = PriorityQueueOrderDoubles;
+            break;
+        case T_SYMBOL:
+            order = PriorityQueueOrderSymbols;
+            break;
+        default:
+            order = isRealObject(item) && item.object->class == CL_STRING ? PriorityQueueOrderStrings :
+                                                                             PriorityQueueOrderUndetermined;
+            break;
+    }
+    if (queue->order == PriorityQueueOrderUndetermined) {
+        queue->order = order;
+    }
+    if (order == PriorityQueueOrderUndetermined || queue->order != order) {
+        error("🗻 without a comparator can only order elements that are all 🚂, 🚀, 🔣 or 🔡.");
+    }
+}
+
+/**
+ * Returns true if @c a must be dequeued before @c b.
+ * @warning GC-invoking if the queue has a comparator. All pointers into the queue must be reloaded afterwards.
+ */
+static inline bool priorityQueueLess(PriorityQueue *queue, Something a, Something b, Thread *thread){
+    switch (queue->order) {
+        case PriorityQueueOrderIntegers:
+            return a.raw < b.raw;
+        case PriorityQueueOrderDoubles:
+            return a.doubl < b.doubl;
+        case PriorityQueueOrderSymbols:
+            return unwrapSymbol(a) < unwrapSymbol(b);
+        case PriorityQueueOrderStrings:
+            return stringCompare(a.object->value, b.object->value) < 0;
+        default: {
+            Something args[2] = {a, b};
+            return executeCallableExtern(queue->comparator, args, thread).raw < 0;
+        }
+    }
+}
+
+/** Moves the element at @c index up until its parent is not greater. The queue must be in the this-slot. */
+static void priorityQueueSiftUp(size_t index, Thread *thread){
+    while (index > 0) {
+        size_t parent = (index - 1) / PRIORITY_QUEUE_ARITY;
+        PriorityQueue *queue = thisQueue(thread);
+        if (!priorityQueueLess(queue, items(queue)[index], items(queue)[parent], thread)) {
+            break;
+        }
+        queue = thisQueue(thread);
+        Something item = items(queue)[index];
+        items(queue)[index] = items(queue)[parent];
+        items(queue)[parent] = item;
+        index = parent;
+    }
+}
+
+/** Moves the element at @c index down until none of its children is smaller. The queue must be in the this-slot. */
+static void priorityQueueSiftDown(size_t index, Thread *thread){
+    while (true) {
+        PriorityQueue *queue = thisQueue(thread);
+        size_t first = PRIORITY_QUEUE_ARITY * index + 1;
+        if (first >= queue->count) {
+            break;
+        }
+        size_t end = queue->count - first < PRIORITY_QUEUE_ARITY ? queue->count : first + PRIORITY_QUEUE_ARITY;
+        size_t smallest = first;
+        for (size_t child = first + 1; child < end; child++) {
+            if (priorityQueueLess(queue, items(queue)[child], items(queue)[smallest], thread)) {
+                smallest = child;
+            }
+            queue = thisQueue(thread);
+        }
+        if (!priorityQueueLess(queue, items(queue)[smallest], items(queue)[index], thread)) {
+            break;
+        }
+        queue = thisQueue(thread);
+        Something item = items(queue)[index];
+        items(queue)[index] = items(queue)[smallest];
+        items(queue)[smallest] = item;
+        index = smallest;
+    }
+}
+
+/**
+ * Replaces the smallest element with @c item, or the last element if @c item is @c NULL, and restores the heap.
+ * Returns the replaced element. The queue must be in the this-slot and must not be empty.
+ * @warning GC-invoking
+ */
+static Something priorityQueueReplaceTop(Something *item, Thread *thread){
+    PriorityQueue *queue = thisQueue(thread);
+    Something top = items(queue)[0];
+    if (item) {
+        items(queue)[0] = *item;
+    }
+    else {
+        queue->count--;
+        items(queue)[0] = items(queue)[queue->count];
+        items(queue)[queue->count] = NOTHINGNESS;
+    }
+    if (queue->order != PriorityQueueOrderCallable) {
+        priorityQueueSiftDown(0, thread);
+        return top;
+    }
+    
+    // The comparator might invoke the garbage collector, so top must be kept on the stack
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, top, thread);
+    priorityQueueSiftDown(0, thread);
+    top = stackGetVariable(0, thread);
+    stackPop(thread);
+    return top;
+}
+
+//MARK: Bridges
+
+static void priorityQueueInit(Thread *thread){
+    PriorityQueue *queue = thisQueue(thread);
+    queue->count = 0;
+    queue->capacity = 0;
+    queue->items = NULL;
+    queue->comparator = NULL;
+    queue->order = PriorityQueueOrderUndetermined;
+}
+
+static void priorityQueueInitWithComparator(Thread *thread){
+    priorityQueueInit(thread);
+    PriorityQueue *queue = thisQueue(thread);
+    queue->order = PriorityQueueOrderCallable;
+    queue->comparator = stackGetVariable(0, thread).object;
+}
+
+static Something priorityQueuePushBridge(Thread *thread){
+    Object *queueObject = priorityQueueReserve(stackGetThisObject(thread), thisQueue(thread)->count + 1, false,
+                                               thread);
+    PriorityQueue *queue = queueObject->value;
+    Something item = stackGetVariable(0, thread);
+    if (queue->order != PriorityQueueOrderCallable) {
+        priorityQueueCheckItem(queue, item);
+    }
+    items(queue)[queue->count++] = item;
+    priorityQueueSiftUp(queue->count - 1, thread);
+    return NOTHINGNESS;
+}
+
+static Something priorityQueuePopBridge(Thread *thread){
+    if (thisQueue(thread)->count == 0) {
+        return NOTHINGNESS;
+    }
+    return priorityQueueReplaceTop(NULL, thread);
+}
+
+static Something priorityQueuePeekBridge(Thread *thread){
+    PriorityQueue *queue = thisQueue(thread);
+    return queue->count ? items(queue)[0] : NOTHINGNESS;
+}
+
+static Something priorityQueuePushPopBridge(Thread *thread){
+    PriorityQueue *queue = thisQueue(thread);
+    Something item = stackGetVariable(0, thread);
+    if (queue->order != PriorityQueueOrderCallable) {
+        priorityQueueCheckItem(queue, item);
+    }
+    if (queue->count == 0 || !priorityQueueLess(queue, items(queue)[0], item, thread)) {
+        return stackGetVariable(0, thread);
+    }
+    item = stackGetVariable(0, thread);
+    return priorityQueueReplaceTop(&item, thread);
+}
+
+static Something priorityQueueCountBridge(Thread *thread){
+    return somethingInteger((EmojicodeInteger)thisQueue(thread)->count);
+}
+
+static Something priorityQueueClearBridge(Thread *thread){
+    PriorityQueue *queue = thisQueue(thread);
+    queue->items = NULL;
+    queue->capacity = 0;
+    queue->count = 0;
+    return NOTHINGNESS;
+}
+
+static Something priorityQueueReserveBridge(Thread *thread){
+    EmojicodeInteger capacity = stackGetVariable(0, thread).raw;
+    if (capacity > 0) {
+        priorityQueueReserve(stackGetThisObject(thread), capacity, true, thread);
+    }
+    return NOTHINGNESS;
+}
+
+static Something priorityQueuePushListBridge(Thread *thread){
+    List *list = stackGetVariable(0, thread).object->value;
+    size_t added = list->count;
+    if (added == 0) {
+        return NOTHINGNESS;
+    }
+    Object *queueObject = priorityQueueReserve(stackGetThisObject(thread), thisQueue(thread)->count + added, false,
+                                               thread);
+    PriorityQueue *queue = queueObject->value;
+    list = stackGetVariable(0, thread).object->value;
+    
+    Something *listItems = list->items->value;
+    if (queue->order != PriorityQueueOrderCallable) {
+        for (size_t i = 0; i < added; i++) {
+            priorityQueueCheckItem(queue, listItems[i]);
+        }
+    }
+    memcpy(items(queue) + queue->count, listItems, added * sizeof(Something));
+    size_t countBefore = queue->count;
+    queue->count += added;
+    
+    if (added > countBefore) {
+        // Building the heap bottom-up takes linear time. The last element with children is the parent of the last one.
+        for (size_t i = (queue->count - 1) / PRIORITY_QUEUE_ARITY + 1; i-- > 0;) {
+            priorityQueueSiftDown(i, thread);
+        }
+    }
+    else {
+        for (size_t i = countBefore; i < countBefore + added; i++) {
+            priorityQueueSiftUp(i, thread);
+        }
+    }
+    return NOTHINGNESS;
+}
+
+static Something priorityQueueDrainBridge(Thread *thread){
+    size_t count = thisQueue(thread)->count;
+    
+    stackPush(stackGetThisContext(thread), 1, 0, thread);
+    stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
+    Object *listItems = newArray(sizeCalculationWithOverflowProtection(count, sizeof(Something)));
+    List *list = stackGetVariable(0, thread).object->value;
+    list->items = listItems;
+    list->capacity = count;
+    
+    for (size_t i = 0; i < count; i++) {
+        PriorityQueue *queue = thisQueue(thread);
+        list = stackGetVariable(0, thread).object->value;
+        ((Something *)list->items->value)[list->count++] = items(queue)[0];
+        queue->count--;
+        items(queue)[0] = items(queue)[queue->count];
+        items(queue)[queue->count] = NOTHINGNESS;
+        priorityQueueSiftDown(0, thread);
+    }
+    
+    Something listSomething = stackGetVariable(0, thread);
+    stackPop(thread);
+    return listSomething;
+}
+
+FunctionFunctionPointer priorityQueueMethodForName(EmojicodeChar method){
+    switch (method) {
+        case 0x1F43B: //🐻
+            return priorityQueuePushBridge;
+        case 0x1F43C: //🐼
+            return priorityQueuePopBridge;
+        case 0x1F43D: //🐽
+            return priorityQueuePeekBridge;
+        case 0x1F425: //🐥
+            return priorityQueuePushPopBridge;
+        case 0x1F414: //🐔
+            return priorityQueueCountBridge;
+        case 0x1F417: //🐗
+            return priorityQueueClearBridge;
+        case 0x1F434: //🐴
+            return priorityQueueReserveBridge;
+        case 0x1F419: //🐙
+            return priorityQueuePushListBridge;
+        case 0x1F413: //🐓
+            return priorityQueueDrainBridge;
+    }
+    return NULL;
+}
+
+InitializerFunctionFunctionPointer priorityQueueInitializerForName(EmojicodeChar name){
+    switch (name) {
+        case 0x1F981: //🦁
+            return priorityQueueInitWithComparator;
+        default:
+            return priorityQueueInit;
+    }
+}
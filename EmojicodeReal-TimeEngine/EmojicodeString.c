@@ -6,12 +6,71 @@
 //  Copyright (c) 2015 Theo Weidmann. All rights reserved.
 //
 
+#include "Emojicode.h"
 #include "EmojicodeString.h"
 
 #include <string.h>
 #include <math.h>
+#include <time.h>
 #include "utf8.h"
 #include "EmojicodeList.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+//MARK: Widths
+
+uint8_t stringWidthOfRange(String *string, EmojicodeInteger from, EmojicodeInteger length){
+    if (string->width == 1) {
+        return 1;
+    }
+    EmojicodeChar max = 0;
+    if (string->width == 2) {
+        uint16_t *characters = (uint16_t *)stringBytes(string) + from;
+        for (EmojicodeInteger i = 0; i < length; i++) {
+            max |= characters[i];
+        }
+    }
+    else {
+        EmojicodeChar *characters = (EmojicodeChar *)stringBytes(string) + from;
+        for (EmojicodeInteger i = 0; i < length; i++) {
+            max |= characters[i];
+        }
+    }
+    return stringWidthForCharacter(max);
+}
+
+void stringCopyCharacters(String *destination, EmojicodeInteger destinationIndex, String *source,
+                          EmojicodeInteger from, EmojicodeInteger length){
+    if (destination->width == source->width) {
+        memcpy(stringBytes(destination) + destinationIndex * destination->width,
+               stringBytes(source) + from * source->width, length * source->width);
+        return;
+    }
+    for (EmojicodeInteger i = 0; i < length; i++) {
+        stringSetCharacter(destination, destinationIndex + i, stringCharacter(source, from + i));
+    }
+}
+
+/** Whether @c b is equal to the characters of @c a starting at @c offset, which must not exceed @c a. */
+static bool stringRegionEqual(String *a, EmojicodeInteger offset, String *b){
+    if (a->width == b->width) {
+        return memcmp(stringBytes(a) + offset * a->width, stringBytes(b),
+                      b->length * b->width) == 0;
+    }
+    if (b->width > a->width) {
+        // b contains a character that cannot be stored in a
+        return false;
+    }
+    for (EmojicodeInteger i = 0; i < b->length; i++) {
+        if (stringCharacter(a, offset + i) != stringCharacter(b, i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+//MARK: Comparing
 
 EmojicodeInteger stringCompare(String *a, String *b) {
     if (a == b) {
@@ -20,12 +79,324 @@ EmojicodeInteger stringCompare(String *a, String *b) {
     if (a->length != b->length) {
         return a->length - b->length;
     }
+    if (a->width == 1 && b->width == 1) {
+        return memcmp(stringBytes(a), stringBytes(b), a->length);
+    }
     
-    return memcmp(a->characters->value, b->characters->value, a->length * sizeof(EmojicodeChar));
+    for (EmojicodeInteger i = 0; i < a->length; i++) {
+        EmojicodeChar ca = stringCharacter(a, i), cb = stringCharacter(b, i);
+        if (ca != cb) {
+            return ca < cb ? -1 : 1;
+        }
+    }
+    return 0;
 }
 
 bool stringEqual(String *a, String *b){
-    return stringCompare(a, b) == 0;
+    if (a == b) {
+        return true;
+    }
+    // Strings always have the smallest possible width, so equal strings have equal widths
+    if ((a->interned && b->interned) || a->length != b->length || a->width != b->width || (a->hash && b->hash && a->hash != b->hash)) {
+        return false;
+    }
+    return memcmp(stringBytes(a), stringBytes(b), a->length * a->width) == 0;
+}
+
+//MARK: Searching
+
+static EmojicodeInteger findCharacter16(const uint16_t *characters, EmojicodeInteger length, uint16_t c){
+    EmojicodeInteger i = 0;
+#ifdef __SSE2__
+    __m128i needle = _mm_set1_epi16((short)c);
+    for (; i + 8 <= length; i += 8) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(characters + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(block, needle));
+        if (mask) {
+            return i + __builtin_ctz(mask) / 2;
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        if (characters[i] == c) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static EmojicodeInteger findCharacter32(const EmojicodeChar *characters, EmojicodeInteger length, EmojicodeChar c){
+    EmojicodeInteger i = 0;
+#ifdef __SSE2__
+    __m128i needle = _mm_set1_epi32((int)c);
+    for (; i + 4 <= length; i += 4) {
+        __m128i block = _mm_loadu_si128((const __m128i *)(characters + i));
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi32(block, needle));
+        if (mask) {
+            return i + __builtin_ctz(mask) / 4;
+        }
+    }
+#endif
+    for (; i < length; i++) {
+        if (characters[i] == c) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+EmojicodeInteger stringFindCharacter(String *string, EmojicodeChar c, EmojicodeInteger from){
+    if (from >= string->length || stringWidthForCharacter(c) > string->width) {
+        return -1;
+    }
+    EmojicodeInteger index;
+    switch (string->width) {
+        case 1: {
+            Byte *characters = stringBytes(string);
+            Byte *found = memchr(characters + from, (int)c, string->length - from);
+            return found ? found - characters : -1;
+        }
+        case 2:
+            index = findCharacter16((uint16_t *)stringBytes(string) + from, string->length - from, (uint16_t)c);
+            break;
+        default:
+            index = findCharacter32((EmojicodeChar *)stringBytes(string) + from, string->length - from, c);
+            break;
+    }
+    return index < 0 ? -1 : from + index;
+}
+
+EmojicodeInteger stringFind(String *string, String *search, EmojicodeInteger from){
+    if (from < 0 || from > string->length || search->length > string->length - from ||
+        search->width > string->width) {
+        // Strings have the smallest possible width, so a wider string cannot be contained
+        return -1;
+    }
+    if (search->length == 0) {
+        return from;
+    }
+    if (search->length == 1) {
+        return stringFindCharacter(string, stringCharacter(search, 0), from);
+    }
+    
+    uint8_t width = string->width;
+    size_t searchSize = search->length * width;
+    Byte *needle = stringBytes(search);
+    if (search->width != width) {
+        needle = malloc(searchSize);
+        if (!needle) {
+            error("Cannot allocate memory to search the string.");
+        }
+        for (EmojicodeInteger i = 0; i < search->length; i++) {
+            if (width == 2) {
+                ((uint16_t *)needle)[i] = (uint16_t)stringCharacter(search, i);
+            }
+            else {
+                ((EmojicodeChar *)needle)[i] = stringCharacter(search, i);
+            }
+        }
+    }
+    
+    // memmem searches bytes, so matches that do not begin at a character are skipped
+    Byte *characters = stringBytes(string), *end = characters + string->length * width;
+    Byte *found = characters + from * width;
+    EmojicodeInteger index = -1;
+    while ((found = memmem(found, end - found, needle, searchSize))) {
+        if ((found - characters) % width == 0) {
+            index = (found - characters) / width;
+            break;
+        }
+        found++;
+    }
+    
+    if (needle != stringBytes(search)) {
+        free(needle);
+    }
+    return index;
+}
+
+//MARK: Interning
+
+/** The capacity of an empty intern table. Intern tables are open-addressing tables of at most 3/4 load. */
+#define INTERN_TABLE_MINIMUM_CAPACITY 64
+
+/** Inserts @c string, which is not in the table, into the table of @c instance. */
+static void internTableInsert(Instance *instance, Object *string){
+    size_t mask = instance->internTableCapacity - 1;
+    size_t i = ((String *)string->value)->hash & mask;
+    while (instance->internTable[i]) {
+        i = (i + 1) & mask;
+    }
+    instance->internTable[i] = string;
+    instance->internTableCount++;
+}
+
+/** Replaces the intern table of @c instance by an empty table with the given capacity and returns the old one. */
+static Object** internTableReplace(Instance *instance, size_t capacity){
+    Object **table = instance->internTable;
+    instance->internTable = calloc(capacity, sizeof(Object *));
+    if (!instance->internTable) {
+        error("Cannot allocate the intern table.");
+    }
+    instance->internTableCapacity = capacity;
+    instance->internTableCount = 0;
+    return table;
+}
+
+Object* stringIntern(Object *stringObject){
+    String *string = stringObject->value;
+    if (string->interned) {
+        return stringObject;
+    }
+    uint64_t hash = stringHash(string);
+    
+    Instance *instance = currentInstance;
+    pthread_mutex_lock(&instance->internTableMutex);
+    
+    if (instance->internTable) {
+        size_t mask = instance->internTableCapacity - 1;
+        for (size_t i = hash & mask; instance->internTable[i]; i = (i + 1) & mask) {
+            String *candidate = instance->internTable[i]->value;
+            if (candidate->hash == hash && stringEqual(candidate, string)) {
+                pthread_mutex_unlock(&instance->internTableMutex);
+                return instance->internTable[i];
+            }
+        }
+    }
+    
+    if ((instance->internTableCount + 1) * 4 > instance->internTableCapacity * 3) {
+        size_t oldCapacity = instance->internTableCapacity;
+        Object **old = internTableReplace(instance, oldCapacity ? oldCapacity * 2 : INTERN_TABLE_MINIMUM_CAPACITY);
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (old[i]) {
+                internTableInsert(instance, old[i]);
+            }
+        }
+        free(old);
+    }
+    internTableInsert(instance, stringObject);
+    // Strings outside of the heap are read-only; they are still found but compared by their characters
+    if (isPossibleObjectPointer(stringObject)) {
+        string->interned = true;
+    }
+    
+    pthread_mutex_unlock(&instance->internTableMutex);
+    return stringObject;
+}
+
+void stringInternTableSweep(Instance *instance){
+    if (!instance->internTable) {
+        return;
+    }
+    size_t oldCapacity = instance->internTableCapacity, count = 0;
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (instance->internTable[i] && gcUpdateWeakReference(&instance->internTable[i])) {
+            count++;
+        }
+        else {
+            instance->internTable[i] = NULL;
+        }
+    }
+    
+    size_t capacity = INTERN_TABLE_MINIMUM_CAPACITY;
+    while ((count + 1) * 4 > capacity * 3) {
+        capacity *= 2;
+    }
+    Object **old = internTableReplace(instance, capacity);
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (old[i]) {
+            internTableInsert(instance, old[i]);
+        }
+    }
+    free(old);
+}
+
+//MARK: Hashing
+
+static uint64_t stringHashSeed;
+
+#define HASH_SECRET_1 0xa0761d6478bd642fULL
+#define HASH_SECRET_2 0xe7037ed1a0b428dbULL
+
+/** Multiplies @c a and @c b and folds the 128-bit product into 64 bits. */
+static inline uint64_t hashMix(uint64_t a, uint64_t b){
+#ifdef __SIZEOF_INT128__
+    __uint128_t product = (__uint128_t)a * b;
+    return (uint64_t)product ^ (uint64_t)(product >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t)a, lb = (uint32_t)b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    return lo ^ (rh + (rm0 >> 32) + (rm1 >> 32) + c);
+#endif
+}
+
+static inline uint64_t hashRead64(const Byte *p){
+    uint64_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint64_t hashRead32(const Byte *p){
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/** A hash in the style of wyhash, which consumes 16 bytes per multiplication. */
+static uint64_t hashBytes(const Byte *bytes, size_t length){
+    uint64_t seed = stringHashSeed ^ HASH_SECRET_1;
+    const Byte *p = bytes;
+    size_t left = length;
+    
+    for (; left > 16; left -= 16, p += 16) {
+        seed = hashMix(hashRead64(p) ^ HASH_SECRET_2, hashRead64(p + 8) ^ seed);
+    }
+    
+    // The remaining 0 to 16 bytes are read as possibly overlapping words
+    uint64_t a = 0, b = 0;
+    if (left >= 8) {
+        a = hashRead64(p);
+        b = hashRead64(p + left - 8);
+    }
+    else if (left >= 4) {
+        a = hashRead32(p);
+        b = hashRead32(p + left - 4);
+    }
+    else if (left > 0) {
+        a = ((uint64_t)p[0] << 16) | ((uint64_t)p[left >> 1] << 8) | p[left - 1];
+    }
+    return hashMix(HASH_SECRET_1 ^ length, hashMix(a ^ HASH_SECRET_2, b ^ seed));
+}
+
+void stringHashSeedInit(){
+    if (stringHashSeed) {
+        return;
+    }
+    FILE *random = fopen("/dev/urandom", "rb");
+    if (!random || fread(&stringHashSeed, sizeof(stringHashSeed), 1, random) != 1) {
+        stringHashSeed = hashMix((uint64_t)time(NULL) ^ HASH_SECRET_1, (uint64_t)(uintptr_t)&stringHashSeed);
+    }
+    if (random) {
+        fclose(random);
+    }
+    stringHashSeed |= 1;
+}
+
+uint64_t integerHash(uint64_t value){
+    return hashMix(value ^ stringHashSeed, HASH_SECRET_2);
+}
+
+uint64_t stringHash(String *string){
+    if (string->hash) {
+        return string->hash;
+    }
+    uint64_t hash = hashBytes(stringBytes(string), string->length * string->width);
+    // 0 marks a hash that was not computed yet
+    string->hash = hash ? hash : 1;
+    return string->hash;
 }
 
 bool stringBeginsWith(String *a, String *with){
@@ -33,7 +404,7 @@ bool stringBeginsWith(String *a, String *with){
         return false;
     }
     
-    return memcmp(a->characters->value, with->characters->value, with->length * sizeof(EmojicodeChar)) == 0;
+    return stringRegionEqual(a, 0, with);
 }
 
 bool stringEndsWith(String *a, String *end){
@@ -41,7 +412,7 @@ bool stringEndsWith(String *a, String *end){
         return false;
     }
     
-    return memcmp(((EmojicodeChar*)a->characters->value) + (a->length - end->length), end->characters->value, end->length * sizeof(EmojicodeChar)) == 0;
+    return stringRegionEqual(a, a->length - end->length, end);
 }
 
 /** @warning GC-invoking */
@@ -64,30 +435,63 @@ Object* stringSubstring(Object *stro, EmojicodeInteger from, EmojicodeInteger le
         }
     }
     
+    String *string = stackGetThisObject(thread)->value;
+    if (from == 0 && length == string->length) {
+        stackPop(thread);
+        return stro;
+    }
+    
+    uint8_t width = stringWidthOfRange(string, from, length);
     stackSetVariable(0, somethingObject(newObject(CL_STRING)), thread);
-    Object *co = newArray(length * sizeof(EmojicodeChar));
     
     Object *ostro = stackGetVariable(0, thread).object;
     String *ostr = ostro->value;
+    string = stackGetThisObject(thread)->value;
     
     ostr->length = length;
-    ostr->characters = co;
+    ostr->width = width;
     
-    memcpy(ostr->characters->value, characters((String *)stackGetThisObject(thread)->value) + from, length * sizeof(EmojicodeChar));
+    if (width == string->width) {
+        // The substring shares the characters of the string, which are never changed
+        ostr->characters = string->characters;
+        ostr->offset = string->offset + from * string->width;
+    }
+    else {
+        Object *co = newArray(length * width);
+        ostro = stackGetVariable(0, thread).object;
+        ostr = ostro->value;
+        ostr->characters = co;
+        stringCopyCharacters(ostr, 0, stackGetThisObject(thread)->value, from, length);
+    }
     
     stackPop(thread);
     return ostro;
 }
 
-void initStringFromSymbolList(Object *string, List *list){
-    String *str = string->value;
+void initStringFromSymbolList(Object *string, Object *list, Thread *thread){
+    size_t count = ((List *)list->value)->count;
+    EmojicodeChar max = 0;
+    for (size_t i = 0; i < count; i++) {
+        max |= (EmojicodeChar)listGet(list->value, i).raw;
+    }
+    uint8_t width = stringWidthForCharacter(max);
+    
+    stackPush(stackGetThisContext(thread), 2, 0, thread);
+    stackSetVariable(0, somethingObject(string), thread);
+    stackSetVariable(1, somethingObject(list), thread);
+    
+    Object *characters = newArray(count * width);
+    
+    String *str = stackGetVariable(0, thread).object->value;
+    List *symbols = stackGetVariable(1, thread).object->value;
+    stackPop(thread);
     
-    size_t count = list->count;
     str->length = count;
-    str->characters = newArray(count * sizeof(EmojicodeChar));
+    str->width = width;
+    str->characters = characters;
     
     for (size_t i = 0; i < count; i++) {
-        characters(str)[i] = (EmojicodeChar)listGet(list, i).raw;
+        stringSetCharacter(str, i, (EmojicodeChar)listGet(symbols, i).raw);
     }
 }
 
@@ -95,17 +499,19 @@ void initStringFromSymbolList(Object *string, List *list){
 
 char* stringToChar(String *str){
     //Size needed for UTF8 representation
-    size_t ds = u8_codingsize(characters(str), str->length);
+    size_t ds = u8_codingsize_width(stringBytes(str), str->width, str->length);
     //Allocate space for the UTF8 string
     char *utf8str = malloc(ds + 1);
     //Convert
-    size_t written = u8_toutf8(utf8str, ds, characters(str), str->length);
+    size_t written = u8_toutf8_width(utf8str, ds, stringBytes(str), str->width, str->length);
     utf8str[written] = 0;
     return utf8str;
 }
 
 Object* stringFromChar(const char *cstring){
-    EmojicodeInteger len = u8_strlen(cstring);
+    size_t size = strlen(cstring);
+    EmojicodeChar max;
+    EmojicodeInteger len = u8_toucs_measure(cstring, size, &max);
     
     if(len == 0){
         return emptyString;
@@ -114,13 +520,70 @@ Object* stringFromChar(const char *cstring){
     Object *stro = newObject(CL_STRING);
     String *string = stro->value;
     string->length = len;
-    string->characters = newArray(len * sizeof(EmojicodeChar));
+    string->width = stringWidthForCharacter(max);
+    Object *characters = newArray(len * string->width);
+    string = stro->value;
+    string->characters = characters;
     
-    u8_toucs(characters(string), len, cstring, strlen(cstring));
+    u8_toucs_width(characters->value, string->width, len, cstring, size);
     
     return stro;
 }
 
+//MARK: Numbers
+
+EmojicodeInteger integerStringLength(EmojicodeInteger n, EmojicodeInteger base){
+    EmojicodeInteger length = n < 0 ? 2 : 1;
+    while (n /= base) length++;
+    return length;
+}
+
+void integerWriteToString(String *string, EmojicodeInteger index, EmojicodeInteger n, EmojicodeInteger base){
+    EmojicodeInteger a = llabs(n);
+    EmojicodeInteger i = index + integerStringLength(n, base);
+    do
+        stringSetCharacter(string, --i, "0123456789abcdefghijklmnopqrstuvxyz"[a % base % 35]);
+    while (a /= base);
+    
+    if (n < 0) stringSetCharacter(string, --i, '-');
+}
+
+/** Returns the number of digits before the decimal point of @c absD. */
+static EmojicodeInteger doubleIntegerDigits(double absD){
+    EmojicodeInteger digits = 1;
+    for (size_t i = 1; pow(10, i) < absD; i++) {
+        digits++;
+    }
+    return digits;
+}
+
+EmojicodeInteger doubleStringLength(double d, EmojicodeInteger precision){
+    EmojicodeInteger length = d < 0 ? 1 : 0;
+    if (precision != 0) {
+        length++;
+    }
+    return length + precision + doubleIntegerDigits(fabs(d));
+}
+
+void doubleWriteToString(String *string, EmojicodeInteger index, double d, EmojicodeInteger precision){
+    double absD = fabs(d);
+    EmojicodeInteger c = index + doubleStringLength(d, precision);
+    
+    for (size_t i = precision; i > 0; i--) {
+        stringSetCharacter(string, --c, (unsigned char) (fmod(absD * pow(10, i), 10.0)) % 10 + '0');
+    }
+    
+    if (precision != 0) {
+        stringSetCharacter(string, --c, '.');
+    }
+    
+    for (size_t i = 0, iLength = doubleIntegerDigits(absD); i < iLength; i++) {
+        stringSetCharacter(string, --c, (unsigned char) (fmod(absD / pow(10, i), 10.0)) % 10 + '0');
+    }
+    
+    if (d < 0) stringSetCharacter(string, --c, '-');
+}
+
 //MARK: Bridges
 
 static Something stringPrintStdoutBrigde(Thread *thread){
@@ -155,21 +618,52 @@ static Something stringSubstringBridge(Thread *thread){
 static Something stringSearchBridge(Thread *thread){
     String *string = stackGetThisObject(thread)->value;
     String *search = stackGetVariable(0, thread).object->value;
+    EmojicodeInteger index = stringFind(string, search, 0);
+    return index < 0 ? NOTHINGNESS : somethingInteger(index);
+}
+
+static Something stringSearchLastBridge(Thread *thread){
+    String *string = stackGetThisObject(thread)->value;
+    String *search = stackGetVariable(0, thread).object->value;
+    EmojicodeInteger last = -1;
+    for (EmojicodeInteger i = stringFind(string, search, 0); i >= 0; i = stringFind(string, search, i + 1)) {
+        last = i;
+    }
+    return last < 0 ? NOTHINGNESS : somethingInteger(last);
+}
+
+static Something stringCountBridge(Thread *thread){
+    String *string = stackGetThisObject(thread)->value;
+    String *search = stackGetVariable(0, thread).object->value;
+    EmojicodeInteger step = search->length ? search->length : 1, count = 0;
+    for (EmojicodeInteger i = stringFind(string, search, 0); i >= 0; i = stringFind(string, search, i + step)) {
+        count++;
+    }
+    return somethingInteger(count);
+}
+
+static Something stringSearchAllBridge(Thread *thread){
+    Something search = stackGetVariable(0, thread);
+    stackPush(stackGetThisContext(thread), 2, 0, thread);
+    stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
+    stackSetVariable(0, search, thread);
     
-    for (EmojicodeInteger i = 0; i < string->length; ++i){
-        bool found = true;
-        for (EmojicodeInteger j = 0; j < search->length; ++j) {
-            if (characters(string)[i + j] != characters(search)[j]) {
-                found = false;
-                break;
-            }
-        }
-        
-        if (found) {
-            return somethingInteger(i);
+    EmojicodeInteger step = ((String *)search.object->value)->length;
+    if (step == 0) {
+        step = 1;
+    }
+    
+    for (EmojicodeInteger i = 0;; i += step) {
+        i = stringFind(stackGetThisObject(thread)->value, stackGetVariable(0, thread).object->value, i);
+        if (i < 0) {
+            break;
         }
+        listAppend(stackGetVariable(1, thread).object, somethingInteger(i), thread);
     }
-    return NOTHINGNESS;
+    
+    Something list = stackGetVariable(1, thread);
+    stackPop(thread);
+    return list;
 }
 
 static Something stringTrimBridge(Thread *thread){
@@ -178,10 +672,10 @@ static Something stringTrimBridge(Thread *thread){
     EmojicodeInteger start = 0;
     EmojicodeInteger stop = string->length - 1;
     
-    while(start < string->length && isWhitespace(characters(string)[start]))
+    while(start < string->length && isWhitespace(stringCharacter(string, start)))
         start++;
     
-    while(stop > 0 && isWhitespace(characters(string)[stop]))
+    while(stop > 0 && isWhitespace(stringCharacter(string, stop)))
         stop--;
     
     return somethingObject(stringSubstring(stackGetThisObject(thread), start, stop - start + 1, thread));
@@ -215,16 +709,30 @@ static void stringGetInput(Thread *thread) {
         buffer = resizeArray(buffer, bufferSize);
     }
 
-    EmojicodeInteger len = u8_strlen_l(buffer->value, bufferUsedSize);
+    EmojicodeChar max;
+    EmojicodeInteger len = u8_toucs_measure(buffer->value, bufferUsedSize, &max);
     
     String *string = stackGetThisObject(thread)->value;
     string->length = len;
+    string->width = stringWidthForCharacter(max);
     
-    Object *chars = newArray(len * sizeof(EmojicodeChar));
+    stackPush(somethingObject(buffer), 0, 0, thread);
+    Object *chars = newArray(len * string->width);
+    buffer = stackGetThisObject(thread);
+    stackPop(thread);
     string = stackGetThisObject(thread)->value;
     string->characters = chars;
     
-    u8_toucs(characters(string), len, buffer->value, bufferUsedSize);
+    u8_toucs_width(chars->value, string->width, len, buffer->value, bufferUsedSize);
+}
+
+/**
+ * Appends the @c length characters of the string in the this-slot starting at @c from to the list in variable
+ * @c listIndex. @warning GC-invoking
+ */
+static void stringAppendPiece(EmojicodeInteger from, EmojicodeInteger length, uint8_t listIndex, Thread *thread){
+    Object *piece = stringSubstring(stackGetThisObject(thread), from, length, thread);
+    listAppend(stackGetVariable(listIndex, thread).object, somethingObject(piece), thread);
 }
 
 static Something stringSplitByStringBridge(Thread *thread) {
@@ -234,45 +742,19 @@ static Something stringSplitByStringBridge(Thread *thread) {
     stackSetVariable(1, somethingObject(newObject(CL_LIST)), thread);
     stackSetVariable(0, sp, thread);
     
-    EmojicodeInteger firstOfSeperator = 0, seperatorIndex = 0, firstAfterSeperator = 0;
-    
-    for (EmojicodeInteger i = 0, l = ((String *)stackGetThisObject(thread)->value)->length; i < l; i++) {
-        Object *stringObject = stackGetThisObject(thread);
-        Object *separatorObject = stackGetVariable(0, thread).object;
-        String *separator = (String *)separatorObject->value;
-        if(characters((String *)stringObject->value)[i] == characters(separator)[seperatorIndex]){
-            if (seperatorIndex == 0) {
-                firstOfSeperator = i;
-            }
-            
-            //Full seperator found
-            if(firstOfSeperator + separator->length == i + 1){
-                Object *stro;
-                if(firstAfterSeperator == firstOfSeperator){
-                    stro = emptyString;
-                }
-                else {
-                    stro = stringSubstring(stringObject, firstAfterSeperator, i - firstAfterSeperator - separator->length + 1, thread);
-                }
-                listAppend(stackGetVariable(1, thread).object, somethingObject(stro), thread);
-                seperatorIndex = 0;
-                firstAfterSeperator = i + 1;
-            }
-            else {
-                seperatorIndex++;
-            }
-        }
-        else if(seperatorIndex > 0){ //and not matching
-            seperatorIndex = 0;
-            //We search from the begin of the last partial match
-            i = firstOfSeperator;
+    EmojicodeInteger from = 0;
+    while (true) {
+        String *string = stackGetThisObject(thread)->value;
+        String *separator = stackGetVariable(0, thread).object->value;
+        EmojicodeInteger index = separator->length ? stringFind(string, separator, from) : -1;
+        if (index < 0) {
+            stringAppendPiece(from, string->length - from, 1, thread);
+            break;
         }
+        stringAppendPiece(from, index - from, 1, thread);
+        from = index + separator->length;
     }
     
-    Object *stringObject = stackGetThisObject(thread);
-    String *string = (String *)stringObject->value;
-    listAppend(stackGetVariable(1, thread).object, somethingObject(stringSubstring(stringObject, firstAfterSeperator, string->length - firstAfterSeperator, thread)), thread);
-    
     Something list = stackGetVariable(1, thread);
     stackPop(thread);
     return list;
@@ -285,22 +767,31 @@ static Something stringLengthBridge(Thread *thread){
 
 static Something stringUTF8LengthBridge(Thread *thread){
     String *str = stackGetThisObject(thread)->value;
-    return somethingInteger((EmojicodeInteger)u8_codingsize(str->characters->value, str->length));
+    return somethingInteger((EmojicodeInteger)u8_codingsize_width(stringBytes(str), str->width, str->length));
 }
 
 static Something stringByAppendingSymbolBridge(Thread *thread){
-    Object *co = newArray((((String *)stackGetThisObject(thread)->value)->length + 1) * sizeof(EmojicodeChar));
-    String *string = stackGetThisObject(thread)->value;
+    EmojicodeChar symbol = unwrapSymbol(stackGetVariable(0, thread));
+    uint8_t width = ((String *)stackGetThisObject(thread)->value)->width;
+    if (stringWidthForCharacter(symbol) > width) {
+        width = stringWidthForCharacter(symbol);
+    }
     
+    Object *co = newArray((((String *)stackGetThisObject(thread)->value)->length + 1) * width);
+    stackPush(somethingObject(co), 0, 0, thread);
     Object *ostro = newObject(CL_STRING);
+    co = stackGetThisObject(thread);
+    stackPop(thread);
+    
+    String *string = stackGetThisObject(thread)->value;
     String *ostr = ostro->value;
     
     ostr->length = string->length + 1;
     ostr->characters = co;
+    ostr->width = width;
     
-    memcpy(characters(ostr), characters(string), string->length * sizeof(EmojicodeChar));
-    
-    characters(ostr)[string->length] = unwrapSymbol(stackGetVariable(0, thread));
+    stringCopyCharacters(ostr, 0, string, 0, string->length);
+    stringSetCharacter(ostr, string->length, symbol);
     
     return somethingObject(ostro);
 }
@@ -312,7 +803,7 @@ static Something stringSymbolAtBridge(Thread *thread){
         return NOTHINGNESS;
     }
     
-    return somethingInteger(characters(str)[index]);
+    return somethingInteger(stringCharacter(str, index));
 }
 
 static Something stringBeginsWithBridge(Thread *thread){
@@ -329,18 +820,16 @@ static Something stringSplitBySymbolBridge(Thread *thread){
     stackSetVariable(0, somethingObject(newObject(CL_LIST)), thread);
     
     EmojicodeInteger from = 0;
-    
-    for (EmojicodeInteger i = 0, l = ((String *)stackGetThisObject(thread)->value)->length; i < l; i++) {
-        Object *stringObject = stackGetThisObject(thread);
-        if (characters((String *)stringObject->value)[i] == separator) {
-            listAppend(stackGetVariable(0, thread).object, somethingObject(stringSubstring(stringObject, from, i - from, thread)), thread);
-            from = i + 1;
+    while (true) {
+        String *string = stackGetThisObject(thread)->value;
+        EmojicodeInteger index = stringFindCharacter(string, separator, from);
+        if (index < 0) {
+            stringAppendPiece(from, string->length - from, 0, thread);
+            break;
         }
-        
+        stringAppendPiece(from, index - from, 0, thread);
+        from = index + 1;
     }
-
-    Object *stringObject = stackGetThisObject(thread);
-    listAppend(stackGetVariable(0, thread).object, somethingObject(stringSubstring(stringObject, from, ((String *) stringObject->value)->length - from, thread)), thread);
     
     Something list = stackGetVariable(0, thread);
     stackPop(thread);
@@ -350,12 +839,12 @@ static Something stringSplitBySymbolBridge(Thread *thread){
 static Something stringToData(Thread *thread){
     String *str = stackGetThisObject(thread)->value;
     
-    size_t ds = u8_codingsize(characters(str), str->length);
+    size_t ds = u8_codingsize_width(stringBytes(str), str->width, str->length);
     
     Object *bytesObject = newArray(ds);
     
     str = stackGetThisObject(thread)->value;
-    u8_toutf8(bytesObject->value, ds, characters(str), str->length);
+    u8_toutf8_width(bytesObject->value, ds, stringBytes(str), str->width, str->length);
     
     stackPush(somethingObject(bytesObject), 0, 0, thread);
     
@@ -375,37 +864,53 @@ static Something stringToCharacterList(Thread *thread){
     Object *list = newObject(CL_LIST);
     
     for (size_t i = 0; i < str->length; i++) {
-        listAppend(list, somethingSymbol(characters(str)[i]), thread);
+        listAppend(list, somethingSymbol(stringCharacter(str, i)), thread);
     }
     return somethingObject(list);
 }
 
 static Something stringJSON(Thread *thread){
-    return parseJSON(thread);
+    return parseJSON(thread, false);
+}
+
+static Something stringJSONInterningKeys(Thread *thread){
+    return parseJSON(thread, true);
+}
+
+static Something stringInternBridge(Thread *thread){
+    return somethingObject(stringIntern(stackGetThisObject(thread)));
 }
 
 static void stringFromSymbolListBridge(Thread *thread){
-    initStringFromSymbolList(stackGetThisObject(thread), stackGetVariable(0, thread).object->value);
+    initStringFromSymbolList(stackGetThisObject(thread), stackGetVariable(0, thread).object, thread);
 }
 
 static void stringFromStringList(Thread *thread) {
     size_t stringSize = 0;
     size_t appendLocation = 0;
+    uint8_t width = 1;
     
     {
         List *list = stackGetVariable(0, thread).object->value;
         String *glue = stackGetVariable(1, thread).object->value;
         
         for (size_t i = 0; i < list->count; i++) {
-            stringSize += ((String *)listGet(list, i).object->value)->length;
+            String *aString = listGet(list, i).object->value;
+            stringSize += aString->length;
+            if (aString->width > width) {
+                width = aString->width;
+            }
         }
         
         if (list->count > 0){
             stringSize += glue->length * (list->count - 1);
         }
+        if (list->count > 1 && glue->width > width) {
+            width = glue->width;
+        }
     }
         
-    Object *co = newArray(stringSize * sizeof(EmojicodeChar));
+    Object *co = newArray(stringSize * width);
     
     {
         List *list = stackGetVariable(0, thread).object->value;
@@ -414,26 +919,30 @@ static void stringFromStringList(Thread *thread) {
         String *string = stackGetThisObject(thread)->value;
         string->length = stringSize;
         string->characters = co;
+        string->width = width;
         
         for (size_t i = 0; i < list->count; i++) {
             String *aString = listGet(list, i).object->value;
-            memcpy(characters(string) + appendLocation, characters(aString), aString->length * sizeof(EmojicodeChar));
+            stringCopyCharacters(string, appendLocation, aString, 0, aString->length);
             appendLocation += aString->length;
             if(i + 1 < list->count){
-                memcpy(characters(string) + appendLocation, characters(glue), glue->length * sizeof(EmojicodeChar));
+                stringCopyCharacters(string, appendLocation, glue, 0, glue->length);
                 appendLocation += glue->length;
             }
         }
     }
 }
 
-static Something charactersToInteger(EmojicodeChar *characters, EmojicodeInteger base, EmojicodeInteger length) {
+/** Parses the @c length characters of @c string starting at @c from as integer. */
+static Something charactersToInteger(String *string, EmojicodeInteger from, EmojicodeInteger base,
+                                     EmojicodeInteger length) {
     if (length == 0) {
         return NOTHINGNESS;
     }
     EmojicodeInteger x = 0;
     for (size_t i = 0; i < length; i++) {
-        if (i == 0 && (characters[i] == '-' || characters[i] == '+')) {
+        EmojicodeChar c = stringCharacter(string, from + i);
+        if (i == 0 && (c == '-' || c == '+')) {
             if (length < 2) {
                 return NOTHINGNESS;
             }
@@ -441,14 +950,14 @@ static Something charactersToInteger(EmojicodeChar *characters, EmojicodeInteger
         }
         
         EmojicodeInteger b = base;
-        if ('0' <= characters[i] && characters[i] <= '9') {
-            b = characters[i] - '0';
+        if ('0' <= c && c <= '9') {
+            b = c - '0';
         }
-        else if ('A' <= characters[i] && characters[i] <= 'Z') {
-            b = characters[i] - 'A' + 10;
+        else if ('A' <= c && c <= 'Z') {
+            b = c - 'A' + 10;
         }
-        else if ('a' <= characters[i] && characters[i] <= 'z') {
-            b = characters[i] - 'a' + 10;
+        else if ('a' <= c && c <= 'z') {
+            b = c - 'a' + 10;
         }
         
         if (b >= base) {
@@ -459,7 +968,7 @@ static Something charactersToInteger(EmojicodeChar *characters, EmojicodeInteger
         x += b;
     }
     
-    if (characters[0] == '-') {
+    if (stringCharacter(string, from) == '-') {
         x *= -1;
     }
     return somethingInteger(x);
@@ -469,7 +978,7 @@ static Something stringToInteger(Thread *thread) {
     EmojicodeInteger base = stackGetVariable(0, thread).raw;
     String *string = (String *)stackGetThisObject(thread)->value;
     
-    return charactersToInteger(characters(string), base, string->length);
+    return charactersToInteger(string, 0, base, string->length);
 }
 
 
@@ -480,23 +989,22 @@ static Something stringToDouble(Thread *thread){
         return NOTHINGNESS;
     }
     
-    EmojicodeChar *characters = characters(string);
-    
     double d = 0.0;
     bool sign = true;
     bool foundSeparator = false;
     bool foundDigit = false;
     size_t i = 0, decimalPlace = 0;
     
-    if (characters[0] == '-') {
+    if (stringCharacter(string, 0) == '-') {
         sign = false;
         i++;
-    } else if (characters[0] == '+') {
+    } else if (stringCharacter(string, 0) == '+') {
         i++;
     }
     
     for (; i < string->length; i++) {
-        if (characters[i] == '.') {
+        EmojicodeChar c = stringCharacter(string, i);
+        if (c == '.') {
             if (foundSeparator) {
                 return NOTHINGNESS;
             } else {
@@ -504,8 +1012,8 @@ static Something stringToDouble(Thread *thread){
                 continue;
             }
         }
-        if (characters[i] == 'e' || characters[i] == 'E') {
-            Something exponent = charactersToInteger(characters + i + 1, 10, string->length - i - 1);
+        if (c == 'e' || c == 'E') {
+            Something exponent = charactersToInteger(string, i + 1, 10, string->length - i - 1);
             if (isNothingness(exponent)) {
                 return NOTHINGNESS;
             } else {
@@ -513,9 +1021,9 @@ static Something stringToDouble(Thread *thread){
             }
             break;
         }
-        if ('0' <= characters[i] && characters[i] <= '9') {
+        if ('0' <= c && c <= '9') {
             d *= 10;
-            d += characters[i] - '0';
+            d += c - '0';
             if (foundSeparator) {
                 decimalPlace++;
             }
@@ -544,8 +1052,10 @@ static Something stringCompareBridge(Thread *thread) {
 }
 
 void stringMark(Object *self){
-    if(((String *)self->value)->characters){
-        mark(&((String *)self->value)->characters);
+    String *string = self->value;
+    if(string->characters){
+        // Small substrings of a large string are given their own characters, so the large one can be freed
+        markArraySlice(&string->characters, &string->offset, string->length * string->width);
     }
 }
 
@@ -565,6 +1075,12 @@ FunctionFunctionPointer stringMethodForName(EmojicodeChar name){
             return stringSubstringBridge;
         case 0x1F50D: //🔍
             return stringSearchBridge;
+        case 0x1F50E: //🔎
+            return stringSearchLastBridge;
+        case 0x1F522: //🔢
+            return stringCountBridge;
+        case 0x1F52D: //🔭
+            return stringSearchAllBridge;
         case 0x1F527: //🔧
             return stringTrimBridge;
         case 0x1F52B: //🔫
@@ -583,6 +1099,10 @@ FunctionFunctionPointer stringMethodForName(EmojicodeChar name){
             return stringToData;
         case 0x1f4f0: //📰
             return stringJSON;
+        case 0x1F4D1: //📑
+            return stringJSONInterningKeys;
+        case 0x1F3F7: //🏷
+            return stringInternBridge;
         case 0x1F682: //🚂
             return stringToInteger;
         case 0x1F680: //🚀
@@ -604,3 +1124,158 @@ InitializerFunctionFunctionPointer stringInitializerForName(EmojicodeChar name){
     }
     return NULL;
 }
+
+//MARK: String Builder
+
+/** Returns a string consisting of the characters of the builder, which is only valid until the builder changes. */
+static String stringBuilderString(StringBuilder *builder){
+    return (String){ .length = builder->length, .characters = builder->characters, .width = builder->width };
+}
+
+/**
+ * Makes sure the builder in the this-slot can store @c count more characters of width @c width.
+ * @warning GC-invoking
+ */
+static void stringBuilderReserve(EmojicodeInteger count, uint8_t width, Thread *thread){
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    EmojicodeInteger length = builder->length + count;
+    if (builder->characters && length <= builder->capacity && width <= builder->width) {
+        return;
+    }
+    
+    if (width < builder->width) {
+        width = builder->width;
+    }
+    EmojicodeInteger capacity = builder->capacity < 16 ? 16 : builder->capacity;
+    while (capacity < length) {
+        capacity *= 2;
+    }
+    
+    Object *characters = newArray(sizeCalculationWithOverflowProtection(capacity, width));
+    builder = stackGetThisObject(thread)->value;
+    
+    if (builder->characters) {
+        String source = stringBuilderString(builder);
+        String destination = { .length = builder->length, .characters = characters, .width = width };
+        stringCopyCharacters(&destination, 0, &source, 0, builder->length);
+    }
+    builder->characters = characters;
+    builder->capacity = capacity;
+    builder->width = width;
+    builder->shared = false;
+}
+
+void stringBuilderInit(Thread *thread){
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    builder->width = 1;
+}
+
+static Something stringBuilderAppendString(Thread *thread){
+    String *string = stackGetVariable(0, thread).object->value;
+    stringBuilderReserve(string->length, string->width, thread);
+    
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    string = stackGetVariable(0, thread).object->value;
+    String destination = stringBuilderString(builder);
+    stringCopyCharacters(&destination, builder->length, string, 0, string->length);
+    builder->length += string->length;
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderAppendSymbol(Thread *thread){
+    EmojicodeChar symbol = unwrapSymbol(stackGetVariable(0, thread));
+    stringBuilderReserve(1, stringWidthForCharacter(symbol), thread);
+    
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    String destination = stringBuilderString(builder);
+    stringSetCharacter(&destination, builder->length++, symbol);
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderAppendInteger(Thread *thread){
+    EmojicodeInteger n = unwrapInteger(stackGetVariable(0, thread));
+    EmojicodeInteger base = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger length = integerStringLength(n, base);
+    stringBuilderReserve(length, 1, thread);
+    
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    String destination = stringBuilderString(builder);
+    integerWriteToString(&destination, builder->length, n, base);
+    builder->length += length;
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderAppendDouble(Thread *thread){
+    double d = unwrapDouble(stackGetVariable(0, thread));
+    EmojicodeInteger precision = unwrapInteger(stackGetVariable(1, thread));
+    EmojicodeInteger length = doubleStringLength(d, precision);
+    stringBuilderReserve(length, 1, thread);
+    
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    String destination = stringBuilderString(builder);
+    doubleWriteToString(&destination, builder->length, d, precision);
+    builder->length += length;
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderLength(Thread *thread){
+    return somethingInteger(((StringBuilder *)stackGetThisObject(thread)->value)->length);
+}
+
+static Something stringBuilderClear(Thread *thread){
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    if (builder->shared) {
+        builder->characters = NULL;
+        builder->capacity = 0;
+        builder->shared = false;
+    }
+    else {
+        // The characters are reused with width 1
+        builder->capacity *= builder->width;
+    }
+    builder->length = 0;
+    builder->width = 1;
+    return NOTHINGNESS;
+}
+
+static Something stringBuilderToString(Thread *thread){
+    if (((StringBuilder *)stackGetThisObject(thread)->value)->length == 0) {
+        return somethingObject(emptyString);
+    }
+    
+    Object *stringObject = newObject(CL_STRING);
+    StringBuilder *builder = stackGetThisObject(thread)->value;
+    String *string = stringObject->value;
+    
+    // The string takes the characters instead of a copy of them
+    *string = stringBuilderString(builder);
+    builder->shared = true;
+    return somethingObject(stringObject);
+}
+
+void stringBuilderMark(Object *self){
+    StringBuilder *builder = self->value;
+    if (builder->characters) {
+        mark(&builder->characters);
+    }
+}
+
+FunctionFunctionPointer stringBuilderMethodForName(EmojicodeChar name){
+    switch (name) {
+        case 0x1F43B: //🐻
+            return stringBuilderAppendString;
+        case 0x1F4DD: //📝
+            return stringBuilderAppendSymbol;
+        case 0x1F682: //🚂
+            return stringBuilderAppendInteger;
+        case 0x1F680: //🚀
+            return stringBuilderAppendDouble;
+        case 0x1F414: //🐔
+            return stringBuilderLength;
+        case 0x1F417: //🐗
+            return stringBuilderClear;
+        case 0x1F521: //🔡
+            return stringBuilderToString;
+    }
+    return NULL;
+}
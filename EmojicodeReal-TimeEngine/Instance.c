@@ -0,0 +1,246 @@
+//
+//  Instance.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeEmbedding.h"
+#include <setjmp.h>
+#include <string.h>
+
+_Thread_local Instance *currentInstance;
+
+_Thread_local Class **classTable;
+_Thread_local uint_fast16_t classTableCount;
+_Thread_local Function **functionTable;
+_Thread_local uint_fast16_t functionTableCount;
+_Thread_local Object **stringPool;
+_Thread_local uint_fast16_t stringPoolCount;
+
+//MARK: Programs
+
+Program* newProgram(){
+    Program *program = calloc(1, sizeof(Program));
+    if (!program) {
+        error("Cannot allocate program!");
+    }
+    return program;
+}
+
+void programSetTables(Program *program, Function *main){
+    program->classTable = classTable;
+    program->classTableCount = classTableCount;
+    program->functionTable = functionTable;
+    program->functionTableCount = functionTableCount;
+    program->stringPool = stringPool;
+    program->stringPoolCount = stringPoolCount;
+    program->main = main;
+}
+
+void programAddNamedFunction(Program *program, EmojicodeChar typeName, EmojicodeChar name, Function *function){
+    size_t count = program->namedFunctionCount;
+    // The capacity is always the next power of two, at least 16
+    if (count == 0 || (count >= 16 && (count & (count - 1)) == 0)) {
+        size_t capacity = count == 0 ? 16 : count * 2;
+        NamedFunction *functions = realloc(program->namedFunctions, sizeof(NamedFunction) * capacity);
+        if (!functions) {
+            error("Cannot allocate function names!");
+        }
+        program->namedFunctions = functions;
+    }
+    program->namedFunctions[count] = (NamedFunction){typeName, name, function};
+    program->namedFunctionCount++;
+}
+
+//MARK: Instances
+
+Instance* newInstance(Program *program, char **arguments, int argumentCount){
+    Instance *instance = calloc(1, sizeof(Instance));
+    if (!instance) {
+        error("Cannot allocate instance!");
+    }
+    instance->program = program;
+    instance->cliArguments = arguments;
+    instance->cliArgumentCount = argumentCount;
+
+    instance->currentHeap = calloc(heapSize, 1);
+    if (!instance->currentHeap) {
+        free(instance);
+        error("Cannot allocate heap!");
+    }
+    instance->otherHeap = instance->currentHeap + (heapSize / 2);
+
+    pthread_mutex_init(&instance->threadListMutex, NULL);
+    pthread_mutex_init(&instance->pausingThreadsCountMutex, NULL);
+    pthread_mutex_init(&instance->allocationMutex, NULL);
+    pthread_mutex_init(&instance->internTableMutex, NULL);
+    pthread_cond_init(&instance->pauseThreadsFalsedCondition, NULL);
+    pthread_cond_init(&instance->threadsCountCondition, NULL);
+    return instance;
+}
+
+void enterInstance(Instance *instance){
+    currentInstance = instance;
+    classTable = instance->program->classTable;
+    classTableCount = instance->program->classTableCount;
+    functionTable = instance->program->functionTable;
+    functionTableCount = instance->program->functionTableCount;
+    stringPool = instance->program->stringPool;
+    stringPoolCount = instance->program->stringPoolCount;
+}
+
+static void leaveInstance(Instance *previous){
+    if (previous) {
+        enterInstance(previous);
+    }
+    else {
+        currentInstance = NULL;
+    }
+}
+
+void emojicodeDestroyInstance(Instance *instance){
+    Instance *previous = currentInstance;
+    enterInstance(instance);
+
+    Byte *currentObjectPointer = instance->currentHeap;
+    while (currentObjectPointer < instance->currentHeap + instance->memoryUse) {
+        Object *currentObject = (Object *)currentObjectPointer;
+        if (currentObject->class->deconstruct) {
+            currentObject->class->deconstruct(currentObject->value);
+        }
+        currentObjectPointer += currentObject->size;
+    }
+
+    // Threads of calls aborted by an error remain in the list
+    for (Thread *thread = instance->lastThread, *before; thread; thread = before) {
+        before = thread->threadBefore;
+        free(thread->stackLimit);
+        free(thread);
+    }
+
+    // The synchronization primitives might still be locked if an error occurred
+    if (!instance->failed) {
+        pthread_mutex_destroy(&instance->threadListMutex);
+        pthread_mutex_destroy(&instance->pausingThreadsCountMutex);
+        pthread_mutex_destroy(&instance->allocationMutex);
+        pthread_mutex_destroy(&instance->internTableMutex);
+        pthread_cond_destroy(&instance->pauseThreadsFalsedCondition);
+        pthread_cond_destroy(&instance->threadsCountCondition);
+    }
+
+    free(instance->internTable);
+    free(instance->currentHeap < instance->otherHeap ? instance->currentHeap : instance->otherHeap);
+    free(instance);
+
+    leaveInstance(previous == instance ? NULL : previous);
+}
+
+//MARK: Embedding API
+
+static _Thread_local jmp_buf *embeddedCallJump;
+static _Thread_local char lastError[350];
+
+static pthread_mutex_t loadingMutex = PTHREAD_MUTEX_INITIALIZER;
+
+void abortEmbeddedCall(const char *message){
+    if (embeddedCallJump) {
+        strncpy(lastError, message, sizeof(lastError) - 1);
+        longjmp(*embeddedCallJump, 1);
+    }
+}
+
+const char* emojicodeLastError(){
+    return lastError;
+}
+
+Program* emojicodeLoadProgram(const char *path){
+    FILE *in = fopen(path, "rb");
+    if (!in) {
+        snprintf(lastError, sizeof(lastError), "File couldn't be opened.");
+        return NULL;
+    }
+    if (isSnapshot(in)) {
+        fclose(in);
+        snprintf(lastError, sizeof(lastError), "Snapshot images cannot be embedded.");
+        return NULL;
+    }
+
+    // The reader uses the tables of the calling thread and the immortal region, which is not thread-safe
+    pthread_mutex_lock(&loadingMutex);
+    Instance *previous = currentInstance;
+    jmp_buf *previousJump = embeddedCallJump;
+    jmp_buf jump;
+    Program *volatile program = NULL;
+    if (!setjmp(jump)) {
+        embeddedCallJump = &jump;
+        program = readBytecode(in);
+    }
+    embeddedCallJump = previousJump;
+    leaveInstance(previous);
+    pthread_mutex_unlock(&loadingMutex);
+
+    fclose(in);
+    return program;
+}
+
+Class* emojicodeFindClass(Program *program, EmojicodeChar name){
+    for (uint_fast16_t i = 0; i < program->classTableCount; i++) {
+        if (program->classTable[i]->name == name) {
+            return program->classTable[i];
+        }
+    }
+    return NULL;
+}
+
+Function* emojicodeFindFunction(Program *program, EmojicodeChar typeName, EmojicodeChar name){
+    for (size_t i = 0; i < program->namedFunctionCount; i++) {
+        NamedFunction *namedFunction = program->namedFunctions + i;
+        if (namedFunction->typeName == typeName && namedFunction->name == name) {
+            return namedFunction->function;
+        }
+    }
+    return NULL;
+}
+
+Instance* emojicodeNewInstance(Program *program, char **arguments, int argumentCount){
+    jmp_buf *previousJump = embeddedCallJump;
+    jmp_buf jump;
+    Instance *volatile instance = NULL;
+    if (!setjmp(jump)) {
+        embeddedCallJump = &jump;
+        instance = newInstance(program, arguments, argumentCount);
+    }
+    embeddedCallJump = previousJump;
+    return instance;
+}
+
+bool emojicodeCall(Instance *instance, Function *function, Something callee, Something *arguments,
+                   Something *result){
+    if (instance->failed) {
+        snprintf(lastError, sizeof(lastError), "The instance was aborted by an earlier error.");
+        return false;
+    }
+
+    Instance *previous = currentInstance;
+    jmp_buf *previousJump = embeddedCallJump;
+    jmp_buf jump;
+    bool success = true;
+
+    enterInstance(instance);
+    if (!setjmp(jump)) {
+        embeddedCallJump = &jump;
+        Thread *thread = allocateThread();
+        Something value = performFunctionWithArguments(function, callee, arguments, thread);
+        removeThread(thread);
+        if (result) {
+            *result = value;
+        }
+    }
+    else {
+        instance->failed = true;
+        success = false;
+    }
+    embeddedCallJump = previousJump;
+    leaveInstance(previous);
+    return success;
+}
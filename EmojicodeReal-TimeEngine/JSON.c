@@ -46,7 +46,7 @@ typedef struct {
 
 #define jsonMaxDepth 256
 
-Something parseJSON(Thread *thread) {
+Something parseJSON(Thread *thread, bool internKeys) {
     const size_t length = ((String*)stackGetThisObject(thread)->value)->length;
     JSONStackFrame stack[jsonMaxDepth];
     JSONStackFrame *stackLimit = stack + jsonMaxDepth - 1;
@@ -64,7 +64,7 @@ Something parseJSON(Thread *thread) {
             errorExit();
         }
         
-        c = characters((String *)stackGetThisObject(thread)->value)[i++];
+        c = stringCharacter(stackGetThisObject(thread)->value, i++);
         
         switch (stackCurrent->state) {
             case JSON_STRING:
@@ -74,7 +74,7 @@ Something parseJSON(Thread *thread) {
                         continue;
                     case '"':
                         stackSetVariable(1, somethingObject(newObject(CL_STRING)), thread);
-                        initStringFromSymbolList(stackGetVariable(1, thread).object, stackGetVariable(0, thread).object->value);
+                        initStringFromSymbolList(stackGetVariable(1, thread).object, stackGetVariable(0, thread).object, thread);
                         backValue = stackGetVariable(1, thread);
                         stackPop(thread);
                         popTheStack();
@@ -97,7 +97,7 @@ Something parseJSON(Thread *thread) {
                         appendEscape('r', '\r')
                         appendEscape('t', '\t')
                     case 'u': {
-                        EmojicodeChar *chars = characters((String *)stackGetThisObject(thread)->value);
+                        String *string = stackGetThisObject(thread)->value;
                         EmojicodeInteger x = 0, high = 0;
                         while (true) {
                             for (size_t e = i + 4; i < e; i++) {
@@ -105,7 +105,7 @@ Something parseJSON(Thread *thread) {
                                     errorExit();
                                 }
                                 
-                                c = chars[i];
+                                c = stringCharacter(string, i);
                                 x *= 16;
                                 
                                 if ('0' <= c && c <= '9')
@@ -121,7 +121,7 @@ Something parseJSON(Thread *thread) {
                             if (high)
                                 x = (high << 10) + x + 0x10000 - (0xD800 << 10) - 0xDC00;
                             else if (0xD800 <= x && x <= 0xDBFF) {
-                                if (i + 2 >= length || chars[i++] != '\\' || chars[i++] != 'u') {
+                                if (i + 2 >= length || stringCharacter(string, i++) != '\\' || stringCharacter(string, i++) != 'u') {
                                     errorExit();
                                 }
                                 high = x;
@@ -216,6 +216,9 @@ Something parseJSON(Thread *thread) {
                 if (backValue.type != T_OBJECT || backValue.object->class != CL_STRING) {
                     errorExit();
                 }
+                if (internKeys) {
+                    backValue = somethingObject(stringIntern(backValue.object));
+                }
                 stackSetVariable(1, backValue, thread);
                 stackCurrent->state = JSON_OBJECT_COLON;
                 i--;
@@ -231,7 +234,7 @@ Something parseJSON(Thread *thread) {
                         errorExit();
                 }
             case JSON_OBJECT_VALUE_BACK_VALUE:
-                dictionarySet(stackGetVariable(0, thread).object, stackGetVariable(1, thread).object, backValue, thread);
+                dictionarySet(stackGetVariable(0, thread).object, stackGetVariable(1, thread), backValue, thread);
                 stackCurrent->state = JSON_OBJECT_NEXT;
                 i--;
                 continue;
@@ -10,58 +10,54 @@
 #include "Emojicode.h"
 #include <string.h>
 #include <pthread.h>
+#include <sys/mman.h>
 
-size_t memoryUse = 0;
-bool zeroingNeeded = false;
-
-size_t gcThreshold = heapSize / 2;
-
-int pausingThreadsCount = 0;
-bool pauseThreads = false;
-pthread_mutex_t pausingThreadsCountMutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_mutex_t allocationMutex = PTHREAD_MUTEX_INITIALIZER;
-pthread_cond_t pauseThreadsFalsedCondition = PTHREAD_COND_INITIALIZER;
-pthread_cond_t threadsCountCondition = PTHREAD_COND_INITIALIZER;
+#define gcThreshold (heapSize / 2)
 
 static void* emojicodeMalloc(size_t size){
-    pthread_mutex_lock(&allocationMutex);
-    pauseForGC(&allocationMutex);
-    if (memoryUse + size > gcThreshold) {
+    Instance *instance = currentInstance;
+    pthread_mutex_lock(&instance->allocationMutex);
+    pauseForGC(&instance->allocationMutex);
+    if (instance->memoryUse + size > gcThreshold) {
         if (size > gcThreshold) {
+            pthread_mutex_unlock(&instance->allocationMutex);
             error("Allocation of %zu bytes is too big. Try to enlarge the heap. (Heap size: %zu)", size, heapSize);
         }
         
-        pauseThreads = true;
-        pthread_mutex_unlock(&allocationMutex);
+        instance->pauseThreads = true;
+        pthread_mutex_unlock(&instance->allocationMutex);
         
-        pthread_mutex_lock(&pausingThreadsCountMutex);
-        pausingThreadsCount++;
+        pthread_mutex_lock(&instance->pausingThreadsCountMutex);
+        instance->pausingThreadsCount++;
 
-        while (pausingThreadsCount < threads) pthread_cond_wait(&threadsCountCondition, &pausingThreadsCountMutex);
+        while (instance->pausingThreadsCount < instance->threads) {
+            pthread_cond_wait(&instance->threadsCountCondition, &instance->pausingThreadsCountMutex);
+        }
         gc();
         
-        pausingThreadsCount--;
-        pthread_mutex_unlock(&pausingThreadsCountMutex);
+        instance->pausingThreadsCount--;
+        pthread_mutex_unlock(&instance->pausingThreadsCountMutex);
 
-        pauseThreads = false;
-        pthread_cond_broadcast(&pauseThreadsFalsedCondition);
-        pthread_mutex_lock(&allocationMutex);
+        instance->pauseThreads = false;
+        pthread_cond_broadcast(&instance->pauseThreadsFalsedCondition);
+        pthread_mutex_lock(&instance->allocationMutex);
     }
-    Byte *block = currentHeap + memoryUse;
-    memoryUse += size;
-    pthread_mutex_unlock(&allocationMutex);
+    Byte *block = instance->currentHeap + instance->memoryUse;
+    instance->memoryUse += size;
+    pthread_mutex_unlock(&instance->allocationMutex);
     return (void *)block;
 }
 
 static void* emojicodeRealloc(void *ptr, size_t oldSize, size_t newSize){
-    pthread_mutex_lock(&allocationMutex);
+    Instance *instance = currentInstance;
+    pthread_mutex_lock(&instance->allocationMutex);
     //Nothing has been allocated since the allocation of ptr
-    if (ptr == currentHeap + memoryUse - oldSize) {
-        memoryUse += newSize - oldSize;
-        pthread_mutex_unlock(&allocationMutex);
+    if (ptr == instance->currentHeap + instance->memoryUse - oldSize) {
+        instance->memoryUse += newSize - oldSize;
+        pthread_mutex_unlock(&instance->allocationMutex);
         return ptr;
     }
-    pthread_mutex_unlock(&allocationMutex);
+    pthread_mutex_unlock(&instance->allocationMutex);
     
     void *block = emojicodeMalloc(newSize);
     memcpy(block, ptr, oldSize);
@@ -101,7 +97,7 @@ Object* newObject(Class *class){
 
 size_t sizeCalculationWithOverflowProtection(size_t items, size_t itemSize) {
     size_t r = items * itemSize;
-    if (r / items != itemSize) {
+    if (items && r / items != itemSize) {
         error("Integer overflow while allocating memory. It’s not possible to allocate objects of this size due to hardware limitations.");
     }
     return r;
@@ -125,23 +121,90 @@ Object* resizeArray(Object *array, size_t size){
     return object;
 }
 
-void allocateHeap(){
-    currentHeap = calloc(heapSize, 1);
-    if (!currentHeap) {
-        error("Cannot allocate heap!");
+//MARK: Immortal region
+
+typedef struct ImmortalChunk {
+    struct ImmortalChunk *next;
+    size_t size;
+    size_t used;
+} ImmortalChunk;
+
+#define immortalChunkSize (256 * 1024)
+
+static ImmortalChunk *immortalChunks;
+
+void* immortalAllocate(size_t size){
+    size = (size + 15) & ~(size_t)15;
+    
+    ImmortalChunk *chunk = immortalChunks;
+    if (!chunk || chunk->used + size > chunk->size) {
+        size_t chunkSize = size + sizeof(ImmortalChunk) > immortalChunkSize ? size + sizeof(ImmortalChunk) : immortalChunkSize;
+        chunk = mmap(NULL, chunkSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (chunk == MAP_FAILED) {
+            error("Cannot allocate immortal region!");
+        }
+        chunk->size = chunkSize;
+        chunk->used = (sizeof(ImmortalChunk) + 15) & ~(size_t)15;
+        chunk->next = immortalChunks;
+        immortalChunks = chunk;
     }
-    otherHeap = currentHeap + (heapSize / 2);
+    
+    void *block = (Byte *)chunk + chunk->used;
+    chunk->used += size;
+    return block;
+}
+
+Object* newImmortalObject(Class *class){
+    size_t fullSize = sizeof(Object) + class->size;
+    Object *object = immortalAllocate(fullSize);
+    object->size = fullSize;
+    object->class = class;
+    object->value = ((Byte *)object) + sizeof(Object) + class->instanceVariableCount * sizeof(Something);
+    return object;
+}
+
+Object* newImmortalArray(size_t size){
+    size_t fullSize = sizeof(Object) + size;
+    Object *object = immortalAllocate(fullSize);
+    object->size = fullSize;
+    object->class = CL_ARRAY;
+    object->value = ((Byte *)object) + sizeof(Object);
+    return object;
+}
+
+void sealImmortalRegion(){
+    for (ImmortalChunk *chunk = immortalChunks; chunk; chunk = chunk->next) {
+        mprotect(chunk, chunk->size, PROT_READ);
+    }
+    immortalChunks = NULL;
+}
+
+//MARK: Garbage Collection
+
+/** Whether @c o is in the heap that is being collected. Objects outside of the heap are immortal and never move. */
+static bool isCollected(Instance *instance, Object *o){
+    return instance->otherHeap <= (Byte *)o && (Byte *)o < instance->otherHeap + heapSize / 2;
+}
+
+/** Whether @c o was already copied during this collection. */
+static bool isForwarded(Instance *instance, Object *o){
+    return instance->currentHeap <= (Byte *)o->newLocation &&
+           (Byte *)o->newLocation < instance->currentHeap + heapSize / 2;
 }
 
 void mark(Object **oPointer){
+    Instance *instance = currentInstance;
     Object *o = *oPointer;
-    if (currentHeap <= (Byte *)o->newLocation && (Byte *)o->newLocation < currentHeap + heapSize / 2) {
+    if (!isCollected(instance, o)) {
+        return;
+    }
+    if (isForwarded(instance, o)) {
         *oPointer = o->newLocation;
         return;
     }
     
-    o->newLocation = (Object *)(currentHeap + memoryUse);
-    memoryUse += o->size;
+    o->newLocation = (Object *)(instance->currentHeap + instance->memoryUse);
+    instance->memoryUse += o->size;
     
     memcpy(o->newLocation, o, o->size);
     *oPointer = o->newLocation;
@@ -154,31 +217,148 @@ void mark(Object **oPointer){
     }
 }
 
+bool gcUpdateWeakReference(Object **oPointer){
+    Instance *instance = currentInstance;
+    Object *o = *oPointer;
+    if (!isCollected(instance, o)) {
+        return true;
+    }
+    if (isForwarded(instance, o)) {
+        *oPointer = o->newLocation;
+        return true;
+    }
+    return false;
+}
+
+typedef struct {
+    Object **array;
+    EmojicodeInteger *offset;
+    size_t length;
+} ArraySlice;
+
+/** The slices whose arrays are copied once marking is complete. Only used by the thread running @c gc. */
+static _Thread_local ArraySlice *arraySlices;
+static _Thread_local size_t arraySlicesCount;
+static _Thread_local size_t arraySlicesCapacity;
+
+void markArraySlice(Object **oPointer, EmojicodeInteger *offset, size_t length){
+    Instance *instance = currentInstance;
+    Object *o = *oPointer;
+    if (arraySliceCompactionSize == 0 || !isCollected(instance, o) || isForwarded(instance, o) ||
+        o->size < arraySliceCompactionSize || (sizeof(Object) + length) * 8 > o->size) {
+        mark(oPointer);
+        return;
+    }
+    
+    if (arraySlicesCount == arraySlicesCapacity) {
+        arraySlicesCapacity = arraySlicesCapacity ? arraySlicesCapacity * 2 : 64;
+        arraySlices = realloc(arraySlices, arraySlicesCapacity * sizeof(ArraySlice));
+        if (!arraySlices) {
+            error("Cannot allocate the array slices for the garbage collector.");
+        }
+    }
+    arraySlices[arraySlicesCount++] = (ArraySlice){ oPointer, offset, length };
+}
+
+static int compareArraySlices(const void *a, const void *b){
+    Object *x = *((const ArraySlice *)a)->array, *y = *((const ArraySlice *)b)->array;
+    return x < y ? -1 : x > y;
+}
+
+/**
+ * Copies the arrays of the slices passed to @c markArraySlice. If all slices of an array together use less than an
+ * eighth of it, each slice gets an array of its own. Otherwise the array is copied as usual.
+ */
+static void copyArraySlices(Instance *instance){
+    if (arraySlicesCount == 0) {
+        return;
+    }
+    qsort(arraySlices, arraySlicesCount, sizeof(ArraySlice), compareArraySlices);
+    
+    for (size_t i = 0, end; i < arraySlicesCount; i = end) {
+        Object *o = *arraySlices[i].array;
+        size_t size = 0;
+        for (end = i; end < arraySlicesCount && *arraySlices[end].array == o; end++) {
+            size += sizeof(Object) + arraySlices[end].length;
+        }
+        
+        if (isForwarded(instance, o) || size * 8 > o->size) {
+            for (size_t j = i; j < end; j++) {
+                mark(arraySlices[j].array);
+            }
+            continue;
+        }
+        
+        for (size_t j = i; j < end; j++) {
+            ArraySlice *slice = arraySlices + j;
+            Object *copy = (Object *)(instance->currentHeap + instance->memoryUse);
+            instance->memoryUse += sizeof(Object) + slice->length;
+            
+            copy->size = sizeof(Object) + slice->length;
+            copy->class = o->class;
+            copy->value = ((Byte *)copy) + sizeof(Object);
+            memcpy(copy->value, (Byte *)o->value + *slice->offset, slice->length);
+            *slice->array = copy;
+            *slice->offset = 0;
+        }
+    }
+    
+    free(arraySlices);
+    arraySlices = NULL;
+    arraySlicesCount = arraySlicesCapacity = 0;
+}
+
+/** The weak references that are updated once marking is complete. Only used by the thread running @c gc. */
+static _Thread_local Object ***weakReferences;
+static _Thread_local size_t weakReferencesCount;
+static _Thread_local size_t weakReferencesCapacity;
+
+void markWeakReference(Object **oPointer){
+    if (weakReferencesCount == weakReferencesCapacity) {
+        weakReferencesCapacity = weakReferencesCapacity ? weakReferencesCapacity * 2 : 64;
+        weakReferences = realloc(weakReferences, weakReferencesCapacity * sizeof(Object **));
+        if (!weakReferences) {
+            error("Cannot allocate the weak references for the garbage collector.");
+        }
+    }
+    weakReferences[weakReferencesCount++] = oPointer;
+}
+
+/** Updates the weak references registered with @c markWeakReference and drops those to garbage. */
+static void updateWeakReferences(){
+    for (size_t i = 0; i < weakReferencesCount; i++) {
+        if (*weakReferences[i] && !gcUpdateWeakReference(weakReferences[i])) {
+            *weakReferences[i] = NULL;
+        }
+    }
+    weakReferencesCount = 0;
+}
+
 void gc(){
-    if (zeroingNeeded) {
-        memset(otherHeap, 0, heapSize / 2);
+    Instance *instance = currentInstance;
+    if (instance->zeroingNeeded) {
+        memset(instance->otherHeap, 0, heapSize / 2);
     }
     else {
-        zeroingNeeded = true;
+        instance->zeroingNeeded = true;
     }
     
-    void *tempHeap = currentHeap;
-    currentHeap = otherHeap;
-    otherHeap = tempHeap;
-    size_t oldMemoryUse = memoryUse;
-    memoryUse = 0;
+    Byte *tempHeap = instance->currentHeap;
+    instance->currentHeap = instance->otherHeap;
+    instance->otherHeap = tempHeap;
+    size_t oldMemoryUse = instance->memoryUse;
+    instance->memoryUse = 0;
     
-    for (Thread *thread = lastThread; thread != NULL; thread = thread->threadBefore) {
+    for (Thread *thread = instance->lastThread; thread != NULL; thread = thread->threadBefore) {
         stackMark(thread);
     }
-    
-    for (uint_fast16_t i = 0; i < stringPoolCount; i++) {
-        mark(stringPool + i);
-    }
+    copyArraySlices(instance);
+    updateWeakReferences();
+    stringInternTableSweep(instance);
     
     //Call the deinitializers
-    Byte *currentObjectPointer = otherHeap;
-    while (currentObjectPointer < otherHeap + oldMemoryUse) {
+    Byte *currentObjectPointer = instance->otherHeap;
+    while (currentObjectPointer < instance->otherHeap + oldMemoryUse) {
         Object *currentObject = (Object *)currentObjectPointer;
         if (!currentObject->newLocation && currentObject->class->deconstruct) {
             currentObject->class->deconstruct(currentObject->value);
@@ -186,39 +366,46 @@ void gc(){
         currentObjectPointer += currentObject->size;
     }
    
-    if (oldMemoryUse == memoryUse) {
+    if (oldMemoryUse == instance->memoryUse) {
         error("Terminating program due to too high memory pressure.");
     }
 }
 
 void pauseForGC(pthread_mutex_t *mutex) {
-    if (pauseThreads) {
+    Instance *instance = currentInstance;
+    if (instance->pauseThreads) {
         if (mutex) pthread_mutex_unlock(mutex);
         
-        pthread_mutex_lock(&pausingThreadsCountMutex);
-        pausingThreadsCount++;
-        pthread_cond_signal(&threadsCountCondition);
-        while (pauseThreads) pthread_cond_wait(&pauseThreadsFalsedCondition, &pausingThreadsCountMutex);
-        pausingThreadsCount--;
-        pthread_mutex_unlock(&pausingThreadsCountMutex);
+        pthread_mutex_lock(&instance->pausingThreadsCountMutex);
+        instance->pausingThreadsCount++;
+        pthread_cond_signal(&instance->threadsCountCondition);
+        while (instance->pauseThreads) {
+            pthread_cond_wait(&instance->pauseThreadsFalsedCondition, &instance->pausingThreadsCountMutex);
+        }
+        instance->pausingThreadsCount--;
+        pthread_mutex_unlock(&instance->pausingThreadsCountMutex);
         
         if (mutex) pthread_mutex_lock(mutex);
     }
 }
 
 void allowGC() {
-    pthread_mutex_lock(&pausingThreadsCountMutex);
-    pausingThreadsCount++;
-    pthread_cond_signal(&threadsCountCondition);
-    pthread_mutex_unlock(&pausingThreadsCountMutex);
+    Instance *instance = currentInstance;
+    pthread_mutex_lock(&instance->pausingThreadsCountMutex);
+    instance->pausingThreadsCount++;
+    pthread_cond_signal(&instance->threadsCountCondition);
+    pthread_mutex_unlock(&instance->pausingThreadsCountMutex);
 }
 
 void disallowGCAndPauseIfNeeded() {
-    pthread_mutex_lock(&pausingThreadsCountMutex);
-    while (pauseThreads) pthread_cond_wait(&pauseThreadsFalsedCondition, &pausingThreadsCountMutex);
-    pausingThreadsCount--;
-    pthread_cond_signal(&threadsCountCondition);
-    pthread_mutex_unlock(&pausingThreadsCountMutex);
+    Instance *instance = currentInstance;
+    pthread_mutex_lock(&instance->pausingThreadsCountMutex);
+    while (instance->pauseThreads) {
+        pthread_cond_wait(&instance->pauseThreadsFalsedCondition, &instance->pausingThreadsCountMutex);
+    }
+    instance->pausingThreadsCount--;
+    pthread_cond_signal(&instance->threadsCountCondition);
+    pthread_mutex_unlock(&instance->pausingThreadsCountMutex);
 }
 
 bool instanceof(Object *object, Class *class){
@@ -226,5 +413,5 @@ bool instanceof(Object *object, Class *class){
 }
 
 bool isPossibleObjectPointer(void *s){
-    return (Byte *)s < currentHeap + heapSize/2 && s >= (void *)currentHeap;
+    return (Byte *)s < currentInstance->currentHeap + heapSize/2 && s >= (void *)currentInstance->currentHeap;
 }
\ No newline at end of file
@@ -0,0 +1,113 @@
+//
+//  Prefork.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include <errno.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/wait.h>
+
+EmojicodeInteger workerIndex = -1;
+
+/** Workers exiting faster than this (in seconds) are restarted with a delay to avoid a fork loop. */
+#define minimumWorkerLifetime 1
+
+static volatile sig_atomic_t terminationSignal = 0;
+
+static void supervisorSignalHandler(int signal) {
+    terminationSignal = signal;
+}
+
+static void setTerminationHandlers(void (*handler)(int)) {
+    struct sigaction action;
+    action.sa_handler = handler;
+    action.sa_flags = 0;  // No SA_RESTART, waitpid must return when a signal arrives
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+}
+
+/** Forks a worker with the given index. Returns 0 in the worker and the worker’s pid in the supervisor. */
+static pid_t spawnWorker(EmojicodeInteger index) {
+    pid_t pid = fork();
+    if (pid < 0) {
+        error("Could not fork worker %lld.", (long long)index);
+    }
+    if (pid == 0) {
+        setTerminationHandlers(SIG_DFL);
+        workerIndex = index;
+    }
+    return pid;
+}
+
+EmojicodeInteger preforkWorkers(EmojicodeInteger count) {
+    if (count <= 0) {
+        error("The number of workers must be positive.");
+    }
+    if (workerIndex >= 0) {
+        error("A worker cannot prefork workers.");
+    }
+    if (currentInstance->threads > 1) {
+        error("Cannot prefork while other threads are running.");
+    }
+
+    pid_t *pids = malloc(sizeof(pid_t) * count);
+    time_t *startTimes = malloc(sizeof(time_t) * count);
+    if (!pids || !startTimes) {
+        error("Could not allocate the worker table.");
+    }
+
+    // Buffered output would otherwise be written by every worker
+    fflush(stdout);
+    fflush(stderr);
+    setTerminationHandlers(supervisorSignalHandler);
+
+    for (EmojicodeInteger i = 0; i < count; i++) {
+        startTimes[i] = time(NULL);
+        if ((pids[i] = spawnWorker(i)) == 0) {
+            free(pids);
+            free(startTimes);
+            return i;
+        }
+    }
+
+    while (!terminationSignal) {
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+
+        for (EmojicodeInteger i = 0; i < count; i++) {
+            if (pids[i] != pid) continue;
+
+            if (time(NULL) - startTimes[i] < minimumWorkerLifetime) {
+                sleep(minimumWorkerLifetime);
+                if (terminationSignal) {
+                    pids[i] = 0;
+                    break;
+                }
+            }
+            startTimes[i] = time(NULL);
+            if ((pids[i] = spawnWorker(i)) == 0) {
+                free(pids);
+                free(startTimes);
+                return i;
+            }
+            break;
+        }
+    }
+
+    for (EmojicodeInteger i = 0; i < count; i++) {
+        if (pids[i] > 0) {
+            kill(pids[i], terminationSignal ? terminationSignal : SIGTERM);
+        }
+    }
+    while (waitpid(-1, NULL, 0) > 0 || errno == EINTR);
+    exit(0);
+}
@@ -7,6 +7,7 @@
 //
 
 #include "Emojicode.h"
+#include "EmojicodeString.h"
 #include <string.h>
 #include <dlfcn.h>
 
@@ -18,10 +19,6 @@ EmojicodeChar readEmojicodeChar(FILE *in){
     return ((EmojicodeChar)fgetc(in)) | (fgetc(in) << 8) | ((EmojicodeChar)fgetc(in) << 16) | ((EmojicodeChar)fgetc(in) << 24);
 }
 
-EmojicodeCoin readCoin(FILE *in){
-    return ((EmojicodeCoin)fgetc(in)) | (fgetc(in) << 8) | ((EmojicodeCoin)fgetc(in) << 16) | ((EmojicodeCoin)fgetc(in) << 24);
-}
-
 PackageLoadingState packageLoad(const char *name, uint16_t major, uint16_t minor, FunctionFunctionPointerProvider *hfpMethods,
                                 InitializerFunctionFunctionPointerProvider *hfpIntializer,
                                 mpfc *mpfc, dpfc *dpfc, SizeForClassFunction *sfch){
@@ -65,28 +62,27 @@ void readQualifiedTypeName(EmojicodeChar *name, EmojicodeChar *namespace, FILE *
     *namespace = readEmojicodeChar(in);
 }
 
-uint32_t readBlock(EmojicodeCoin **destination, uint8_t *variableCount, FILE *in){
+uint32_t readBlock(Byte **destination, uint8_t *variableCount, FILE *in){
     *variableCount = fgetc(in);
-    uint32_t coinCount = readEmojicodeChar(in);
+    uint32_t length = readEmojicodeChar(in);
 
-    *destination = malloc(sizeof(EmojicodeCoin) * coinCount);
-    for (uint32_t i = 0; i < coinCount; i++) {
-        (*destination)[i] = readCoin(in);
-    }
+    *destination = immortalAllocate(length);
+    fread(*destination, 1, length, in);
     
-    return coinCount;
+    return length;
 }
 
 void readInitializer(InitializerFunction **table, EmojicodeChar className, FILE *in, InitializerFunctionFunctionPointerProvider hpfc){
     EmojicodeChar name = readEmojicodeChar(in);
     uint16_t vti = readUInt16(in);
 
-    InitializerFunction *initializer = malloc(sizeof(InitializerFunction));
+    InitializerFunction *initializer = immortalAllocate(sizeof(InitializerFunction));
     initializer->argumentCount = fgetc(in);
     
     if (fgetc(in)) {
         initializer->native = true;
         initializer->handler = hpfc(className, name);
+        snapshotRecordNativeInitializer(initializer, className, name);
     }
     else {
         initializer->native = false;
@@ -95,37 +91,39 @@ void readInitializer(InitializerFunction **table, EmojicodeChar className, FILE
     table[vti] = initializer;
 }
 
-void readFunction(Function **table, EmojicodeChar className, FILE *in, FunctionFunctionPointerProvider hpfm){
+void readFunction(Function **table, EmojicodeChar className, FILE *in, FunctionFunctionPointerProvider hpfm,
+                  Program *program){
     EmojicodeChar methodName = readEmojicodeChar(in);
     uint16_t vti = readUInt16(in);
     
-    Function *method = malloc(sizeof(Function));
+    Function *method = immortalAllocate(sizeof(Function));
     method->argumentCount = fgetc(in);
     
     MethodType nativeType;
     if ((nativeType = fgetc(in))) {
         method->native = true;
         method->handler = hpfm(className, methodName, nativeType);
+        snapshotRecordNativeFunction(method, className, methodName, nativeType);
     }
     else {
         method->native = false;
         method->tokenCount = readBlock(&method->tokenStream, &method->variableCount, in);
     }
     table[vti] = method;
+    programAddNamedFunction(program, className, methodName, method);
 }
 
 void readProtocolAgreement(Function **vmt, Function ***pmt, uint_fast16_t offset, FILE *in){
     uint_fast16_t index = readUInt16(in) - offset;
     uint_fast16_t count = readUInt16(in);
-    pmt[index] = malloc(sizeof(Function *) * count);
+    pmt[index] = immortalAllocate(sizeof(Function *) * count);
+    snapshotRecordProtocolAgreement(pmt[index], count);
     for (uint_fast16_t i = 0; i < count; i++) {
         pmt[index][i] = vmt[readUInt16(in)];
     }
 }
 
-void readPackage(FILE *in){
-    static uint16_t classNextIndex = 0;
-    
+void readPackage(FILE *in, uint16_t *classNextIndex, Program *program){
     FunctionFunctionPointerProvider hfpMethods;
     InitializerFunctionFunctionPointerProvider hfpIntializer;
     dpfc dpfc;
@@ -139,6 +137,7 @@ void readPackage(FILE *in){
         dpfc = deinitializerPointerForClass;
         mpfc = markerPointerForClass;
         sfch = sizeForClass;
+        snapshotRecordPackage(NULL, 0, 0);
     }
     else {
         char *name = malloc(sizeof(char) * packageNameLength);
@@ -160,24 +159,27 @@ void readPackage(FILE *in){
             error("Could not load package \"%s\" %s.", name, packageError());
         }
         
+        snapshotRecordPackage(name, major, minor);
         free(name);
     }
     
     for (uint_fast16_t classCount = readUInt16(in); classCount; classCount--) {
         EmojicodeChar name = readEmojicodeChar(in);
         
-        Class *class = malloc(sizeof(Class));
-        classTable[classNextIndex++] = class;
+        Class *class = immortalAllocate(sizeof(Class));
+        classTable[(*classNextIndex)++] = class;
+        class->name = name;
+        snapshotRecordClass(class, name);
         
         class->superclass = classTable[readUInt16(in)];
         class->instanceVariableCount = readUInt16(in);
         
         class->methodCount = readUInt16(in);
-        class->methodsVtable = malloc(sizeof(Function*) * class->methodCount);
+        class->methodsVtable = immortalAllocate(sizeof(Function*) * class->methodCount);
         
         bool inheritsInitializers = fgetc(in);
         class->initializerCount = readUInt16(in);
-        class->initializersVtable = malloc(sizeof(InitializerFunction*) * class->initializerCount);
+        class->initializersVtable = immortalAllocate(sizeof(InitializerFunction*) * class->initializerCount);
         
         uint_fast16_t localMethodCount = readUInt16(in);
         uint_fast16_t localInitializerCount = readUInt16(in);
@@ -193,7 +195,7 @@ void readPackage(FILE *in){
         }
         
         for (uint_fast16_t i = 0; i < localMethodCount; i++) {
-            readFunction(class->methodsVtable, name, in, hfpMethods);
+            readFunction(class->methodsVtable, name, in, hfpMethods, program);
         }
         
         for (uint_fast16_t i = 0; i < localInitializerCount; i++) {
@@ -204,7 +206,7 @@ void readPackage(FILE *in){
         if(protocolCount > 0){
             class->protocolsMaxIndex = readUInt16(in);
             class->protocolsOffset = readUInt16(in);
-            class->protocolsTable = calloc((class->protocolsMaxIndex - class->protocolsOffset + 1), sizeof(Function **));
+            class->protocolsTable = immortalAllocate((class->protocolsMaxIndex - class->protocolsOffset + 1) * sizeof(Function **));
             
             for (uint_fast16_t i = 0; i < protocolCount; i++) {
                 readProtocolAgreement(class->methodsVtable, class->protocolsTable, class->protocolsOffset, in);
@@ -224,50 +226,61 @@ void readPackage(FILE *in){
     }
 }
 
-Function* readBytecode(FILE *in) {
+Program* readBytecode(FILE *in) {
     uint8_t version = fgetc(in);
     if (version != ByteCodeSpecificationVersion) {
         error("The bytecode file (bcsv %d) is not compatible with this interpreter (bcsv %d).\n", version, ByteCodeSpecificationVersion);
     }
     
-    classTable = malloc(sizeof(Class*) * readUInt16(in));
+    Program *program = newProgram();
+    
+    classTableCount = readUInt16(in);
+    classTable = immortalAllocate(sizeof(Class*) * classTableCount);
     
+    uint16_t classNextIndex = 0;
     for (uint8_t i = 0, l = fgetc(in); i < l; i++) {
-        readPackage(in);
+        readPackage(in, &classNextIndex, program);
     }
     
-    CL_STRING = classTable[0];
-    CL_LIST = classTable[1];
-    CL_ERROR = classTable[2];
-    CL_DATA = classTable[3];
-    CL_DICTIONARY = classTable[4];
-    CL_CAPTURED_FUNCTION_CALL = classTable[5];
-    CL_CLOSURE = classTable[6];
-    CL_RANGE = classTable[7];
-    
-    functionTable = malloc(sizeof(Function*) * readUInt16(in));
+    functionTableCount = readUInt16(in);
+    functionTable = immortalAllocate(sizeof(Function*) * functionTableCount);
+    snapshotRecordPackage(NULL, 0, 0);
     for (uint_fast16_t functionSectionCount = readUInt16(in); functionSectionCount; functionSectionCount--) {
         EmojicodeChar name = readEmojicodeChar(in);
         for (uint_fast16_t functionCount = readUInt16(in); functionCount; functionCount--) {
-            readFunction(functionTable, name, in, handlerPointerForMethod);
+            readFunction(functionTable, name, in, handlerPointerForMethod, program);
         }
     }
     
     stringPoolCount = readUInt16(in);
-    stringPool = malloc(sizeof(Object*) * stringPoolCount);
+    stringPool = immortalAllocate(sizeof(Object*) * stringPoolCount);
+    stringHashSeedInit();
     for (uint16_t i = 0; i < stringPoolCount; i++) {
-        Object *o = newObject(CL_STRING);
+        Object *o = newImmortalObject(CL_STRING);
         String *string = o->value;
 
         string->length = readUInt16(in);
-        string->characters = newArray(string->length * sizeof(EmojicodeChar));
+        EmojicodeChar *characters = malloc(string->length * sizeof(EmojicodeChar));
+        EmojicodeChar max = 0;
+        for (uint16_t j = 0; j < string->length; j++) {
+            characters[j] = readEmojicodeChar(in);
+            max |= characters[j];
+        }
         
+        string->width = stringWidthForCharacter(max);
+        string->characters = newImmortalArray(string->length * string->width);
         for (uint16_t j = 0; j < string->length; j++) {
-            ((EmojicodeChar*)string->characters->value)[j] = readEmojicodeChar(in);
+            stringSetCharacter(string, j, characters[j]);
         }
+        free(characters);
+        // The pool is read-only once the immortal region is sealed
+        stringHash(string);
 
         stringPool[i] = o;
     }
     
-    return functionTable[0];
+    sealImmortalRegion();
+    
+    programSetTables(program, functionTable[0]);
+    return program;
 }
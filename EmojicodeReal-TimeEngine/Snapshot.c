@@ -0,0 +1,620 @@
+//
+//  Snapshot.c
+//  Emojicode
+//
+
+#include "Emojicode.h"
+#include "EmojicodeString.h"
+#include <string.h>
+
+/*
+ * A snapshot image contains the state of the engine right after the bytecode was loaded: The class table with all
+ * vtables and protocol tables, the function table, all token streams and the string pool.
+ *
+ * Everything that was allocated in the immortal region while reading the bytecode is laid out in a single block, the
+ * arena. Pointers into the arena are stored as offsets and their locations are listed in the relocation table, so
+ * that loading an image is a matter of one read and a pass over the relocations. The heap is empty at that point.
+ *
+ * Native function pointers cannot be stored as their addresses change from run to run. Instead the image records the
+ * package, class and name of every native function and resolves them again with the package’s providers. Packages are
+ * therefore still loaded but not parsed.
+ */
+
+#define SNAPSHOT_BUILT_IN_PACKAGE UINT8_MAX
+/** Stored in place of a pointer to CL_ARRAY, which is not part of the image. */
+#define SNAPSHOT_ARRAY_CLASS UINT64_MAX
+
+static const char snapshotMagic[4] = {'E', 'M', 'J', 'I'};
+
+typedef struct {
+    char magic[4];
+    uint32_t byteOrder;
+    uint16_t version;
+    uint8_t pointerSize;
+    uint8_t packageCount;
+    uint32_t structSizes[5];
+    uint32_t classCount;
+    uint32_t functionCount;
+    uint32_t stringPoolCount;
+    uint32_t classRecordCount;
+    uint64_t arenaSize;
+    uint64_t relocationCount;
+    uint64_t nativeCount;
+    uint64_t classTableOffset;
+    uint64_t functionTableOffset;
+    uint64_t stringPoolOffset;
+} SnapshotHeader;
+
+typedef struct {
+    uint64_t offset;
+    EmojicodeChar className;
+    EmojicodeChar name;
+    uint8_t package;
+    /** 0 for initializers, the @c MethodType otherwise. */
+    uint8_t kind;
+} SnapshotNative;
+
+typedef struct {
+    uint64_t offset;
+    EmojicodeChar name;
+    uint8_t package;
+} SnapshotClass;
+
+typedef struct {
+    char *name;
+    uint16_t major;
+    uint16_t minor;
+} SnapshotPackage;
+
+typedef struct {
+    const void *pointer;
+    EmojicodeChar className;
+    EmojicodeChar name;
+    uint8_t package;
+    uint8_t kind;
+} RecordedNative;
+
+typedef struct {
+    Class *class;
+    EmojicodeChar name;
+    uint8_t package;
+} RecordedClass;
+
+static bool recording = false;
+static uint8_t currentPackage = SNAPSHOT_BUILT_IN_PACKAGE;
+
+static SnapshotPackage *packages;
+static uint8_t packageCount;
+
+static RecordedNative *natives;
+static size_t nativeCount, nativeCapacity;
+
+static RecordedClass *classes;
+static size_t classCount, classCapacity;
+
+/* Protocol agreement tables do not store their lengths. */
+typedef struct {
+    Function **table;
+    uint16_t length;
+} RecordedAgreement;
+
+static RecordedAgreement *agreements;
+static size_t agreementCount, agreementCapacity;
+
+#define growIfNeeded(array, count, capacity) \
+if ((count) == (capacity)) {\
+    (capacity) = (capacity) ? (capacity) * 2 : 64;\
+    (array) = realloc((array), sizeof(*(array)) * (capacity));\
+}
+
+//MARK: Recording
+
+void snapshotBeginRecording(){
+    recording = true;
+}
+
+void snapshotRecordPackage(const char *name, uint16_t major, uint16_t minor){
+    if (!recording) return;
+    if (!name) {
+        currentPackage = SNAPSHOT_BUILT_IN_PACKAGE;
+        return;
+    }
+    if (packageCount == SNAPSHOT_BUILT_IN_PACKAGE) {
+        error("Too many packages to create a snapshot.");
+    }
+    packages = realloc(packages, sizeof(SnapshotPackage) * (packageCount + 1));
+    packages[packageCount].name = strdup(name);
+    packages[packageCount].major = major;
+    packages[packageCount].minor = minor;
+    currentPackage = packageCount++;
+}
+
+void snapshotRecordClass(Class *class, EmojicodeChar name){
+    if (!recording) return;
+    growIfNeeded(classes, classCount, classCapacity);
+    classes[classCount++] = (RecordedClass){class, name, currentPackage};
+}
+
+static void recordNative(const void *pointer, EmojicodeChar className, EmojicodeChar name, uint8_t kind){
+    growIfNeeded(natives, nativeCount, nativeCapacity);
+    natives[nativeCount++] = (RecordedNative){pointer, className, name, currentPackage, kind};
+}
+
+void snapshotRecordNativeFunction(Function *function, EmojicodeChar className, EmojicodeChar name, MethodType type){
+    if (!recording) return;
+    recordNative(function, className, name, type);
+}
+
+void snapshotRecordNativeInitializer(InitializerFunction *initializer, EmojicodeChar className, EmojicodeChar name){
+    if (!recording) return;
+    recordNative(initializer, className, name, 0);
+}
+
+void snapshotRecordProtocolAgreement(Function **table, uint16_t count){
+    if (!recording) return;
+    growIfNeeded(agreements, agreementCount, agreementCapacity);
+    agreements[agreementCount++] = (RecordedAgreement){table, count};
+}
+
+//MARK: Writing
+
+typedef struct {
+    Byte *bytes;
+    size_t count;
+    size_t capacity;
+    uint64_t *relocations;
+    size_t relocationCount;
+    size_t relocationCapacity;
+    /* Maps already serialized pointers to their offsets. Open addressing, the capacity is a power of two. */
+    const void **keys;
+    uint64_t *offsets;
+    size_t mapCount;
+    size_t mapCapacity;
+} SnapshotWriter;
+
+static size_t pointerSlot(const void *pointer, size_t capacity){
+    return ((uintptr_t)pointer >> 3) * 11400714819323198485llu & (capacity - 1);
+}
+
+static void writerMapGrow(SnapshotWriter *w){
+    const void **oldKeys = w->keys;
+    uint64_t *oldOffsets = w->offsets;
+    size_t oldCapacity = w->mapCapacity;
+    w->mapCapacity = oldCapacity ? oldCapacity * 2 : 1024;
+    w->keys = calloc(w->mapCapacity, sizeof(void *));
+    w->offsets = malloc(w->mapCapacity * sizeof(uint64_t));
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldKeys[i]) {
+            size_t j = pointerSlot(oldKeys[i], w->mapCapacity);
+            while (w->keys[j]) j = (j + 1) & (w->mapCapacity - 1);
+            w->keys[j] = oldKeys[i];
+            w->offsets[j] = oldOffsets[i];
+        }
+    }
+    free(oldKeys);
+    free(oldOffsets);
+}
+
+static bool writerMapGet(SnapshotWriter *w, const void *pointer, uint64_t *offset){
+    if (!w->mapCapacity) return false;
+    for (size_t j = pointerSlot(pointer, w->mapCapacity); w->keys[j]; j = (j + 1) & (w->mapCapacity - 1)) {
+        if (w->keys[j] == pointer) {
+            *offset = w->offsets[j];
+            return true;
+        }
+    }
+    return false;
+}
+
+static void writerMapSet(SnapshotWriter *w, const void *pointer, uint64_t offset){
+    if ((w->mapCount + 1) * 2 > w->mapCapacity) {
+        writerMapGrow(w);
+    }
+    size_t j = pointerSlot(pointer, w->mapCapacity);
+    while (w->keys[j]) j = (j + 1) & (w->mapCapacity - 1);
+    w->keys[j] = pointer;
+    w->offsets[j] = offset;
+    w->mapCount++;
+}
+
+/** Reserves @c size bytes in the arena and returns their offset. Allocations are aligned to 16 bytes. */
+static uint64_t writerAllocate(SnapshotWriter *w, size_t size){
+    size_t offset = (w->count + 15) & ~(size_t)15;
+    if (offset + size > w->capacity) {
+        w->capacity = (offset + size) * 2;
+        w->bytes = realloc(w->bytes, w->capacity);
+    }
+    memset(w->bytes + w->count, 0, offset + size - w->count);
+    w->count = offset + size;
+    return offset;
+}
+
+/** Stores @c target into the slot at @c slot and registers the slot for relocation. */
+static void writerSetPointer(SnapshotWriter *w, uint64_t slot, uint64_t target){
+    memcpy(w->bytes + slot, &target, sizeof(uint64_t));
+    growIfNeeded(w->relocations, w->relocationCount, w->relocationCapacity);
+    w->relocations[w->relocationCount++] = slot;
+}
+
+static uint64_t writeTokenStream(SnapshotWriter *w, Byte *tokenStream, uint32_t length){
+    uint64_t offset = writerAllocate(w, length);
+    memcpy(w->bytes + offset, tokenStream, length);
+    return offset;
+}
+
+static uint64_t writeFunction(SnapshotWriter *w, Function *function){
+    uint64_t offset;
+    if (writerMapGet(w, function, &offset)) {
+        return offset;
+    }
+    offset = writerAllocate(w, sizeof(Function));
+    writerMapSet(w, function, offset);
+
+    Function *copy = (Function *)(w->bytes + offset);
+    *copy = *function;
+    if (function->native) {
+        copy->handler = NULL;
+    }
+    else {
+        uint64_t tokenStream = writeTokenStream(w, function->tokenStream, function->tokenCount);
+        writerSetPointer(w, offset + offsetof(Function, tokenStream), tokenStream);
+    }
+    return offset;
+}
+
+static uint64_t writeInitializer(SnapshotWriter *w, InitializerFunction *initializer){
+    uint64_t offset;
+    if (writerMapGet(w, initializer, &offset)) {
+        return offset;
+    }
+    offset = writerAllocate(w, sizeof(InitializerFunction));
+    writerMapSet(w, initializer, offset);
+
+    InitializerFunction *copy = (InitializerFunction *)(w->bytes + offset);
+    *copy = *initializer;
+    if (initializer->native) {
+        copy->handler = NULL;
+    }
+    else {
+        uint64_t tokenStream = writeTokenStream(w, initializer->tokenStream, initializer->tokenCount);
+        writerSetPointer(w, offset + offsetof(InitializerFunction, tokenStream), tokenStream);
+    }
+    return offset;
+}
+
+static uint16_t agreementLength(Function **table){
+    for (size_t i = 0; i < agreementCount; i++) {
+        if (agreements[i].table == table) {
+            return agreements[i].length;
+        }
+    }
+    error("Snapshot: Unknown protocol agreement table.");
+}
+
+static uint64_t writeClass(SnapshotWriter *w, Class *class);
+
+/** Writes an array of @c count pointers. @c writeElement is used to serialize each non-null element. */
+static uint64_t writePointerArray(SnapshotWriter *w, void **array, size_t count,
+                                  uint64_t (*writeElement)(SnapshotWriter *, void *)){
+    uint64_t offset = writerAllocate(w, count * sizeof(uint64_t));
+    for (size_t i = 0; i < count; i++) {
+        if (array[i]) {
+            uint64_t element = writeElement(w, array[i]);
+            writerSetPointer(w, offset + i * sizeof(uint64_t), element);
+        }
+    }
+    return offset;
+}
+
+static uint64_t writeFunctionElement(SnapshotWriter *w, void *function){
+    return writeFunction(w, function);
+}
+
+static uint64_t writeInitializerElement(SnapshotWriter *w, void *initializer){
+    return writeInitializer(w, initializer);
+}
+
+static uint64_t writeClassElement(SnapshotWriter *w, void *class){
+    return writeClass(w, class);
+}
+
+static uint64_t writeAgreementElement(SnapshotWriter *w, void *table){
+    return writePointerArray(w, table, agreementLength(table), writeFunctionElement);
+}
+
+static uint64_t writeClass(SnapshotWriter *w, Class *class){
+    uint64_t offset;
+    if (writerMapGet(w, class, &offset)) {
+        return offset;
+    }
+    offset = writerAllocate(w, sizeof(Class));
+    writerMapSet(w, class, offset);
+
+    Class copy = *class;
+    copy.deconstruct = NULL;
+    copy.mark = NULL;
+    copy.methodsVtable = NULL;
+    copy.initializersVtable = NULL;
+    copy.protocolsTable = NULL;
+    copy.superclass = NULL;
+    memcpy(w->bytes + offset, &copy, sizeof(Class));
+
+    if (class->superclass) {
+        writerSetPointer(w, offset + offsetof(Class, superclass), writeClass(w, class->superclass));
+    }
+    uint64_t vtable = writePointerArray(w, (void **)class->methodsVtable, class->methodCount, writeFunctionElement);
+    writerSetPointer(w, offset + offsetof(Class, methodsVtable), vtable);
+    uint64_t itable = writePointerArray(w, (void **)class->initializersVtable, class->initializerCount,
+                                        writeInitializerElement);
+    writerSetPointer(w, offset + offsetof(Class, initializersVtable), itable);
+    if (class->protocolsTable) {
+        uint64_t ptable = writePointerArray(w, (void **)class->protocolsTable,
+                                            class->protocolsMaxIndex - class->protocolsOffset + 1,
+                                            writeAgreementElement);
+        writerSetPointer(w, offset + offsetof(Class, protocolsTable), ptable);
+    }
+    return offset;
+}
+
+static uint64_t writeArray(SnapshotWriter *w, Object *array){
+    uint64_t offset = writerAllocate(w, array->size);
+    memcpy(w->bytes + offset, array, array->size);
+    writerSetPointer(w, offset + offsetof(Object, class), SNAPSHOT_ARRAY_CLASS);
+    writerSetPointer(w, offset + offsetof(Object, value), offset + sizeof(Object));
+    return offset;
+}
+
+static uint64_t writeStringElement(SnapshotWriter *w, void *pointer){
+    Object *object = pointer;
+    uint64_t offset = writerAllocate(w, object->size);
+    memcpy(w->bytes + offset, object, object->size);
+
+    uint64_t valueOffset = offset + ((Byte *)object->value - (Byte *)object);
+    writerSetPointer(w, offset + offsetof(Object, class), writeClass(w, object->class));
+    writerSetPointer(w, offset + offsetof(Object, value), valueOffset);
+
+    String *string = object->value;
+    writerSetPointer(w, valueOffset + offsetof(String, characters), writeArray(w, string->characters));
+    // The hash depends on the seed of the process and is computed again when the snapshot is read
+    memset(w->bytes + valueOffset + offsetof(String, hash), 0, sizeof(string->hash));
+    return offset;
+}
+
+void writeSnapshot(FILE *out){
+    if (!recording) {
+        error("Snapshot: Recording must be enabled before the bytecode is read.");
+    }
+
+    SnapshotWriter w = {0};
+
+    uint64_t classTableOffset = writePointerArray(&w, (void **)classTable, classTableCount, writeClassElement);
+    uint64_t functionTableOffset = writePointerArray(&w, (void **)functionTable, functionTableCount,
+                                                     writeFunctionElement);
+    uint64_t stringPoolOffset = writePointerArray(&w, (void **)stringPool, stringPoolCount, writeStringElement);
+    uint64_t arenaSize = writerAllocate(&w, 0);
+
+    SnapshotNative *nativeRecords = malloc(sizeof(SnapshotNative) * nativeCount);
+    for (size_t i = 0; i < nativeCount; i++) {
+        uint64_t offset;
+        if (!writerMapGet(&w, natives[i].pointer, &offset)) {
+            error("Snapshot: A native function is not reachable from the class or function tables.");
+        }
+        nativeRecords[i] = (SnapshotNative){offset, natives[i].className, natives[i].name,
+            natives[i].package, natives[i].kind};
+    }
+
+    SnapshotClass *classRecords = malloc(sizeof(SnapshotClass) * classCount);
+    for (size_t i = 0; i < classCount; i++) {
+        classRecords[i] = (SnapshotClass){writeClass(&w, classes[i].class), classes[i].name, classes[i].package};
+    }
+
+    if (w.count != arenaSize) {
+        error("Snapshot: Classes were found that were not part of the class table.");
+    }
+
+    SnapshotHeader header = {
+        .byteOrder = 0x01020304,
+        .version = ByteCodeSpecificationVersion,
+        .pointerSize = sizeof(void *),
+        .packageCount = packageCount,
+        .structSizes = {sizeof(Class), sizeof(Function), sizeof(InitializerFunction), sizeof(Object), sizeof(String)},
+        .classCount = classTableCount,
+        .functionCount = functionTableCount,
+        .stringPoolCount = stringPoolCount,
+        .classRecordCount = classCount,
+        .arenaSize = arenaSize,
+        .relocationCount = w.relocationCount,
+        .nativeCount = nativeCount,
+        .classTableOffset = classTableOffset,
+        .functionTableOffset = functionTableOffset,
+        .stringPoolOffset = stringPoolOffset,
+    };
+    memcpy(header.magic, snapshotMagic, sizeof(snapshotMagic));
+
+    fwrite(&header, sizeof(header), 1, out);
+    for (uint8_t i = 0; i < packageCount; i++) {
+        size_t length = strlen(packages[i].name);
+        if (length > UINT8_MAX) {
+            error("Snapshot: The package name \"%s\" is too long.", packages[i].name);
+        }
+        fputc(length, out);
+        fwrite(packages[i].name, 1, length, out);
+        fwrite(&packages[i].major, sizeof(uint16_t), 1, out);
+        fwrite(&packages[i].minor, sizeof(uint16_t), 1, out);
+    }
+    fwrite(w.bytes, 1, w.count, out);
+    fwrite(w.relocations, sizeof(uint64_t), w.relocationCount, out);
+    fwrite(nativeRecords, sizeof(SnapshotNative), nativeCount, out);
+    fwrite(classRecords, sizeof(SnapshotClass), classCount, out);
+
+    free(nativeRecords);
+    free(classRecords);
+    free(w.bytes);
+    free(w.relocations);
+    free(w.keys);
+    free(w.offsets);
+
+    if (ferror(out)) {
+        error("Snapshot: The image could not be written.");
+    }
+}
+
+//MARK: Loading
+
+bool isSnapshot(FILE *in){
+    char magic[sizeof(snapshotMagic)];
+    bool isImage = fread(magic, 1, sizeof(magic), in) == sizeof(magic) && memcmp(magic, snapshotMagic, sizeof(magic)) == 0;
+    rewind(in);
+    return isImage;
+}
+
+typedef struct {
+    FunctionFunctionPointerProvider methods;
+    InitializerFunctionFunctionPointerProvider initializers;
+    mpfc markers;
+    dpfc deinitializers;
+} SnapshotProviders;
+
+static void readOrFail(void *destination, size_t size, size_t count, FILE *in){
+    if (fread(destination, size, count, in) != count) {
+        error("Snapshot: The image is truncated.");
+    }
+}
+
+/** Fails unless @c size bytes starting at @c offset lie within the arena. */
+static void checkArenaRange(uint64_t offset, uint64_t size, uint64_t arenaSize){
+    if (offset > arenaSize || size > arenaSize - offset) {
+        error("Snapshot: The image is corrupt. An offset lies outside of the arena.");
+    }
+}
+
+/** Fails unless @c count pointers starting at @c offset lie within the arena. */
+static void checkArenaTable(uint64_t offset, uint64_t count, uint64_t arenaSize){
+    checkArenaRange(offset, 0, arenaSize);
+    if (count > (arenaSize - offset) / sizeof(uint64_t)) {
+        error("Snapshot: The image is corrupt. A table lies outside of the arena.");
+    }
+}
+
+/** Fails unless @c package is the built-in package or one of the @c packageCount packages in the image. */
+static void checkPackage(uint8_t package, uint8_t packageCount){
+    if (package != SNAPSHOT_BUILT_IN_PACKAGE && package >= packageCount) {
+        error("Snapshot: The image is corrupt. It refers to package %d but only contains %d.", package, packageCount);
+    }
+}
+
+Program* readSnapshot(FILE *in){
+    SnapshotHeader header;
+    readOrFail(&header, sizeof(header), 1, in);
+
+    uint32_t structSizes[] = {sizeof(Class), sizeof(Function), sizeof(InitializerFunction), sizeof(Object),
+        sizeof(String)};
+    if (header.byteOrder != 0x01020304 || header.pointerSize != sizeof(void *) ||
+        memcmp(header.structSizes, structSizes, sizeof(structSizes)) != 0) {
+        error("Snapshot: The image was created on an incompatible platform.");
+    }
+    if (header.version != ByteCodeSpecificationVersion) {
+        error("The snapshot (bcsv %d) is not compatible with this interpreter (bcsv %d).", header.version,
+              ByteCodeSpecificationVersion);
+    }
+    // The last provider slot is reserved for the built-in package
+    if (header.packageCount >= SNAPSHOT_BUILT_IN_PACKAGE) {
+        error("Snapshot: The image is corrupt. It lists %d packages.", header.packageCount);
+    }
+    checkArenaTable(header.classTableOffset, header.classCount, header.arenaSize);
+    checkArenaTable(header.functionTableOffset, header.functionCount, header.arenaSize);
+    checkArenaTable(header.stringPoolOffset, header.stringPoolCount, header.arenaSize);
+    if (header.relocationCount > SIZE_MAX / sizeof(uint64_t)) {
+        error("Snapshot: The image is corrupt. It lists too many relocations.");
+    }
+
+    SnapshotProviders providers[SNAPSHOT_BUILT_IN_PACKAGE + 1];
+    providers[SNAPSHOT_BUILT_IN_PACKAGE] = (SnapshotProviders){handlerPointerForMethod, handlerPointerForInitializer,
+        markerPointerForClass, deinitializerPointerForClass};
+    for (uint8_t i = 0; i < header.packageCount; i++) {
+        char name[UINT8_MAX + 1];
+        int length = fgetc(in);
+        uint16_t major, minor;
+        if (length == EOF) {
+            error("Snapshot: The image is truncated.");
+        }
+        readOrFail(name, 1, length, in);
+        name[length] = 0;
+        readOrFail(&major, sizeof(uint16_t), 1, in);
+        readOrFail(&minor, sizeof(uint16_t), 1, in);
+
+        SizeForClassFunction sfch;
+        PackageLoadingState s = packageLoad(name, major, minor, &providers[i].methods, &providers[i].initializers,
+                                            &providers[i].markers, &providers[i].deinitializers, &sfch);
+        if (s != PACKAGE_LOADED) {
+            error("Snapshot: Could not load package \"%s\" %d.%d. %s", name, major, minor,
+                  s == PACKAGE_LOADING_FAILED ? packageError() : "");
+        }
+    }
+
+    Byte *arena = immortalAllocate(header.arenaSize);
+    readOrFail(arena, 1, header.arenaSize, in);
+
+    uint64_t *relocations = malloc(sizeof(uint64_t) * header.relocationCount);
+    if (!relocations && header.relocationCount) {
+        error("Snapshot: Cannot allocate the relocation table.");
+    }
+    readOrFail(relocations, sizeof(uint64_t), header.relocationCount, in);
+    for (uint64_t i = 0; i < header.relocationCount; i++) {
+        uint64_t slot = relocations[i];
+        uint64_t target;
+        checkArenaRange(slot, sizeof(uint64_t), header.arenaSize);
+        memcpy(&target, arena + slot, sizeof(uint64_t));
+        if (target != SNAPSHOT_ARRAY_CLASS) {
+            checkArenaRange(target, 0, header.arenaSize);
+        }
+        void *pointer = target == SNAPSHOT_ARRAY_CLASS ? (void *)CL_ARRAY : arena + target;
+        memcpy(arena + slot, &pointer, sizeof(void *));
+    }
+    free(relocations);
+
+    for (uint64_t i = 0; i < header.nativeCount; i++) {
+        SnapshotNative native;
+        readOrFail(&native, sizeof(native), 1, in);
+        checkPackage(native.package, header.packageCount);
+        checkArenaRange(native.offset, native.kind ? sizeof(Function) : sizeof(InitializerFunction), header.arenaSize);
+        SnapshotProviders *p = &providers[native.package];
+        if (native.kind) {
+            ((Function *)(arena + native.offset))->handler = p->methods(native.className, native.name, native.kind);
+        }
+        else {
+            ((InitializerFunction *)(arena + native.offset))->handler = p->initializers(native.className, native.name);
+        }
+    }
+
+    for (uint32_t i = 0; i < header.classRecordCount; i++) {
+        SnapshotClass record;
+        readOrFail(&record, sizeof(record), 1, in);
+        checkPackage(record.package, header.packageCount);
+        checkArenaRange(record.offset, sizeof(Class), header.arenaSize);
+        Class *class = (Class *)(arena + record.offset);
+        class->mark = providers[record.package].markers(record.name);
+        class->deconstruct = providers[record.package].deinitializers(record.name);
+        if (!class->deconstruct && class->superclass) {
+            class->deconstruct = class->superclass->deconstruct;
+        }
+    }
+
+    classTable = (Class **)(arena + header.classTableOffset);
+    classTableCount = header.classCount;
+    functionTable = (Function **)(arena + header.functionTableOffset);
+    functionTableCount = header.functionCount;
+    stringPool = (Object **)(arena + header.stringPoolOffset);
+    stringPoolCount = header.stringPoolCount;
+
+    stringHashSeedInit();
+    for (uint_fast16_t i = 0; i < stringPoolCount; i++) {
+        stringHash(stringPool[i]->value);
+    }
+
+    sealImmortalRegion();
+
+    Program *program = newProgram();
+    programSetTables(program, functionTable[0]);
+    return program;
+}
@@ -35,7 +35,7 @@ void stackPush(Something this, uint8_t variableCount, uint8_t argCount, Thread *
     Something *t = stackReserveFrame(this, variableCount, thread);
     
     for (uint8_t i = 0; i < argCount; i++) {
-        t[i] = parse(consumeCoin(thread), thread);
+        t[i] = parse(consumeInstruction(thread), thread);
     }
     
     stackPushReservedFrame(thread);
@@ -9,10 +9,6 @@
 #include "Emojicode.h"
 #include <pthread.h>
 
-Thread *lastThread = NULL;
-int threads = 0;
-pthread_mutex_t threadListMutex = PTHREAD_MUTEX_INITIALIZER;
-
 Thread* allocateThread() {
 #define stackSize (sizeof(StackFrame) + 4 * sizeof(Something)) * 10000 //ca. 400 KB
     Thread *thread = malloc(sizeof(Thread));
@@ -23,29 +19,34 @@ Thread* allocateThread() {
     }
     thread->futureStack = thread->stack = thread->stackBottom = thread->stackLimit + stackSize - 1;
     
-    pthread_mutex_lock(&threadListMutex);
-    thread->threadBefore = lastThread;
+    Instance *instance = currentInstance;
+    thread->instance = instance;
+    
+    pthread_mutex_lock(&instance->threadListMutex);
+    thread->threadBefore = instance->lastThread;
     thread->threadAfter = NULL;
-    if (lastThread) {
-        lastThread->threadAfter = thread;
+    if (instance->lastThread) {
+        instance->lastThread->threadAfter = thread;
     }
-    lastThread = thread;
-    threads++;
-    pthread_mutex_unlock(&threadListMutex);
+    instance->lastThread = thread;
+    instance->threads++;
+    pthread_mutex_unlock(&instance->threadListMutex);
     
     return thread;
 }
 
 void removeThread(Thread *thread) {
-    pthread_mutex_lock(&threadListMutex);
+    Instance *instance = thread->instance;
+    pthread_mutex_lock(&instance->threadListMutex);
     Thread *before = thread->threadBefore;
     Thread *after = thread->threadAfter;
     
     if (before) before->threadAfter = after;
     if (after) after->threadBefore = before;
+    if (instance->lastThread == thread) instance->lastThread = before;
     
-    threads--;
-    pthread_mutex_unlock(&threadListMutex);
+    instance->threads--;
+    pthread_mutex_unlock(&instance->threadListMutex);
     
     free(thread->stackLimit);
     free(thread);
@@ -0,0 +1,80 @@
+//
+//  main.c
+//  Emojicode
+//
+
+#include <locale.h>
+#include <string.h>
+#include "Emojicode.h"
+
+int main(int argc, char *argv[]) {
+    const char *ppath;
+    if ((ppath = getenv("EMOJICODE_PACKAGES_PATH"))) {
+        packageDirectory = ppath;
+    }
+
+    setlocale(LC_CTYPE, "de_DE.UTF-8");
+
+    const char *snapshotPath = NULL;
+    EmojicodeInteger workers = 0;
+    int argumentsStart = 1;
+    while (argc > argumentsStart + 1 && argv[argumentsStart][0] == '-') {
+        if (strcmp(argv[argumentsStart], "-s") == 0) {
+            snapshotPath = argv[argumentsStart + 1];
+        }
+        else if (strcmp(argv[argumentsStart], "-p") == 0) {
+            workers = strtoll(argv[argumentsStart + 1], NULL, 10);
+            if (workers <= 0) {
+                error("-p requires a positive number of workers.");
+            }
+        }
+        else {
+            error("Unknown option %s.", argv[argumentsStart]);
+        }
+        argumentsStart += 2;
+    }
+
+    if (argc <= argumentsStart){
+       error("No file provided.");
+    }
+
+    FILE *f = fopen(argv[argumentsStart], "rb");
+    if (!f || ferror(f)){
+       error("File couldn't be opened.");
+    }
+
+    Program *program;
+    if (isSnapshot(f)) {
+        program = readSnapshot(f);
+    }
+    else {
+        if (snapshotPath) {
+            snapshotBeginRecording();
+        }
+        program = readBytecode(f);
+    }
+    fclose(f);
+
+    if (snapshotPath) {
+        FILE *out = fopen(snapshotPath, "wb");
+        if (!out) {
+            error("Snapshot file couldn't be opened for writing.");
+        }
+        writeSnapshot(out);
+        fclose(out);
+        return 0;
+    }
+
+    // The program sees the engine followed by the file and its arguments, regardless of the options.
+    argv[argumentsStart - 1] = argv[0];
+    Instance *instance = newInstance(program, argv + argumentsStart - 1, argc - argumentsStart + 1);
+    enterInstance(instance);
+
+    Thread *mainThread = allocateThread();
+
+    if (workers) {
+        preforkWorkers(workers);
+    }
+
+    return (int)performFunction(program->main, NOTHINGNESS, mainThread).raw;
+}
@@ -15,6 +15,13 @@
 #include "Emojicode.h"
 #include "EmojicodeString.h"
 #include "EmojicodeList.h"
+#include "EmojicodePrimitiveArray.h"
+#include "EmojicodePriorityQueue.h"
+#include "EmojicodeDeque.h"
+#include "EmojicodeBTree.h"
+#include "EmojicodeBitset.h"
+#include "EmojicodeLRUCache.h"
+#include "EmojicodeByteBuffer.h"
 #include "EmojicodeString.h"
 #include "EmojicodeDictionary.h"
 #include "utf8.h"
@@ -73,22 +80,31 @@ static Something systemArgs(Thread *thread) {
     Object *listObject = newObject(CL_LIST);
     stackSetVariable(0, somethingObject(listObject), thread);
     
+    Instance *instance = currentInstance;
     List *newList = listObject->value;
-    newList->capacity = cliArgumentCount;
-    Object *items = newArray(sizeof(Something) * cliArgumentCount);
+    newList->capacity = instance->cliArgumentCount;
+    Object *items = newArray(sizeof(Something) * instance->cliArgumentCount);
     
     listObject = stackGetVariable(0, thread).object;
     
     ((List *)listObject->value)->items = items;
     
-    for (int i = 0; i < cliArgumentCount; i++) {
-        listAppend(listObject, somethingObject(stringFromChar(cliArguments[i])), thread);
+    for (int i = 0; i < instance->cliArgumentCount; i++) {
+        listAppend(listObject, somethingObject(stringFromChar(instance->cliArguments[i])), thread);
     }
     
     stackPop(thread);
     return somethingObject(listObject);
 }
 
+static Something systemPrefork(Thread *thread) {
+    return somethingInteger(preforkWorkers(unwrapInteger(stackGetVariable(0, thread))));
+}
+
+static Something systemWorkerIndex(Thread *thread) {
+    return workerIndex >= 0 ? somethingInteger(workerIndex) : NOTHINGNESS;
+}
+
 static Something systemSystem(Thread *thread) {
     char *command = stringToChar(stackGetVariable(0, thread).object->value);
     FILE *f = popen(command, "r");
@@ -113,26 +129,33 @@ static Something systemSystem(Thread *thread) {
     
     bufferUsedSize = strlen(buffer->value);
     
-    EmojicodeInteger len = u8_strlen_l(buffer->value, bufferUsedSize);
+    EmojicodeChar max;
+    EmojicodeInteger len = u8_toucs_measure(buffer->value, bufferUsedSize, &max);
     
+    stackPush(somethingObject(buffer), 1, 0, thread);
     Object *so = newObject(CL_STRING);
     stackSetVariable(0, somethingObject(so), thread);
     String *string = so->value;
     string->length = len;
+    string->width = stringWidthForCharacter(max);
     
-    Object *chars = newArray(len * sizeof(EmojicodeChar));
-    string = stackGetVariable(0, thread).object->value;
+    Object *chars = newArray(len * string->width);
+    so = stackGetVariable(0, thread).object;
+    string = so->value;
     string->characters = chars;
+    buffer = stackGetThisObject(thread);
+    stackPop(thread);
     
-    u8_toucs(characters(string), len, buffer->value, bufferUsedSize);
+    u8_toucs_width(chars->value, string->width, len, buffer->value, bufferUsedSize);
     
-    return stackGetVariable(0, thread);
+    return somethingObject(so);
 }
 
 //MARK: Threads
 
 void* threadStarter(void *threadv) {
     Thread *thread = threadv;
+    enterInstance(thread->instance);
     Object *callable = stackGetThisObject(thread);
     stackPop(thread);
     executeCallableExtern(callable, NULL, thread);
@@ -182,6 +205,27 @@ static Something mutexTryLock(Thread *thread) {
     return pthread_mutex_trylock(((Object *)stackGetThisObject(thread))->value) == 0 ? EMOJICODE_TRUE : EMOJICODE_FALSE;
 }
 
+//MARK: Weak Reference
+
+static void weakReferenceMark(Object *o) {
+    if (*(Object **)o->value) {
+        markWeakReference(o->value);
+    }
+}
+
+static void initWeakReference(Thread *thread) {
+    *(Object **)stackGetThisObject(thread)->value = stackGetVariable(0, thread).object;
+}
+
+static Something weakReferenceGet(Thread *thread) {
+    Object *object = *(Object **)stackGetThisObject(thread)->value;
+    return object ? somethingObject(object) : NOTHINGNESS;
+}
+
+static Something weakReferenceIsAlive(Thread *thread) {
+    return *(Object **)stackGetThisObject(thread)->value ? EMOJICODE_TRUE : EMOJICODE_FALSE;
+}
+
 //MARK: Error
 
 Object* newError(const char *message, int code){
@@ -258,8 +302,10 @@ static Something dataSize(Thread *thread) {
 static void dataMark(Object *o) {
     Data *d = o->value;
     if (d->bytesObject) {
+        // Slices and data read from a 📼 start within the bytes object
+        ptrdiff_t offset = d->bytes - (char *)d->bytesObject->value;
         mark(&d->bytesObject);
-        d->bytes = d->bytesObject->value;
+        d->bytes = (char *)d->bytesObject->value + offset;
     }
 }
 
@@ -283,16 +329,22 @@ static Something dataToString(Thread *thread) {
         return NOTHINGNESS;
     }
     
-    EmojicodeInteger len = u8_strlen_l(data->bytes, data->length);
-    Object *characters = newArray(len * sizeof(EmojicodeChar));
+    EmojicodeChar max;
+    EmojicodeInteger len = u8_toucs_measure(data->bytes, data->length, &max);
+    uint8_t width = stringWidthForCharacter(max);
+    Object *characters = newArray(len * width);
     
     stackPush(somethingObject(characters), 0, 0, thread);
     Object *sto = newObject(CL_STRING);
     String *string = sto->value;
     string->length = len;
+    string->width = width;
     string->characters = stackGetThisObject(thread);
     stackPop(thread);
-    u8_toucs(characters(string), len, data->bytes, data->length);
+    
+    // The bytes might have been moved by the garbage collector
+    data = stackGetThisObject(thread)->value;
+    u8_toucs_width(string->characters->value, width, len, data->bytes, data->length);
     return somethingObject(sto);
 }
 
@@ -321,26 +373,18 @@ static Something dataSlice(Thread *thread) {
 
 Something integerToString(Thread *thread) {
     EmojicodeInteger base = stackGetVariable(0, thread).raw;
-    EmojicodeInteger n = stackGetThisContext(thread).raw, a = llabs(n);
-    bool negative = n < 0;
+    EmojicodeInteger n = stackGetThisContext(thread).raw;
+    EmojicodeInteger length = integerStringLength(n, base);
     
-    EmojicodeInteger d = negative ? 2 : 1;
-    while (n /= base) d++;
-    
-    Object *co = newArray(d * sizeof(EmojicodeChar));
+    Object *co = newArray(length);
     stackSetVariable(0, somethingObject(co), thread);
     
     Object *stringObject = newObject(CL_STRING);
     String *string = stringObject->value;
-    string->length = d;
+    string->length = length;
+    string->width = 1;
     string->characters = stackGetVariable(0, thread).object;
-    
-    EmojicodeChar *characters = characters(string) + d;
-    do
-        *--characters =  "0123456789abcdefghijklmnopqrstuvxyz"[a % base % 35];
-    while (a /= base);
-    
-    if (negative) characters[-1] = '-';
+    integerWriteToString(string, 0, n, base);
     
     return somethingObject(stringObject);
 }
@@ -350,57 +394,33 @@ static Something integerRandom(Thread *thread) {
 }
 
 static Something stringFromSymbol(Thread *thread){
-    Object *co = newArray(sizeof(EmojicodeChar));
+    EmojicodeChar symbol = (EmojicodeChar)stackGetThisContext(thread).raw;
+    Object *co = newArray(stringWidthForCharacter(symbol));
     stackPush(somethingObject(co), 0, 0, thread);
     Object *stringObject = newObject(CL_STRING);
     String *string = stringObject->value;
     string->length = 1;
+    string->width = stringWidthForCharacter(symbol);
     string->characters = stackGetThisObject(thread);
     stackPop(thread);
-    ((EmojicodeChar *)string->characters->value)[0] = (EmojicodeChar)stackGetThisContext(thread).raw;
+    stringSetCharacter(string, 0, symbol);
     return somethingObject(stringObject);
 }
 
 static Something doubleToString(Thread *thread) {
     EmojicodeInteger precision = stackGetVariable(0, thread).raw;
     double d = stackGetThisContext(thread).doubl;
-    double absD = fabs(d);
-    
-    bool negative = d < 0;
+    EmojicodeInteger length = doubleStringLength(d, precision);
     
-    EmojicodeInteger length = negative ? 1 : 0;
-    if (precision != 0) {
-        length++;
-    }
-    length += precision;
-    EmojicodeInteger iLength = 1;
-    for (size_t i = 1; pow(10, i) < absD; i++) {
-        iLength++;
-    }
-    length += iLength;
-    
-    Object *co = newArray(length * sizeof(EmojicodeChar));
+    Object *co = newArray(length);
     stackSetVariable(0, somethingObject(co), thread);
     Object *stringObject = newObject(CL_STRING);
     String *string = stringObject->value;
     string->length = length;
+    string->width = 1;
     string->characters = stackGetVariable(0, thread).object;
+    doubleWriteToString(string, 0, d, precision);
     
-    EmojicodeChar *characters = characters(string) + length;
-    
-    for (size_t i = precision; i > 0; i--) {
-        *--characters =  (unsigned char) (fmod(absD * pow(10, i), 10.0)) % 10 + '0';
-    }
-    
-    if (precision != 0) {
-        *--characters = '.';
-    }
-    
-    for (size_t i = 0; i < iLength; i++) {
-        *--characters =  (unsigned char) (fmod(absD / pow(10, i), 10.0)) % 10 + '0';
-    }
-    
-    if (negative) characters[-1] = '-';
     return somethingObject(stringObject);
 }
 
@@ -467,7 +487,7 @@ static void closureMark(Object *o){
     
     Something *t = c->capturedVariables->value;
     for (uint8_t i = 0; i < c->capturedVariablesCount; i++) {
-        Something *s = t + c->argumentCount + i;
+        Something *s = t + i;
         if (isRealObject(*s)) {
             mark(&s->object);
         }
@@ -487,9 +507,32 @@ FunctionFunctionPointer numberMethodForName(EmojicodeChar name);
 FunctionFunctionPointer handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar symbol, MethodType type) {
     switch (cl) {
         case 0x1F521: //String
+            if (symbol == 0x1F981) { //🦁
+                return listSortMethodForType(cl);
+            }
             return stringMethodForName(symbol);
         case 0x1F368: //List
             return listMethodForName(symbol);
+        case 0x1f3d7: //🏗
+            return stringBuilderMethodForName(symbol);
+        case 0x1f683: //🚃
+        case 0x1f6f0: //🛰
+        case 0x1f64c: //🙌
+        case 0x1f4be: //💾
+            return primitiveArrayMethodForName(symbol);
+        case 0x1f5fb: //🗻
+            return priorityQueueMethodForName(symbol);
+        case 0x1f3a0: //🎠
+            return dequeMethodForName(symbol);
+        case 0x1f332: //🌲
+        case 0x1f334: //🌴
+            return btreeMethodForName(symbol);
+        case 0x1f6a6: //🚦
+            return bitsetMethodForName(symbol);
+        case 0x1f392: //🎒
+            return lruCacheMethodForName(symbol);
+        case 0x1f4fc: //📼
+            return byteBufferMethodForName(symbol);
         case 0x1F6A8: //Error
             switch (symbol) {
                 case 0x1F624:
@@ -511,7 +554,13 @@ FunctionFunctionPointer handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar
                     return dataSlice;
             }
         case 0x1F36F:
+        case 0x1f5c3: //🗃
+        case 0x1f5c2: //🗂
             return dictionaryMethodForName(symbol);
+        case 0x1f371: //🍱
+        case 0x1f5c4: //🗄
+        case 0x1f5f3: //🗳
+            return setMethodForName(symbol);
         case 0x23E9:
             // case 0x1F43D: //pig nose
             return rangeGet;
@@ -531,12 +580,21 @@ FunctionFunctionPointer handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar
                 case 0x1f510: //🔐
                     return mutexTryLock;
             }
+        case 0x1f578: //🕸
+            switch (symbol) {
+                case 0x1f43d: //🐽
+                    return weakReferenceGet;
+                case 0x1f423: //🐣
+                    return weakReferenceIsAlive;
+            }
         case 0x1F682: //🚂
             switch (symbol) {
                 case 0x1f521: //🔡
                     return integerToString;
                 case 0x1f3b0: //🎰
                     return integerRandom;
+                case 0x1F981: //🦁
+                    return listSortMethodForType(cl);
             }
         case 0x1F680:
             switch (symbol) {
@@ -568,8 +626,13 @@ FunctionFunctionPointer handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar
                     return doubleLn;
                 case 0x1f521: //🔡
                     return doubleToString;
+                case 0x1F981: //🦁
+                    return listSortMethodForType(cl);
             }
         case 0x1f523: //🔣
+            if (symbol == 0x1F981) { //🦁
+                return listSortMethodForType(cl);
+            }
             return stringFromSymbol;
         case 0x1F4BB: //💻
             switch (symbol) {
@@ -585,6 +648,10 @@ FunctionFunctionPointer handlerPointerForMethod(EmojicodeChar cl, EmojicodeChar
                     return systemArgs;
                 case 0x1f574: //🕴
                     return systemSystem;
+                case 0x1f3ed: //🏭
+                    return systemPrefork;
+                case 0x1f477: //👷
+                    return systemWorkerIndex;
             }
     }
     return NULL;
@@ -598,14 +665,44 @@ InitializerFunctionFunctionPointer handlerPointerForInitializer(EmojicodeChar cl
             return listInitializerForName(symbol);
         case 0x1F521: //String
             return stringInitializerForName(symbol);
+        case 0x1f3d7: //🏗
+            return stringBuilderInit;
+        case 0x1f683: //🚃
+        case 0x1f6f0: //🛰
+        case 0x1f64c: //🙌
+        case 0x1f4be: //💾
+            return primitiveArrayInitializerForName(cl, symbol);
+        case 0x1f5fb: //🗻
+            return priorityQueueInitializerForName(symbol);
+        case 0x1f3a0: //🎠
+            return dequeInitializerForName(symbol);
+        case 0x1f332: //🌲
+        case 0x1f334: //🌴
+            return btreeInitializerForName(cl);
+        case 0x1f6a6: //🚦
+            return bitsetInitializerForName(symbol);
+        case 0x1f392: //🎒
+            return lruCacheInitializerForName(symbol);
+        case 0x1f4fc: //📼
+            return byteBufferInitializerForName(symbol);
         case 0x1F6A8: //Error’s only initializer 0x1F62E
             return newErrorBridge;
         case 0x1F36F: //Only dictionary contstructor 0x1F438
             return bridgeDictionaryInit;
+        case 0x1f5c3: //🗃
+            return bridgeIntegerDictionaryInit;
+        case 0x1f5c2: //🗂
+            return bridgeSymbolDictionaryInit;
+        case 0x1f371: //🍱
+        case 0x1f5c4: //🗄
+        case 0x1f5f3: //🗳
+            return setInitializerForName(cl, symbol);
         case 0x1f488: //💈
             return initThread;
         case 0x1f510: //🔐
             return initMutex;
+        case 0x1f578: //🕸
+            return initWeakReference;
         case 0x23E9:
             switch (symbol) {
                 case 0x23E9:
@@ -623,7 +720,32 @@ uint_fast32_t sizeForClass(Class *cl, EmojicodeChar name) {
             return sizeof(String);
         case 0x1F368:
             return sizeof(List);
+        case 0x1f3d7: //🏗
+            return sizeof(StringBuilder);
+        case 0x1f683: //🚃
+        case 0x1f6f0: //🛰
+        case 0x1f64c: //🙌
+        case 0x1f4be: //💾
+            return sizeof(PrimitiveArray);
+        case 0x1f5fb: //🗻
+            return sizeof(PriorityQueue);
+        case 0x1f3a0: //🎠
+            return sizeof(Deque);
+        case 0x1f332: //🌲
+        case 0x1f334: //🌴
+            return sizeof(BTree);
+        case 0x1f6a6: //🚦
+            return sizeof(Bitset);
+        case 0x1f392: //🎒
+            return sizeof(LRUCache);
+        case 0x1f4fc: //📼
+            return sizeof(ByteBuffer);
         case 0x1F36F:
+        case 0x1f5c3: //🗃
+        case 0x1f5c2: //🗂
+        case 0x1f371: //🍱
+        case 0x1f5c4: //🗄
+        case 0x1f5f3: //🗳
             return sizeof(EmojicodeDictionary);
         case 0x1F4C7:
             return sizeof(Data);
@@ -637,6 +759,8 @@ uint_fast32_t sizeForClass(Class *cl, EmojicodeChar name) {
             return sizeof(pthread_t);
         case 0x1f510: //🔐
             return sizeof(pthread_mutex_t);
+        case 0x1f578: //🕸
+            return sizeof(Object *);
     }
     return 0;
 }
@@ -646,9 +770,36 @@ Marker markerPointerForClass(EmojicodeChar cl){
         case 0x1F368: //List
             return listMark;
         case 0x1F36F: //Dictionary
+        case 0x1f5c3: //🗃
+        case 0x1f5c2: //🗂
+        case 0x1f371: //🍱
+        case 0x1f5c4: //🗄
+        case 0x1f5f3: //🗳
             return dictionaryMark;
         case 0x1F521:
             return stringMark;
+        case 0x1f3d7: //🏗
+            return stringBuilderMark;
+        case 0x1f683: //🚃
+        case 0x1f6f0: //🛰
+        case 0x1f64c: //🙌
+        case 0x1f4be: //💾
+            return primitiveArrayMark;
+        case 0x1f5fb: //🗻
+            return priorityQueueMark;
+        case 0x1f3a0: //🎠
+            return dequeMark;
+        case 0x1f332: //🌲
+        case 0x1f334: //🌴
+            return btreeMark;
+        case 0x1f6a6: //🚦
+            return bitsetMark;
+        case 0x1f392: //🎒
+            return lruCacheMark;
+        case 0x1f4fc: //📼
+            return byteBufferMark;
+        case 0x1f578: //🕸
+            return weakReferenceMark;
         case 0x1F347:
             return closureMark;
         case 0x1F336:
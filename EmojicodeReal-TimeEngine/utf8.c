@@ -121,6 +121,118 @@ size_t u8_toucs(uint32_t *dest, size_t sz, const char *src, size_t srcsz)
     return i;
 }
 
+/* decodes the character at *src like u8_toucs, returns UEOF if the input ends
+   within the character */
+static inline uint32_t u8_decode(const char **src, const char *src_end)
+{
+    uint32_t ch = 0;
+    size_t nb;
+
+    if (!isutf(**src)) {     // invalid sequence
+        (*src)++;
+        return 0xFFFD;
+    }
+    nb = trailingBytesForUTF8[(unsigned char)**src];
+    if (*src + nb >= src_end)
+        return UEOF;
+    switch (nb) {
+        /* these fall through deliberately */
+    case 5: ch += (unsigned char)*(*src)++; ch <<= 6;
+    case 4: ch += (unsigned char)*(*src)++; ch <<= 6;
+    case 3: ch += (unsigned char)*(*src)++; ch <<= 6;
+    case 2: ch += (unsigned char)*(*src)++; ch <<= 6;
+    case 1: ch += (unsigned char)*(*src)++; ch <<= 6;
+    case 0: ch += (unsigned char)*(*src)++;
+    }
+    return ch - offsetsFromUTF8[nb];
+}
+
+size_t u8_toucs_measure(const char *src, size_t srcsz, uint32_t *max)
+{
+    const char *src_end = src + srcsz;
+    uint32_t ch, m = 0;
+    size_t i = 0;
+
+    while (src < src_end) {
+        if ((unsigned char)*src < 0x80) {
+            if (m < (unsigned char)*src) m = (unsigned char)*src;
+            src++;
+            i++;
+            continue;
+        }
+        if ((ch = u8_decode(&src, src_end)) == UEOF)
+            break;
+        if (m < ch) m = ch;
+        i++;
+    }
+    *max = m;
+    return i;
+}
+
+size_t u8_toucs_width(void *dest, int width, size_t sz, const char *src, size_t srcsz)
+{
+    const char *src_end = src + srcsz;
+    uint32_t ch;
+    size_t i = 0;
+
+    while (i < sz && src < src_end) {
+        if ((ch = u8_decode(&src, src_end)) == UEOF)
+            break;
+        switch (width) {
+        case 1: ((uint8_t *)dest)[i++] = (uint8_t)ch; break;
+        case 2: ((uint16_t *)dest)[i++] = (uint16_t)ch; break;
+        default: ((uint32_t *)dest)[i++] = ch; break;
+        }
+    }
+    return i;
+}
+
+static inline uint32_t u8_load(const void *src, int width, size_t i)
+{
+    switch (width) {
+    case 1: return ((const uint8_t *)src)[i];
+    case 2: return ((const uint16_t *)src)[i];
+    default: return ((const uint32_t *)src)[i];
+    }
+}
+
+size_t u8_codingsize_width(const void *src, int width, size_t n)
+{
+    size_t i, c=0;
+
+    if (width == 1) {
+        for (i=0; i < n; i++)
+            c += ((const uint8_t *)src)[i] < 0x80 ? 1 : 2;
+        return c;
+    }
+    for (i=0; i < n; i++)
+        c += u8_charlen(u8_load(src, width, i));
+    return c;
+}
+
+size_t u8_toutf8_width(char *dest, size_t sz, const void *src, int width, size_t srcsz)
+{
+    size_t i = 0;
+    char *dest0 = dest;
+    char *dest_end = dest + sz;
+
+    while (i < srcsz) {
+        uint32_t ch = u8_load(src, width, i);
+        if (ch < 0x80) {
+            if (dest >= dest_end)
+                break;
+            *dest++ = (char)ch;
+        }
+        else {
+            if (dest + u8_charlen(ch) > dest_end)
+                break;
+            dest += u8_wc_toutf8(dest, ch);
+        }
+        i++;
+    }
+    return (dest-dest0);
+}
+
 /* srcsz = number of source characters
    sz = size of dest buffer in bytes
 
@@ -657,9 +769,8 @@ int u8_isvalid(const char *str, size_t length)
         if ((c & 0xc0) != 0xc0)
             return 0;
         ab = trailingBytesForUTF8[c];
-        if (length < ab)
+        if ((size_t)(pend - p) <= ab)
             return 0;
-        length -= ab;
 
         p++;
         /* Check top bits in the second byte */
@@ -22,6 +22,16 @@ size_t u8_toucs(uint32_t *dest, size_t sz, const char *src, size_t srcsz);
 /* the opposite conversion */
 size_t u8_toutf8(char *dest, size_t sz, const uint32_t *src, size_t srcsz);
 
+/* the number of characters u8_toucs produces, the largest one is stored in max */
+size_t u8_toucs_measure(const char *src, size_t srcsz, uint32_t *max);
+
+/* like u8_toucs, but stores every character in width (1, 2 or 4) bytes */
+size_t u8_toucs_width(void *dest, int width, size_t sz, const char *src, size_t srcsz);
+
+/* like u8_toutf8 and u8_codingsize for characters stored in width bytes */
+size_t u8_toutf8_width(char *dest, size_t sz, const void *src, int width, size_t srcsz);
+size_t u8_codingsize_width(const void *src, int width, size_t n);
+
 /* single character to UTF-8, returns # bytes written */
 size_t u8_wc_toutf8(char *dest, uint32_t ch);
 
@@ -20,15 +20,22 @@
 typedef uint32_t EmojicodeChar;
 
 typedef int_fast64_t EmojicodeInteger;
-/** The bytecode file is structured into Coins. Each Coin represents a single instruction or value. */
+/**
+ * The bytecode is a stream of bytes. An instruction is always encoded in a single byte. Its operands, called Coins,
+ * are encoded as unsigned LEB128 unless the instruction specifies a fixed width. Fixed-width coins, which are used
+ * for all lengths and counts the compiler can only determine after writing a block, occupy four bytes in little
+ * endian order. Lengths of blocks are always given in bytes.
+ */
 typedef uint32_t EmojicodeCoin;
+/** A single bytecode instruction. */
+typedef uint8_t EmojicodeInstruction;
 
 /* Using either of them in a package makes absolutely no sense */
 #ifndef defaultPackagesDirectory
 #define defaultPackagesDirectory "/usr/local/EmojicodePackages"
 #endif
 extern const char *packageDirectory;
-#define ByteCodeSpecificationVersion 5
+#define ByteCodeSpecificationVersion 6
 
 /**
  * @defined(isWhitespace)
@@ -42,6 +49,4 @@ extern const char *packageDirectory;
 char outVariable[5] = {0, 0, 0, 0, 0};\
 u8_wc_toutf8(outVariable, (ec));
 
-#define PORTABLE_INTLEAST64_MAX ((int_least64_t)9223372036854775807)
-
 #endif /* EmojicodeShared_h */
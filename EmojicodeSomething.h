@@ -0,0 +1,60 @@
+//
+//  EmojicodeSomething.h
+//  Emojicode
+//
+
+/*
+ * Declares Something, the representation of values, which is also needed by applications embedding Emojicode. This
+ * file can be included from C++.
+ */
+
+#ifndef EmojicodeSomething_h
+#define EmojicodeSomething_h
+
+#include "EmojicodeShared.h"
+
+typedef struct Class Class;
+typedef struct Object Object;
+
+#define T_OBJECT 0
+#define T_INTEGER 1
+#define T_BOOLEAN 2
+#define T_SYMBOL 3
+#define T_DOUBLE 4
+#define T_CLASS 5
+
+typedef uint_fast8_t Type;
+typedef unsigned char Byte;
+
+/** Either an object reference or a primitive value. */
+typedef struct {
+    /** The type of the primitive or whether it contains an object reference. */
+    Type type;
+    union {
+        EmojicodeInteger raw;
+        double doubl;
+        Object *object;
+        Class *eclass;
+    };
+} Something;
+
+#if __SIZEOF_DOUBLE__ != 8
+#warning Double does not match the size of an 64-bit integer
+#endif
+
+#define somethingObject(o) ((Something){T_OBJECT, .object = (o)})
+#define somethingInteger(o) ((Something){T_INTEGER, (o)})
+#define somethingSymbol(o) ((Something){T_SYMBOL, (o)})
+#define somethingBoolean(o) ((Something){T_BOOLEAN, (o)})
+#define somethingDouble(o) ((Something){T_DOUBLE, .doubl = (o)})
+#define somethingClass(o) ((Something){T_CLASS, .eclass = (o)})
+#define EMOJICODE_TRUE ((Something){T_BOOLEAN, 1})
+#define EMOJICODE_FALSE ((Something){T_BOOLEAN, 0})
+#define NOTHINGNESS ((Something){T_OBJECT, .object = NULL})
+
+#define unwrapInteger(o) ((o).raw)
+#define unwrapBool(o) ((o).raw > 0)
+#define unwrapSymbol(o) ((EmojicodeChar)(o).raw)
+#define unwrapDouble(o) ((o).doubl)
+
+#endif /* EmojicodeSomething_h */
@@ -12,13 +12,87 @@
 #include "EmojicodeAPI.h"
 #include "EmojicodeList.h"
 
-extern Object **stringPool;
+extern _Thread_local Object **stringPool;
 #define emptyString (stringPool[0])
-#define characters(string) ((EmojicodeChar*)(string)->characters->value)
+
+/** The smallest width a string containing @c c can have. */
+#define stringWidthForCharacter(c) ((c) <= 0xFF ? 1 : ((c) <= 0xFFFF ? 2 : 4))
+
+/** Returns a pointer to the first character of @c string, which need not be the first byte of @c characters. */
+static inline Byte* stringBytes(String *string) {
+    return (Byte *)string->characters->value + string->offset;
+}
+
+/** Returns the code point at @c index. */
+static inline EmojicodeChar stringCharacter(String *string, EmojicodeInteger index) {
+    switch (string->width) {
+        case 1:
+            return ((uint8_t *)stringBytes(string))[index];
+        case 2:
+            return ((uint16_t *)stringBytes(string))[index];
+        default:
+            return ((EmojicodeChar *)stringBytes(string))[index];
+    }
+}
+
+/** Sets the code point at @c index. @c c must fit into the width of the string. */
+static inline void stringSetCharacter(String *string, EmojicodeInteger index, EmojicodeChar c) {
+    switch (string->width) {
+        case 1:
+            ((uint8_t *)stringBytes(string))[index] = (uint8_t)c;
+            break;
+        case 2:
+            ((uint16_t *)stringBytes(string))[index] = (uint16_t)c;
+            break;
+        default:
+            ((EmojicodeChar *)stringBytes(string))[index] = c;
+            break;
+    }
+}
+
+/** Returns the smallest width that can store the characters in the given range of @c string. */
+uint8_t stringWidthOfRange(String *string, EmojicodeInteger from, EmojicodeInteger length);
+
+/**
+ * Copies @c length characters of @c source, starting at @c from, to @c destination at @c destinationIndex.
+ * The width of @c destination must be large enough for the copied characters.
+ */
+void stringCopyCharacters(String *destination, EmojicodeInteger destinationIndex, String *source,
+                          EmojicodeInteger from, EmojicodeInteger length);
+
+/** Returns the index of the first @c c in @c string at or after @c from or -1 if there is none. */
+EmojicodeInteger stringFindCharacter(String *string, EmojicodeChar c, EmojicodeInteger from);
+
+/** Returns the index of the first occurrence of @c search in @c string at or after @c from or -1 if there is none. */
+EmojicodeInteger stringFind(String *string, String *search, EmojicodeInteger from);
+
+/**
+ * Compares @c a and @c b by their lengths and then symbol by symbol. Returns an integer less than, equal to, or
+ * greater than 0 if @c a is less than, equal to, or greater than @c b.
+ */
+EmojicodeInteger stringCompare(String *a, String *b);
 
 /** Compares if the value of @c a is equal to @c b. */
 bool stringEqual(String *a, String *b);
 
+/**
+ * Returns the interned string equal to @c string, which becomes the interned string if there is none yet. Two
+ * interned strings are only equal if they are the same object. The intern table does not keep strings alive.
+ */
+Object* stringIntern(Object *string);
+
+/**
+ * Returns the hash of the string. The hash is computed on the first call and cached in the string, so the
+ * characters of a string must not be changed once it was hashed.
+ */
+uint64_t stringHash(String *string);
+
+/** Returns the hash of an integer or symbol. Uses the same seed as @c stringHash. */
+uint64_t integerHash(uint64_t value);
+
+/** Chooses the random seed for @c stringHash. Must be called before any string is hashed. */
+void stringHashSeedInit(void);
+
 /**
  * Converts the string to a UTF8 char array and returns it.
  * @warning You must take care of releasing the allocated memory by calling @c free.
@@ -28,17 +102,54 @@ char* stringToChar(String *str);
 /** Creates a string from a UTF8 C string. The string must be null terminated! */
 Object* stringFromChar(const char *cstring);
 
+/** Returns the number of characters needed to write @c n in @c base. */
+EmojicodeInteger integerStringLength(EmojicodeInteger n, EmojicodeInteger base);
+
+/** Writes @c n in @c base to @c string starting at @c index. @c string must have room for the characters. */
+void integerWriteToString(String *string, EmojicodeInteger index, EmojicodeInteger n, EmojicodeInteger base);
+
+/** Returns the number of characters needed to write @c d with @c precision decimal places. */
+EmojicodeInteger doubleStringLength(double d, EmojicodeInteger precision);
+
+/** Writes @c d with @c precision decimal places to @c string starting at @c index. */
+void doubleWriteToString(String *string, EmojicodeInteger index, double d, EmojicodeInteger precision);
+
 /** 
- * Tries to parse the string in the this-slot on the stack as JSON.
+ * Tries to parse the string in the this-slot on the stack as JSON. If @c internKeys is true, the keys of objects
+ * are interned with @c stringIntern.
  * @returns The top-level object or Nothingness if there was an error parsing the string.
  */
-Something parseJSON(Thread *thread);
+Something parseJSON(Thread *thread, bool internKeys);
 
 void stringMark(Object *self);
 
-void initStringFromSymbolList(Object *string, List *list);
+/** Sets the characters of @c string to the symbols in @c list. Both objects are kept alive while allocating. */
+void initStringFromSymbolList(Object *string, Object *list, Thread *thread);
 
 FunctionFunctionPointer stringMethodForName(EmojicodeChar name);
 InitializerFunctionFunctionPointer stringInitializerForName(EmojicodeChar name);
 
+//MARK: String Builder
+
+typedef struct {
+    /** The characters appended so far, each stored in @c width bytes, or @c NULL. */
+    Object *characters;
+    /** The number of characters appended. */
+    EmojicodeInteger length;
+    /** The number of characters @c characters can hold. */
+    EmojicodeInteger capacity;
+    /** The smallest width that can store all appended characters. */
+    uint8_t width;
+    /**
+     * Whether a string was built from @c characters. The builder may still append to them, as strings never look
+     * beyond their length, but must not overwrite the characters the string consists of.
+     */
+    bool shared;
+} StringBuilder;
+
+void stringBuilderMark(Object *self);
+
+FunctionFunctionPointer stringBuilderMethodForName(EmojicodeChar name);
+void stringBuilderInit(Thread *thread);
+
 #endif /* EmojicodeString_h */
@@ -0,0 +1,121 @@
+//
+//  host.c
+//  Emojicode
+//
+
+/*
+ * Embeds tests/embedding/program.emojib, whose path is the first argument, through EmojicodeEmbedding.h.
+ * Exits with 1 if any check failed.
+ */
+
+#include "EmojicodeEmbedding.h"
+#include <pthread.h>
+#include <stdio.h>
+
+#define TIGER 0x1F42F
+#define PLUS 0x2795
+#define NUMBERS 0x1F522
+#define COLLISION 0x1F4A5
+#define FLAG 0x1F3C1
+
+#define THREAD_COUNT 4
+
+static int failed = 0;
+static pthread_mutex_t failedMutex = PTHREAD_MUTEX_INITIALIZER;
+
+static void check(bool condition, const char *description){
+    if (!condition) {
+        fprintf(stderr, "❌ Failed %s\n", description);
+        pthread_mutex_lock(&failedMutex);
+        failed++;
+        pthread_mutex_unlock(&failedMutex);
+    }
+}
+
+static Program *program;
+static Class *tiger;
+
+/** The sum of the lengths of the strings "number 0" to "number 999" 🔢 creates. */
+#define NUMBERS_LENGTH (1000 * 7 + 10 * 1 + 90 * 2 + 900 * 3)
+
+/** Calls 🔢 repeatedly on a new instance so that the instance runs the garbage collector. */
+static void* callNumbers(void *argument){
+    Instance *instance = emojicodeNewInstance(program, NULL, 0);
+    Function *numbers = emojicodeFindFunction(program, TIGER, NUMBERS);
+    // Together the calls allocate more than the heap can hold
+    EmojicodeInteger padding = 4000000 + (intptr_t)argument;
+    for (int i = 0; i < 20; i++) {
+        Something arguments[1], result;
+        arguments[0] = somethingInteger(padding);
+        bool success = emojicodeCall(instance, numbers, somethingClass(tiger), arguments, &result);
+        check(success && result.raw == NUMBERS_LENGTH, "Concurrent Call");
+    }
+    emojicodeDestroyInstance(instance);
+    return NULL;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "No file provided.\n");
+        return 1;
+    }
+
+    check(!emojicodeLoadProgram("/nonexistent.emojib"), "Load Missing File");
+    check(*emojicodeLastError(), "Load Missing File Error");
+
+    program = emojicodeLoadProgram(argv[1]);
+    if (!program) {
+        fprintf(stderr, "🚨 Could not load %s: %s\n", argv[1], emojicodeLastError());
+        return 1;
+    }
+
+    tiger = emojicodeFindClass(program, TIGER);
+    check(tiger, "Find Class");
+    check(!emojicodeFindClass(program, PLUS), "Find Missing Class");
+    Function *plus = emojicodeFindFunction(program, TIGER, PLUS);
+    Function *collision = emojicodeFindFunction(program, TIGER, COLLISION);
+    Function *flag = emojicodeFindFunction(program, 0, FLAG);
+    check(plus && collision && flag, "Find Function");
+    check(!emojicodeFindFunction(program, TIGER, FLAG), "Find Missing Function");
+    if (!tiger || !plus || !collision || !flag) {
+        return 1;
+    }
+
+    char *arguments[] = {"host", argv[1]};
+    Instance *instance = emojicodeNewInstance(program, arguments, 2);
+    Something result;
+    check(emojicodeCall(instance, flag, NOTHINGNESS, NULL, &result) && result.raw == 1, "Call 🏁");
+    for (EmojicodeInteger i = 0; i < 1000; i++) {
+        Something values[2];
+        values[0] = somethingInteger(i);
+        values[1] = somethingInteger(-2 * i);
+        check(emojicodeCall(instance, plus, somethingClass(tiger), values, &result) && result.raw == -i, "Reuse");
+    }
+
+    check(!emojicodeCall(instance, collision, somethingClass(tiger), NULL, &result), "Error");
+    check(*emojicodeLastError(), "Error Message");
+    Something values[2];
+    values[0] = somethingInteger(1);
+    values[1] = somethingInteger(2);
+    check(!emojicodeCall(instance, plus, somethingClass(tiger), values, &result), "Call After Error");
+    emojicodeDestroyInstance(instance);
+
+    instance = emojicodeNewInstance(program, NULL, 0);
+    check(emojicodeCall(instance, plus, somethingClass(tiger), values, &result) && result.raw == 3,
+          "New Instance After Error");
+    emojicodeDestroyInstance(instance);
+
+    pthread_t threads[THREAD_COUNT];
+    for (intptr_t i = 0; i < THREAD_COUNT; i++) {
+        pthread_create(threads + i, NULL, callNumbers, (void *)i);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    if (failed) {
+        fprintf(stderr, "%d embedding tests failed.\n", failed);
+        return 1;
+    }
+    return 0;
+}